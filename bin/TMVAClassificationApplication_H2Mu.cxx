@@ -82,13 +82,10 @@ void TMVAClassificationApplication_H2Mu( TString myMethodList = "" )
    /////////////////////////////////////////////////////
    // Book training and spectator vars into reader
 
-   std::map<TString, Float_t> tmap;
-   std::map<TString, Float_t> smap;
-   TMVA::Reader* reader = TMVATools::bookVars(methodName, weightfile, tmap, smap);
-   
-   std::map<TString, Float_t> tmap_multi;
-   std::map<TString, Float_t> smap_multi;
-   TMVA::Reader* reader_multi = TMVATools::bookVars(methodName, weightfile_multi, tmap_multi, smap_multi);
+   // the selected events are collected and scored in batches
+   TMVAEvaluator evaluator(methodName, weightfile, s->vars);
+   TMVAEvaluator evaluator_multi(methodName, weightfile_multi, s->vars);
+   std::vector<int> batchEvents;
    
    std::vector<TString> classes; 
    TMVATools::getClassNames(weightfile_multi, classes);
@@ -110,6 +107,28 @@ void TMVAClassificationApplication_H2Mu( TString myMethodList = "" )
    // set some flags
    bool isData = s->sampleType.EqualTo("data");
 
+   // score the collected events and print the results
+   auto flushBatch = [&]()
+   {
+       evaluator.evaluateBatch();
+       evaluator_multi.evaluateBatch();
+       for(unsigned int row=0; row<batchEvents.size(); row++)
+       {
+           std::cout << std::endl;
+           printf("!!! %d) BDT_Prediction: %f\n", batchEvents[row], evaluator.getBatchScore(row));
+
+           const float* vals = evaluator_multi.getBatchScores(row);
+           for(unsigned int j=0; j<evaluator_multi.nscores && j<classes.size(); j++)
+           {
+               printf("!!! %d) %s: %f\n", batchEvents[row], classes[j].Data(), vals[j]);
+           }
+           std::cout << std::endl;
+       }
+       evaluator.clearBatch();
+       evaluator_multi.clearBatch();
+       batchEvents.clear();
+   };
+
    std::cout << Form("/// Processing %s \n", s->name.Data());
    s->setBranchAddresses(2);
    int ngood = 0;
@@ -175,23 +194,21 @@ void TMVAClassificationApplication_H2Mu( TString myMethodList = "" )
       CollectionCleaner::cleanByDR(s->vars.validElectrons, s->vars.validMuons, 0.4);
       //CollectionCleaner::cleanByDR(s->vars.validJets, s->vars.validElectrons, 0.4);
 
-      std::cout << std::endl;
-      Float_t valb = TMVATools::getClassifierScore(reader, methodName, tmap, s->vars);
-      printf("!!! %d) BDT_Prediction: %f\n", s->vars.eventInfo->event, valb);
+      // the inputs are copied into the batch, so the VarSet can move on to the next event
+      evaluator.addToBatch(s->vars);
+      evaluator_multi.addToBatch(s->vars);
+      batchEvents.push_back(s->vars.eventInfo->event);
 
-      std::vector<float> vals = TMVATools::getMulticlassScores(reader_multi, methodName, tmap_multi, s->vars);
-      for(unsigned int j=0; j<vals.size(); j++)
-      {
-          printf("!!! %d) %s: %f\n", s->vars.eventInfo->event, classes[j].Data(), vals[j]);
-      }
-      std::cout << std::endl;
+      if(evaluator.batchFull()) flushBatch();
     
       if(ngood > 10) break;
    }
+   if(batchEvents.size() > 0) flushBatch();
    sw.Stop();
    std::cout << "--- End of event loop: "; sw.Print();
 
-   delete reader;
+   evaluator.timing.output();
+   evaluator_multi.timing.output();
     
    std::cout << "==> TMVAClassificationApplication_H2Mu is done!" << std::endl << std::endl;
 }
@@ -533,9 +533,8 @@ void TMVAClassification_H2Mu ( TString myMethodList = "" ) {
        }
        prev_evt = this_evt;
 
-       if (samp->name == "RunF_1" && samp->vars.eventInfo->run > 278801)
-	 continue;
-       if (samp->name == "RunF_2" && samp->vars.eventInfo->run < 278802)
+       // Skip the duplicate data events and the ones outside the sample's runs, see EventVeto
+       if (samp->isVetoed(iEvt))
 	 continue;
 
        // Discard half of signal events for use in limit-setting
@@ -0,0 +1,175 @@
+/////////////////////////////////////////////////////////////////////////////
+//                        benchmarkXMLCategorizer.cxx                      //
+//=========================================================================//
+//                                                                         //
+// Time the XMLCategorizer on fake events: the old recursive walk over     //
+// the CategoryNodes, the flat node array one event at a time, and the     //
+// flat node array with the batch evaluate. Also checks that all three     //
+// put every event in the same categories.                                 //
+// ./benchmarkXMLCategorizer tree_categorization_final.xml [nevents] [nrepeat]
+//                                                                         //
+/////////////////////////////////////////////////////////////////////////////
+
+#include "CategorySelection.h"
+#include "VarSet.h"
+
+#include "TRandom3.h"
+#include "TStopwatch.h"
+
+#include <sstream>
+#include <vector>
+#include <iostream>
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+// an event with a dimuon candidate and a bdt score, enough for the autocategorizer trees
+struct FakeEvent
+{
+    std::vector<MuonInfo> muons;
+    std::vector<MuPairInfo> muPairs;
+    VarSet vars;
+
+    FakeEvent(TRandom3& random)
+    {
+        muons.resize(2);
+        muPairs.resize(1);
+        muons[0].eta = random.Uniform(-2.4, 2.4);
+        muons[1].eta = random.Uniform(-2.4, 2.4);
+        muPairs[0].iMu1 = 0;
+        muPairs[0].iMu2 = 1;
+        muPairs[0].eta = random.Uniform(-5, 5);
+        muPairs[0].mass = random.Uniform(110, 160);
+
+        vars.muons = &muons;
+        vars.muPairs = &muPairs;
+        vars.dimuCand = &muPairs[0];
+        vars.bdt_out = random.Uniform(-1, 1);
+    }
+};
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+// which categories the event is in, in categoryMap order
+std::vector<bool> getInCategory(Categorizer& categorizer)
+{
+    std::vector<bool> inCategory;
+    for(auto& c: categorizer.categoryMap)
+        inCategory.push_back(c.second.inCategory);
+    return inCategory;
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+    TString xmlfile = "tree_categorization_final.xml";
+    int nevents = 10000;   // each event has its own VarSet, keep this moderate
+    int nrepeat = 100;     // run over the events this many times
+
+    for(int i=1; i<argc; i++)
+    {
+        std::stringstream ss;
+        ss << argv[i];
+        if(i==1) xmlfile = TString(ss.str().c_str());
+        if(i==2) ss >> nevents;
+        if(i==3) ss >> nrepeat;
+    }
+
+    XMLCategorizer categorizer(xmlfile);
+    if(categorizer.nodes.size() < 2)
+    {
+        std::cout << Form("  !!! could not load a tree from %s \n", xmlfile.Data());
+        return 1;
+    }
+    std::cout << Form("  /// %s: %d nodes, %d categories \n", xmlfile.Data(), (int)categorizer.nodes.size(), (int)categorizer.categoryMap.size());
+
+    TRandom3 random(42);
+    std::vector<FakeEvent*> events;
+    std::vector<VarSet*> eventVars;
+    for(int i=0; i<nevents; i++)
+    {
+        events.push_back(new FakeEvent(random));
+        eventVars.push_back(&events.back()->vars);
+    }
+
+    ///////////////////////////////////////////////////////////////////
+    // check that the flat array agrees with the recursive walk -------
+    ///////////////////////////////////////////////////////////////////
+
+    std::vector<int> leaves(nevents);
+    categorizer.evaluate(&eventVars[0], nevents, &leaves[0]);
+
+    int nmismatch = 0;
+    for(int i=0; i<nevents; i++)
+    {
+        categorizer.reset();
+        categorizer.evaluateRecursive(*eventVars[i], categorizer.rootNode);
+        std::vector<bool> recursive = getInCategory(categorizer);
+
+        categorizer.reset();
+        categorizer.evaluate(*eventVars[i]);
+        std::vector<bool> flat = getInCategory(categorizer);
+
+        categorizer.reset();
+        categorizer.setInCategoryFromLeaf(leaves[i]);
+        std::vector<bool> batch = getInCategory(categorizer);
+
+        if(recursive != flat || recursive != batch) nmismatch++;
+    }
+    std::cout << Form("  /// %d/%d events in different categories \n", nmismatch, nevents);
+
+    ///////////////////////////////////////////////////////////////////
+    // timing ---------------------------------------------------------
+    ///////////////////////////////////////////////////////////////////
+
+    TStopwatch timer;
+    double ncalls = 1.0*nevents*nrepeat;
+
+    timer.Start();
+    for(int r=0; r<nrepeat; r++)
+    {
+        for(int i=0; i<nevents; i++)
+        {
+            categorizer.reset();
+            categorizer.evaluateRecursive(*eventVars[i], categorizer.rootNode);
+        }
+    }
+    timer.Stop();
+    double tRecursive = timer.RealTime();
+
+    timer.Start();
+    for(int r=0; r<nrepeat; r++)
+    {
+        for(int i=0; i<nevents; i++)
+        {
+            categorizer.reset();
+            categorizer.evaluate(*eventVars[i]);
+        }
+    }
+    timer.Stop();
+    double tFlat = timer.RealTime();
+
+    timer.Start();
+    for(int r=0; r<nrepeat; r++)
+        categorizer.evaluate(&eventVars[0], nevents, &leaves[0]);
+    timer.Stop();
+    double tBatch = timer.RealTime();
+
+    std::cout << std::endl;
+    std::cout << "======== XMLCategorizer Timing ========" << std::endl;
+    std::cout << Form("  recursive : %8.2f ns/event", 1e9*tRecursive/ncalls) << std::endl;
+    std::cout << Form("  flat      : %8.2f ns/event (x%.1f)", 1e9*tFlat/ncalls, tRecursive/tFlat) << std::endl;
+    std::cout << Form("  batch     : %8.2f ns/event (x%.1f), leaves only", 1e9*tBatch/ncalls, tRecursive/tBatch) << std::endl;
+    std::cout << std::endl;
+
+    for(auto& e: events)
+        delete e;
+
+    return (nmismatch == 0) ? 0 : 1;
+}
@@ -7,6 +7,7 @@
 // to make dimu_mass plots for limit setting or fitting.                   //
 // outputs mc stacks with data overlayed and a ratio plot underneath.      //
 // also saves the histos needed to make the stack: sig, bkg, data.         //
+// --var may list several variables, all are filled in one event loop.     //
 //                                                                         //
 /////////////////////////////////////////////////////////////////////////////
 
@@ -22,32 +23,55 @@
 #include "EventTools.h"
 #include "TMVATools.h"
 #include "PUTools.h"
+#include "SkimWriter.h"
+#include "JESVariation.h"
+#include "ColumnFile.h"
+#include "FastHist.h"
 
 #include "SignificanceMetrics.hxx"
 #include "SampleDatabase.cxx"
-#include "ThreadPool.hxx"
+#include "WorkStealingThreadPool.hxx"
 
 #include <sstream>
 #include <map>
 #include <vector>
 #include <utility>
+#include <mutex>
+#include <algorithm>
 
 #include "TLorentzVector.h"
 #include "TSystem.h"
 #include "TBranchElement.h"
 #include "TROOT.h"
+#include "TMD5.h"
 //#include "TStreamerInfo.h"
 
 //////////////////////////////////////////////////////////////////
 //---------------------------------------------------------------
 //////////////////////////////////////////////////////////////////
 
+// the name and binning of a variable to plot
+struct PlotVar
+{
+    TString varname;
+    float min;
+    float max;
+    int bins;
+    bool isMass;    // dimu_mass variables only fill events in the histogram range, and are blinded
+};
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
 struct Settings
 {
 // default settings here, may be overwritten by terminal input, see main() below
 
     int whichCategories = 1;              // run2categories = 1, run2categories = 2, "categories.xml" = 3 -> xmlcategories
     TString varname = "dimu_mass_Roch";   // the variable to plot, must match name in ../lib/VarSet
+                                          //  --var may be a list "mu1_pt,mu2_pt" or "all", 
+                                          //  every variable in the list is filled in the same event loop
     int binning = 0;                      // binning = 1 -> plot dimu_mass from 110 to 160
                                           //  negative numbers unblind the data for limit setting
                                           //  see initPlotSettings above for more information
@@ -68,8 +92,35 @@ struct Settings
     float max;
     int bins;
 
+    std::vector<PlotVar> plotvars;   // all of the variables to plot, plotvars[0] is varname
+
     float subleadPt = 20;     // subleading muon pt cut
     bool sig_xlumi = true;    // if true, scale signal by xsec*lumi
+
+    TString skim = "";            // "write" -> also save the selected events to a columnar skim in skimdir
+                                  // "read"  -> fill the histograms from the skim instead of the ttrees
+    TString skimdir = "skims";    // where to put the skims
+
+    bool oneLoop = true;            // process all of the systematics in one loop over the events instead of one loop each
+
+    Long64_t chunkSize = 1000000;   // split the samples into tasks of at most this many entries so that the
+                                    //  big samples run on many threads instead of making a long tail on one
+
+    Long64_t batchSize = 10000;     // apply the muon preselection to this many entries at a time before
+                                    //  loading the rest of the branches for the events that pass
+
+    bool cachePreselection = true;            // save the entries passing the preselection for each sample, calibration, and
+                                              //  subleadPt so that the next run, e.g. with other systematics, skips that step
+    TString preselectiondir = "preselections";  // where to put them
+
+    float cacheSize = 30;           // MB for the TTreeCache of each chunk, 0 turns it off
+    bool asyncPrefetch = false;     // read the next baskets in the background while we process these
+    bool parallelUnzip = false;     // unzip the cached baskets with ROOT's implicit MT, competes with nthreads for the cores
+    bool ioStats = true;            // print the bytes, read calls, unzip time, and cache hit rate for each sample
+
+    TString location = "UF";        // where GetSamples finds the ntuples: UF, CERN, CERN_hiM
+    TString mirrordir = "";         // keep local copies of remote ntuples here and reuse them next time, "" reads them remotely
+    float mirrorSize = 100;         // GB, the least recently used copies are removed to stay under this
 };
 
 //////////////////////////////////////////////////////////////////
@@ -293,7 +344,305 @@ void initPlotSettings(Settings& settings)
 //---------------------------------------------------------------
 //////////////////////////////////////////////////////////////////
 
-Categorizer* plotWithSystematic(TString systematic, Settings& settings)
+// get the name and binning for a variable to plot from initPlotSettings
+PlotVar getPlotVar(Settings settings, TString varname)
+{
+    settings.varname = varname;
+    initPlotSettings(settings);
+
+    PlotVar v;
+    v.varname = varname;
+    v.bins = settings.bins;
+    v.min = settings.min;
+    v.max = settings.max;
+    v.isMass = varname.Contains("dimu_mass");
+    return v;
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+// --var=dimu_mass_Roch or --var="mu1_pt,mu2_pt dimu_pt" or --var=all for every feature in the VarSet
+void initPlotVars(Settings& settings, TString value)
+{
+    std::vector<TString> varnames;
+    if(value == "all")
+    {
+        VarSet vars;
+        for(auto& v: vars.varMap)  varnames.push_back(v.first.c_str());
+        for(auto& v: vars.varMapI) varnames.push_back(v.first.c_str());
+        std::sort(varnames.begin(), varnames.end(), [](const TString& a, const TString& b){ return a.CompareTo(b) < 0; });
+    }
+    else
+    {
+        TString tok;
+        Ssiz_t from = 0;
+        while(value.Tokenize(tok, from, "[, ]")) 
+            varnames.push_back(tok);
+    }
+
+    settings.plotvars.clear();
+    for(auto& v: varnames)
+        settings.plotvars.push_back(getPlotVar(settings, v));
+
+    // settings.varname, min, max, bins refer to the first variable
+    if(varnames.size() > 0) settings.varname = varnames[0];
+    initPlotSettings(settings);
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+// create the categorizer for settings.whichCategories
+Categorizer* getCategorizer(const Settings& settings)
+{
+    Categorizer* categorySelection = 0;
+
+    if(settings.whichCategories == 1) categorySelection = new CategorySelectionRun1();                  // run1 categories
+    else if(settings.whichCategories == 2) categorySelection = new CategorySelectionBDT();              // run2 categories
+    else if(settings.whichCategories == 3 && settings.xmlfile.Contains("hybrid")) 
+        categorySelection = new CategorySelectionHybrid(settings.xmlfile);                              // XML + object cuts
+    else if(settings.whichCategories == 3) categorySelection = new XMLCategorizer(settings.xmlfile);    // XML only
+
+    return categorySelection;
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+// the branches the selection, cleaning, categories, classifier, and plotted variables need,
+// the rest of the branches are never read
+BranchSet::Mask getBranchMask(const Settings& settings, TString weightfile)
+{
+    // the skim saves every feature
+    if(settings.skim == "write") return BranchSet::kAllBranches;
+
+    VarSet vars;
+    BranchSet::Mask mask = BranchSet::kSelectionBranches | BranchSet::kCleaningBranches | BranchSet::kWeightBranches |
+                           BranchSet::bit(BranchSet::kLheHt);
+
+    for(auto& v: settings.plotvars)
+        mask |= vars.getBranchMask(v.varname.Data());
+
+    Categorizer* categorySelection = getCategorizer(settings);
+    if(categorySelection != 0) mask |= categorySelection->getBranchMask(vars);
+    delete categorySelection;
+
+    if(settings.whichCategories >= 2) mask |= TMVATools::getBranchMask(weightfile, vars);
+
+    return mask;
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+// use pf, roch, or kamu values for selections, categories, and fill?
+TString getCalibrationType(TString varname)
+{
+    TString pf_roch_or_kamu = "PF";
+    if(varname.Contains("PF")) pf_roch_or_kamu = "PF";
+    else if(varname.Contains("Roch")) pf_roch_or_kamu = "Roch";
+    else if(varname.Contains("KaMu")) pf_roch_or_kamu = "KaMu";
+    return pf_roch_or_kamu;
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+// the histograms to fill for one systematic
+struct SystematicFill
+{
+    int isyst;                             // index into the systematics
+    int weightId = Sample::kWeightNominal; // PU_up/PU_down fill with the alternate PU weight, see Sample::getWeightId
+    SkimWriter* skimWriter = 0;            // saves the selected events if settings.skim == "write"
+
+    // the histos to fill for each variable in the group, one entry per category
+    std::vector< std::pair<Category*, std::vector<FastHist*> > > fills;
+};
+
+// the systematics that see the same jets share the cleaning and categorization
+struct JetVariationFills
+{
+    JESVariation* jes = 0;                 // 0 for the nominal jets
+    std::vector<SystematicFill> systematics;
+};
+
+// Variables that use the same calibration share the selection, cleaning, and categorization.
+// Usually everything is PF except for dimu_mass_Roch and dimu_mass_KaMu.
+struct CalibrationGroup
+{
+    TString calibration;                   // PF, Roch, or KaMu
+    std::vector<int> ivars;                // indices into settings.plotvars
+
+    Categorizer* categorySelection = 0;    // evaluates the categories for this calibration
+    DimuonBatch batch;                     // the preselection for this calibration, one row per dimuon candidate
+
+    // the nominal jets first, then one entry per JES variation
+    std::vector<JetVariationFills> jetVariations;
+};
+
+std::vector<CalibrationGroup> getCalibrationGroups(const Settings& settings)
+{
+    std::vector<CalibrationGroup> groups;
+    for(unsigned int v=0; v<settings.plotvars.size(); v++)
+    {
+        TString calibration = getCalibrationType(settings.plotvars[v].varname);
+        unsigned int g = 0;
+        for(g=0; g<groups.size(); g++)
+            if(groups[g].calibration == calibration) break;
+
+        if(g == groups.size())
+        {
+            groups.push_back(CalibrationGroup());
+            groups[g].calibration = calibration;
+            groups[g].batch.calibration = calibration;
+        }
+        groups[g].ivars.push_back(v);
+    }
+    return groups;
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+// the skim depends on the categorizer, calibration, and selection but not on the variable to plot
+// there is one skim file per chunk of the sample
+TString getSkimFilename(const Settings& settings, TString sampleName, TString calibration, TString systematic, int chunk)
+{
+    TString categoryString = Form("%d", settings.whichCategories);
+    if(settings.whichCategories == 3)
+    {
+        Ssiz_t i = settings.xmlfile.Last('/');
+        TString xmlname = settings.xmlfile(i+1, settings.xmlfile.Length());
+        categoryString += "_"+xmlname.ReplaceAll(".xml", "");
+    }
+    return SkimWriter::getFilename(settings.skimdir, sampleName, calibration, categoryString,
+                                   (int)settings.subleadPt, systematic, chunk);
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+// the md5 of the location and the path, size, and modification time of each ntuple the sample reads, plus the
+// veto of a data sample since getBatch leaves out the vetoed events. Remade ntuples get new preselection lists
+TString getPreselectionKey(const Settings& settings, Sample* s)
+{
+    TString id = settings.location+"\n";
+    for(auto& f: s->filenames)
+    {
+        Long_t fid, flags, mtime = -1;
+        Long64_t size = -1;
+        gSystem->GetPathInfo(f, &fid, &size, &flags, &mtime);
+        id += Form("%s %lld %ld\n", f.Data(), size, mtime);
+    }
+    if(s->veto != 0) id += "veto "+s->vetoKey+"\n";
+
+    TMD5 md5;
+    md5.Update((const UChar_t*) id.Data(), id.Length());
+    md5.Final();
+    return md5.AsString();
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+// the preselection depends on the sample, calibration, and subleadPt cut, not on the categories or systematics.
+// one file per chunk of the sample, named by its entry range and the key of its ntuples
+TString getPreselectionFilename(const Settings& settings, TString sampleName, TString key, TString calibration, Long64_t first, Long64_t last)
+{
+    return Form("%s/%s_%s_subleadPt%d_%s_%lld_%lld.root", settings.preselectiondir.Data(), sampleName.Data(), calibration.Data(),
+                (int)settings.subleadPt, key.Data(), first, last);
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+// The histograms one task fills for its sample, one per systematic, variable, and shown category.
+// They belong to the worker thread until it returns them, the chunks of a sample are added
+// in task order and only turned into TH1Ds at the end, see plotWithSystematics.
+struct HistoShard
+{
+    TString sample;
+    TString sampleType;                    // data, signal, or background
+    std::vector<TString> categories;       // the category names, categoryMap order without the hidden ones
+    std::vector<bool> booked;              // one per systematic, data only has the nominal
+    unsigned int nvars = 0;
+    bool complete = true;                  // false if part of the input couldn't be read
+
+    // histogram (isyst, ivar, icat) is at [(isyst*nvars + ivar)*categories.size() + icat]
+    std::vector<FastHist> histos;
+
+    FastHist* get(unsigned int isyst, unsigned int ivar, unsigned int icat)
+    {
+        return &histos[(isyst*nvars + ivar)*categories.size() + icat];
+    }
+
+    // same binning for every chunk of the sample
+    void add(const HistoShard& other)
+    {
+        complete = complete && other.complete;
+        for(unsigned int h=0; h<histos.size(); h++)
+            histos[h].add(other.histos[h]);
+    }
+};
+
+// set up the histograms for each category and variable for the sample
+HistoShard bookHistos(Categorizer* categorySelection, Sample* s, const std::vector<TString>& systematics, const Settings& settings)
+{
+    bool isData = s->sampleType.EqualTo("data");
+
+    HistoShard shard;
+    shard.sample = s->name;
+    shard.sampleType = s->sampleType;
+    shard.nvars = settings.plotvars.size();
+    for(auto& c: categorySelection->categoryMap)
+        if(!c.second.hide) shard.categories.push_back(c.first);
+
+    for(auto& systematic: systematics)
+    {
+        shard.booked.push_back(!isData || systematic == "");
+        for(auto& var: settings.plotvars)
+            for(unsigned int c=0; c<shard.categories.size(); c++)
+                shard.histos.push_back(FastHist(var.bins, var.min, var.max));
+    }
+    return shard;
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+// Scale according to settings.luminosity and sample xsec now that the histograms are done being filled for the sample
+void scaleHistos(HistoShard& shard, Sample* s, const Settings& settings)
+{
+    bool isSignal = s->sampleType.EqualTo("signal");
+
+    // Only used half of the signal events in this case, need to boost the normalization by 2 to make up for that
+    double scale = s->getLumiScaleFactor(settings.luminosity);
+    if(settings.whichCategories >= 2 && isSignal && settings.binning < 0) scale *= 2;
+
+    for(auto& h: shard.histos)
+        h.scale(scale);
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+// returns one Categorizer full of histograms for each variable in settings.plotvars, for each systematic.
+// with several systematics the MC is read once: the muon selection is shared, the JES variations
+// redo the jet cleaning and categorization, and the PU variations fill with the alternate PU weights.
+// empty if some of the input couldn't be read, e.g. a missing skim chunk.
+std::map<TString, std::vector<Categorizer*> > plotWithSystematics(std::vector<TString> systematics, Settings& settings)
 {
     gROOT->SetBatch();
 
@@ -310,13 +659,21 @@ Categorizer* plotWithSystematic(TString systematic, Settings& settings)
     // Use this to plot some things if we wish
     DiMuPlottingSystem* dps = new DiMuPlottingSystem();
 
+    // one systematic -> the reader links the branches for it directly, like we always did
+    // several         -> the reader links the nominal and the variation branches together
+    bool oneLoop = systematics.size() > 1;
+
     ///////////////////////////////////////////////////////////////////
     // SAMPLES---------------------------------------------------------
     ///////////////////////////////////////////////////////////////////
 
-    GetSamples(samples, "UF", "ALL_"+settings.whichDY);
-    GetSamples(samples, "UF", "SIGNAL120");
-    GetSamples(samples, "UF", "SIGNAL130");
+    // the skim has everything we need, don't bother opening the ttrees
+    bool readSkim = settings.skim == "read";
+    bool writeSkim = settings.skim == "write";
+
+    GetSamples(samples, settings.location, "ALL_"+settings.whichDY, readSkim);
+    GetSamples(samples, settings.location, "SIGNAL120", readSkim);
+    GetSamples(samples, settings.location, "SIGNAL130", readSkim);
 
     ///////////////////////////////////////////////////////////////////
     // PREPROCESSING: SetBranchAddresses-------------------------------
@@ -331,7 +688,15 @@ Categorizer* plotWithSystematic(TString systematic, Settings& settings)
     
     for(auto &i : samples)
     {
-        if(i.second->sampleType == "data" && systematic!="") continue;
+        // data only has the nominal
+        if(i.second->sampleType == "data" && std::find(systematics.begin(), systematics.end(), "") == systematics.end()) continue;
+        if(readSkim)
+        {
+            std::cout << "  /// Using sample " << i.second->name << " from the skims in " << settings.skimdir << std::endl;
+            samplevec.push_back(i.second);
+            continue;
+        }
+
         // Output some info about the current file
         std::cout << "  /// Using sample " << i.second->name << std::endl;
         std::cout << std::endl;
@@ -343,7 +708,7 @@ Categorizer* plotWithSystematic(TString systematic, Settings& settings)
         std::cout << "    nOriginalWeighted: " << i.second->nOriginalWeighted << std::endl;
         std::cout << std::endl;
 
-        i.second->setBranchAddresses(systematic);          // tell the ttree to load the variable values into sample->vars
+        // each chunk makes its own reader with the branch addresses for the systematics, see makeReader
         samplevec.push_back(i.second);                              // add the sample to the vector of samples which we will run over
     }
 
@@ -354,9 +719,6 @@ Categorizer* plotWithSystematic(TString systematic, Settings& settings)
     // Get Histo Information from Input -------------------------------
     ///////////////////////////////////////////////////////////////////
 
-    // set nbins, min, max, and var to plot based upon input from the terminal: varNumber and settings.binning
-    initPlotSettings(settings);
-
     std::cout << "@@@ nCPUs Available: " << getNumCPUs() << std::endl;
     std::cout << "@@@ nCPUs used     : " << settings.nthreads << std::endl;
     std::cout << "@@@ nSamples used  : " << samplevec.size() << std::endl;
@@ -368,16 +730,24 @@ Categorizer* plotWithSystematic(TString systematic, Settings& settings)
     std::cout << std::endl;
     std::cout << "======== Plot Configs ========" << std::endl;
     std::cout << "categories     : " << categoryString << std::endl;
-    std::cout << "systematic     : " << systematic << std::endl;
-    std::cout << "var            : " << settings.varname << std::endl;
-    std::cout << "min            : " << settings.min << std::endl;
-    std::cout << "max            : " << settings.max << std::endl;
-    std::cout << "bins           : " << settings.bins << std::endl;
+    for(auto& systematic: systematics)
+        std::cout << "systematic     : " << systematic << std::endl;
+    for(auto& v: settings.plotvars)
+        std::cout << "var            : " << v.varname << ", " << v.bins << " bins, " << v.min << " to " << v.max << std::endl;
     std::cout << "binning        : " << settings.binning << std::endl;
     std::cout << "sig xlumi      : " << settings.sig_xlumi << std::endl;
     std::cout << "reductionFactor: " << settings.reductionFactor << std::endl;
     std::cout << "whichDY        : " << settings.whichDY << std::endl;
     std::cout << "subleadPt      : " << settings.subleadPt << std::endl;
+    std::cout << "skim           : " << settings.skim << std::endl;
+    std::cout << "chunkSize      : " << settings.chunkSize << std::endl;
+    std::cout << "batchSize      : " << settings.batchSize << std::endl;
+    std::cout << "preselection   : " << (settings.cachePreselection?settings.preselectiondir:TString("not saved")) << std::endl;
+    std::cout << "cacheSize      : " << settings.cacheSize << " MB" << std::endl;
+    std::cout << "asyncPrefetch  : " << settings.asyncPrefetch << std::endl;
+    std::cout << "parallelUnzip  : " << settings.parallelUnzip << std::endl;
+    std::cout << "location       : " << settings.location << std::endl;
+    std::cout << "mirror         : " << (settings.mirrordir!=""?settings.mirrordir:TString("off")) << std::endl;
     std::cout << "rebin ratio    : " << settings.rebin << std::endl;
     std::cout << "fit ratio      : " << settings.fitratio << std::endl;
     std::cout << std::endl;
@@ -386,58 +756,63 @@ Categorizer* plotWithSystematic(TString systematic, Settings& settings)
     // Define Task for Parallelization -------------------------------
     ///////////////////////////////////////////////////////////////////
 
-    auto makeHistoForSample = [settings, systematic](Sample* s)
+    // process entries [first, last) of the sample, s is a reader made for this chunk alone
+    // returns the categorizers for [systematic][variable], empty for the systematics that don't apply to the sample
+    /////////////////////////////////////////////////////
+    // TMVA classifiers
+     
+    TString dir    = "classification/";
+    //TString methodName = "BDTG_default";
+    TString methodName = "BDTG_UF_v1";
+
+    // sig vs bkg and multiclass (ggf, vbf, ... drell yan, ttbar) weight files
+    TString weightfile = dir+"f_Opt_v1_all_sig_all_bkg_ge0j_BDTG_UF_v1.weights.xml";
+    //TString weightfile = dir+"binaryclass_amc.weights.xml";
+    TString weightfile_multi = dir+"f_Opt_v1_multi_all_sig_all_bkg_ge0j_BDTG_UF_v1.weights.xml";
+
+    // only read the branches this job needs, keep track of the bytes read from each
+    BranchSet::Mask activeBranches = getBranchMask(settings, weightfile);
+    BranchSet bytesRead;
+    TMVATiming tmvaTiming;     // events/s in the classifier over all of the chunks
+    std::map<TString, IOStats> ioStats;   // bytes, read calls, unzip time, and cache hits for each sample
+    std::mutex statsMutex;
+    std::map<TString, TString> preselectionKeys;   // filled before the tasks start, see getPreselectionKey
+
+    auto makeHistoForSample = [settings, systematics, oneLoop, writeSkim, methodName, weightfile, &bytesRead, &tmvaTiming, &ioStats, &statsMutex,
+                               &preselectionKeys]
+                              (Sample* s, Long64_t first, Long64_t last, int ichunk, int nchunks)
     {
-
-      // info to check that this event is different than the last event
-      long long int last_run = -999;
-      long long int last_event = -999;
-
-      long long int this_run = -999;
-      long long int this_event = -999;
-
       bool isblinded = true;              // negative settings.binning: unblind data in 120-130 GeV 
       if(settings.binning < 0) isblinded = false;
 
       // Output some info about the current file
-      std::cout << Form("  /// Processing %s \n", s->name.Data());
-      if(!s->vars.checkForVar(settings.varname.Data()))
+      std::cout << Form("  /// Processing %s chunk %d/%d, entries %lld to %lld \n", s->name.Data(), ichunk+1, nchunks, first, last);
+      for(auto& v: settings.plotvars)
       {
-          std::cout << Form("  !!! %s is not a valid variable %s \n", settings.varname.Data(), s->name.Data());
+          if(!s->vars.checkForVar(v.varname.Data()))
+              std::cout << Form("  !!! %s is not a valid variable %s \n", v.varname.Data(), s->name.Data());
       }
 
 
-      /////////////////////////////////////////////////////
-      // Load TMVA classifiers
-     
-      TString dir    = "classification/";
-      //TString methodName = "BDTG_default";
-      TString methodName = "BDTG_UF_v1";
-
-
-      // sig vs bkg and multiclass (ggf, vbf, ... drell yan, ttbar) weight files
-      TString weightfile = dir+"f_Opt_v1_all_sig_all_bkg_ge0j_BDTG_UF_v1.weights.xml";
-      //TString weightfile = dir+"binaryclass_amc.weights.xml";
-      TString weightfile_multi = dir+"f_Opt_v1_multi_all_sig_all_bkg_ge0j_BDTG_UF_v1.weights.xml";
-
       /////////////////////////////////////////////////////
       // Book training and spectator vars into reader
 
-      TMVA::Reader* reader = 0;
-      std::map<TString, Float_t> tmap;
-      std::map<TString, Float_t> smap;
-
-      //TMVA::Reader* reader_multi = 0;
-      //std::map<TString, Float_t> tmap_multi;
-      //std::map<TString, Float_t> smap_multi;
+      // the evaluator binds the training vars to a flat array and resolves their features once
+      TMVAEvaluator* evaluator = 0;
+      //TMVAEvaluator* evaluator_multi = 0;
 
       // load tmva binary classification and multiclass classifiers
       if(settings.whichCategories >= 2)
       {
-          reader       = TMVATools::bookVars(methodName, weightfile, tmap, smap);
-          //reader_multi = TMVATools::bookVars(methodName, weightfile_multi, tmap_multi, smap_multi);
+          evaluator       = new TMVAEvaluator(methodName, weightfile, s->vars);
+          //evaluator_multi = new TMVAEvaluator(methodName, weightfile_multi, s->vars);
       }
 
+      // look up the functions for the variables to plot once, not every event
+      std::vector<FeatureHandle> plotFeatures;
+      for(auto& v: settings.plotvars)
+          plotFeatures.push_back(s->vars.getFeature(v.varname.Data()));
+
       ///////////////////////////////////////////////////////////////////
       // INIT Cuts and Categories ---------------------------------------
       ///////////////////////////////////////////////////////////////////
@@ -451,164 +826,258 @@ Categorizer* plotWithSystematic(TString systematic, Settings& settings)
       Run2EventSelectionCuts run2EventSelection;
       run2MuonSelection.cMinPt = settings.subleadPt; 
 
-      Categorizer* categorySelection = 0;
-
-      if(settings.whichCategories == 1) categorySelection = new CategorySelectionRun1();                  // run1 categories
-      else if(settings.whichCategories == 2) categorySelection = new CategorySelectionBDT();              // run2 categories
-      else if(settings.whichCategories == 3 && settings.xmlfile.Contains("hybrid")) 
-          categorySelection = new CategorySelectionHybrid(settings.xmlfile);                              // XML + object cuts
-      else if(settings.whichCategories == 3) categorySelection = new XMLCategorizer(settings.xmlfile);    // XML only
-
       // set some flags
       bool isData = s->sampleType.EqualTo("data");
       bool isSignal = s->sampleType.EqualTo("signal");
-      bool isMass = settings.varname.Contains("dimu_mass");
-      bool isBDTscore = settings.varname.Contains("bdt_score");
-
-      // use pf, roch, or kamu values for selections, categories, and fill?
-      TString pf_roch_or_kamu = "PF";
-      if(settings.varname.Contains("PF")) pf_roch_or_kamu = "PF";
-      else if(settings.varname.Contains("Roch")) pf_roch_or_kamu = "Roch";
-      else if(settings.varname.Contains("KaMu")) pf_roch_or_kamu = "KaMu";
 
       ///////////////////////////////////////////////////////////////////
       // INIT HISTOGRAMS TO FILL ----------------------------------------
       ///////////////////////////////////////////////////////////////////
 
-      // Keep track of which histogram to fill in the category
-      TString hkey = s->name;
+      // the variables using the same pf, roch, or kamu calibration share the selection and categories
+      std::vector<CalibrationGroup> groups = getCalibrationGroups(settings);
+      for(auto& g: groups)
+          g.categorySelection = getCategorizer(settings);
+
+      // this thread's histograms for every systematic and variable, no ROOT objects until the merge
+      HistoShard shard = bookHistos(groups[0].categorySelection, s, systematics, settings);
 
-      // Different categories for the analysis
-      // categorySelection has a categoryMap<TString, CategorizerObject>
-      for(auto &c : categorySelection->categoryMap)
+      for(auto& g: groups)
       {
-          // c.second is the category object, c.first is the category name
-          TString hname = c.second.name+"_"+s->name;
-          if(systematic != "" && !isData) hname+="_"+systematic;
-
-          // Set up the histogram for the category and variable to plot
-          // Each category has a map and some lists to keep track of different histograms
-          c.second.histoMap[hkey] = new TH1D(hname, hname, settings.bins, settings.min, settings.max);
-          c.second.histoMap[hkey]->GetXaxis()->SetTitle(settings.varname);
-          c.second.histoList->Add(c.second.histoMap[hkey]);                                      // need them ordered by xsec for the stack and ratio plot
-          if(s->sampleType.EqualTo("data")) c.second.dataList->Add(c.second.histoMap[hkey]);     // data histo
-          if(s->sampleType.EqualTo("signal")) c.second.signalList->Add(c.second.histoMap[hkey]); // signal histos
-          if(s->sampleType.EqualTo("background")) c.second.bkgList->Add(c.second.histoMap[hkey]);// bkg histos
 
+          // the systematics that see the same jets share the cleaning and categorization
+          g.jetVariations.push_back(JetVariationFills());  // the nominal jets
+          for(auto& jes: s->jesVariations)
+          {
+              g.jetVariations.push_back(JetVariationFills());
+              g.jetVariations.back().jes = jes;
+          }
+
+          for(unsigned int k=0; k<systematics.size(); k++)
+          {
+              if(!shard.booked[k]) continue;
+
+              SystematicFill sf;
+              sf.isyst = k;
+              if(oneLoop && systematics[k].Contains("PU_")) sf.weightId = Sample::getWeightId(systematics[k]);
+
+              // the categories we decided to hide (usually some intermediate categories) have no histograms
+              for(unsigned int icat=0; icat<shard.categories.size(); icat++)
+              {
+                  std::vector<FastHist*> histos;
+                  for(auto& v: g.ivars)
+                      histos.push_back(shard.get(k, v, icat));
+                  sf.fills.push_back(std::pair<Category*, std::vector<FastHist*> >(&g.categorySelection->categoryMap[shard.categories[icat]], histos));
+              }
+
+              // save every selected event to the skim so that we don't have to run over the ttrees again
+              if(writeSkim) 
+              {
+                  sf.skimWriter = new SkimWriter(getSkimFilename(settings, s->name, g.calibration, systematics[k], ichunk), s, g.categorySelection);
+                  sf.skimWriter->writer.setMetadata("nchunks", Form("%d", nchunks));
+              }
+
+              // which jets does this systematic use
+              unsigned int j = 0;
+              for(j=1; oneLoop && j<g.jetVariations.size(); j++)
+                  if(g.jetVariations[j].jes->name == systematics[k]) break;
+              if(!oneLoop || j == g.jetVariations.size()) j = 0;
+              g.jetVariations[j].systematics.push_back(sf);
+          }
       }
 
+      std::vector<double> varvalues(settings.plotvars.size());
+
+      // We are stitching together zjets_ht from 70-inf. We use the inclusive for
+      // ht from 0-70, using the inclusive for 70 and beyond would double count.
+      float maxLheHt = (s->name == "ZJets_MG") ? 70 : -1;
+
+      // the data samples only keep their runs from samples.catalog. With the event index stage 1 only reads
+      // the entries from those runs, the batches still check the run in case there is no index.
+      // getBatch leaves out the duplicate events, see EventVeto
+      long long minRun = s->minRun;
+      long long maxRun = s->maxRun;
+      std::vector< std::pair<Long64_t, Long64_t> > runRanges = s->getRunRanges(minRun, maxRun, first, last);
+
+      // normal selections, these don't look at the jets so they are the same for every systematic.
+      // applied to all of the dimuon candidates in a batch at once
+      auto preselect = [&](DimuonBatch& batch)
+      {
+          run2EventSelection.evaluate(batch);
+          batch.applyMediumID();
+          run2MuonSelection.evaluate(batch);
+          batch.applyRunRange(minRun, maxRun);
+      };
 
       ///////////////////////////////////////////////////////////////////
-      // LOOP OVER EVENTS -----------------------------------------------
+      // STAGE 1: PRESELECTION ------------------------------------------
+      ///////////////////////////////////////////////////////////////////
+
+      // the entries with a dimuon candidate passing the preselection, one list per calibration.
+      // use the lists saved by an earlier run if we can, otherwise run the cuts over the muon branches
+      // a veto that couldn't be saved has no key to name the data lists by, so those aren't cached
+      bool cachePreselection = settings.cachePreselection && (s->veto == 0 || s->vetoKey != "");
+      TString listKey = cachePreselection?preselectionKeys.at(s->name):"";
+      std::vector< std::vector<Long64_t> > preselected(groups.size());
+      std::vector<DimuonBatch*> stage1Batches;
+      std::vector<unsigned int> stage1Groups;
+      for(unsigned int g=0; g<groups.size(); g++)
+      {
+          TString listfile = getPreselectionFilename(settings, s->name, listKey, groups[g].calibration, first, last);
+          if(cachePreselection && Sample::loadEntryList(listfile, preselected[g])) continue;
+          stage1Batches.push_back(&groups[g].batch);
+          stage1Groups.push_back(g);
+      }
+
+      // stage 1 only reads the muons
+      if(!stage1Groups.empty()) s->setCache(BranchSet::kSelectionBranches | BranchSet::bit(BranchSet::kLheHt), first, last);
+
+      for(auto& range: runRanges)
+      {
+          for(Long64_t batchFirst=range.first; !stage1Groups.empty() && batchFirst<range.second; batchFirst+=settings.batchSize)
+          {
+              s->getBatch(stage1Batches, batchFirst, std::min(range.second, batchFirst + settings.batchSize), maxLheHt);
+              for(auto& g: stage1Groups)
+              {
+                  preselect(groups[g].batch);
+                  groups[g].batch.getSurvivors(preselected[g]);
+              }
+          }
+      }
+
+      if(cachePreselection)
+      {
+          for(auto& g: stage1Groups)
+              Sample::saveEntryList(preselected[g], getPreselectionFilename(settings, s->name, listKey, groups[g].calibration, first, last));
+      }
+
+      // stage 2 goes over the entries that pass for at least one calibration, in order
+      std::vector<Long64_t> entries;
+      for(auto& p: preselected)
+          entries.insert(entries.end(), p.begin(), p.end());
+      std::sort(entries.begin(), entries.end());
+      entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+      // stage 2 reads the muons once for the batches and then everything else for the selected entries
+      s->setCache(s->branches.active, first, last);
+
+      ///////////////////////////////////////////////////////////////////
+      // STAGE 2: LOOP OVER THE SELECTED EVENTS -------------------------
       ///////////////////////////////////////////////////////////////////
 
       // Sift the events into the different categories and fill the histograms for each sample x category
-      for(unsigned int i=0; i<s->N/settings.reductionFactor; i++)
+      for(unsigned int n=0; n<entries.size(); n++)
       {
-        // We are stitching together zjets_ht from 70-inf. We use the inclusive for
-        // ht from 0-70, using the inclusive for 70 and beyond would double count.
-        if(!isData)
-        {
-            s->branches.lhe_ht->GetEntry(i);
-            if(s->name == "ZJets_MG" && s->vars.lhe_ht >= 70) continue;
-        }
+        Long64_t i = entries[n];
 
-        // only load essential information for the first set of cuts 
-        s->branches.muPairs->GetEntry(i);
-        s->branches.muons->GetEntry(i);
-        s->branches.eventInfo->GetEntry(i);
+        // load the muons, the batches below use them to pick the candidates that pass for each calibration
+        s->branches.getEntry(BranchSet::kMuPairs, i);
+        s->branches.getEntry(BranchSet::kMuons, i);
+        s->branches.getEntry(BranchSet::kEventInfo, i);
 
         // loop and find a good dimuon candidate
         if(s->vars.muPairs->size() < 1) continue;
+
+        // the batches only hold this event here, stage 1 already left out the vetoed and lhe_ht events
+        for(auto& g: groups)
+        {
+            g.batch.clear();
+            g.batch.add(s->vars, i);
+            preselect(g.batch);
+        }
+
+        // only load the rest of the branches once, even if several calibrations select the event
+        bool loaded_all_branches = false;
+
+        for(auto& g: groups)
+        {
         bool found_good_dimuon = false;
 
         // find the first good dimuon candidate and fill info
         for(auto& dimu: (*s->vars.muPairs))
         {
-          // Reset the categorizer in preparation for the next event
-          categorySelection->reset();
-
-          // the dimuon candidate and the muons that make up the pair
+          // the dimuon candidate
           s->vars.dimuCand = &dimu; 
-          MuonInfo& mu1 = s->vars.muons->at(s->vars.dimuCand->iMu1);
-          MuonInfo& mu2 = s->vars.muons->at(s->vars.dimuCand->iMu2);
 
           // Selection cuts and categories use standard values e.g. mu.pt
           // to use PF, Roch, or KaMu for cuts and categories set these values 
           // to PF, Roch, or KaMu 
-          s->vars.setCalibrationType(pf_roch_or_kamu);
+          s->vars.setCalibrationType(g.calibration);
 
           ///////////////////////////////////////////////////////////////////
           // CUTS  ----------------------------------------------------------
           ///////////////////////////////////////////////////////////////////
 
+          // the histograms use the first selected candidate that passes the plotting cuts. The skim saves every
+          // selected candidate so that reading it back can pick the same one for any binning
+          bool passesPlotCuts = true;
+
           // only use even signal events for limit setting 
           // as to separate training and evaluation events
           if(isSignal && settings.whichCategories==3 && settings.binning<0 && (s->vars.eventInfo->event % 2 == 1))
           {
-              continue;
+              passesPlotCuts = false;
           }
 
           // binning == 1 -> only plot events in the fit window for all variables
           if(TMath::Abs(settings.binning) == 1 && (dimu.mass < 110 || dimu.mass > 160))
           {
-              continue;
+              passesPlotCuts = false;
           }
 
           // only consider events w/ dimu_mass in the histogram range,
           // so the executable doesn't take forever, especially w/ tmva evaluation.
-          if(isMass && (dimu.mass < settings.min || dimu.mass > settings.max))
+          // with several variables at least one of them needs to be in range.
+          bool inRange = false;
+          for(auto& v: g.ivars)
           {
-              continue;
-          }
-
-          // normal selections
-          if(!run2EventSelection.evaluate(s->vars))
-          { 
-              continue; 
-          }
-          if(!mu1.isMediumID || !mu2.isMediumID)
-          { 
-              continue; 
+              const PlotVar& var = settings.plotvars[v];
+              if(!var.isMass || (dimu.mass >= var.min && dimu.mass <= var.max)) inRange = true;
           }
-          if(!run2MuonSelection.evaluate(s->vars)) 
+          if(!inRange)
           {
-              continue; 
+              passesPlotCuts = false;
           }
 
-          // avoid double counting in RunF
-          if(s->name == "RunF_1" && s->vars.eventInfo->run > 278801)
-          {
-              continue;
-          }
-          if(s->name == "RunF_2" && s->vars.eventInfo->run < 278802)
+          if(!passesPlotCuts && !writeSkim) continue;
+
+          // the event, muon, medium id, and run selections from the batch above
+          if(!g.batch.pass[&dimu - &s->vars.muPairs->at(0)])
           {
               continue;
           }
 
-          // Check that this event is different than the last event --------
-          this_run = s->vars.eventInfo->run;
-          this_event = s->vars.eventInfo->event;
-
-
-          if(this_run == last_run && this_event == last_event)
-              std::cout << Form("  !!! last run & event ==  this run & event: %d, %d, %d, %d, %s \n", last_run, last_event, this_run, this_event, s->name.Data());
-
-          last_run = this_run;
-          last_event = this_event;
-          // ----------------------------------------------------------------
-
           // dimuon event passes selections, set flag to true so that we only fill info for
           // the first good dimu candidate
-          found_good_dimuon = true; 
+          bool fillHistos = passesPlotCuts && !found_good_dimuon;
+          if(fillHistos) found_good_dimuon = true; 
 
           ///////////////////////////////////////////////////////////////////
-          // LOAD ALL BRANCHES, CLEAN COLLECTIONS ---------------------------
+          // LOAD ALL BRANCHES ----------------------------------------------
           ///////////////////////////////////////////////////////////////////
 
           // Load the rest of the information needed for run2 categories
-          s->branches.getEntry(i);
-          s->vars.setCalibrationType(pf_roch_or_kamu); // reloaded the branches, need to set mass,pt to correct calibrations again
+          if(!loaded_all_branches)
+          {
+              s->branches.getEntry(i);
+              s->getEntrySystematics(i);
+              loaded_all_branches = true;
+          }
+          s->vars.setCalibrationType(g.calibration); // reloaded the branches, need to set mass,pt to correct calibrations again
+
+          for(auto& jv: g.jetVariations)
+          {
+          if(jv.systematics.size() == 0) continue;
+
+          // point the VarSet at the JES shifted jets, swap back below
+          if(jv.jes != 0) jv.jes->swap(s->vars);
+
+          // Reset the categorizer in preparation for this set of jets
+          g.categorySelection->reset();
+
+          ///////////////////////////////////////////////////////////////////
+          // CLEAN COLLECTIONS ----------------------------------------------
+          ///////////////////////////////////////////////////////////////////
 
           // clear vectors for the valid collections
           s->vars.validMuons.clear();
@@ -640,10 +1109,10 @@ Categorizer* plotWithSystematic(TString systematic, Settings& settings)
 
               //std::cout << i << " !!! SETTING JETS " << std::endl;
               //s->vars.setJets();    // jets sorted and paired by mjj, turn this off to simply take the leading two jets
-              s->vars.bdt_out = TMVATools::getClassifierScore(reader, methodName, tmap, s->vars); // set tmva's bdt score
+              s->vars.bdt_out = evaluator->getClassifierScore(s->vars); // set tmva's bdt score
 
               // load multi results into varset
-              //std::vector<float> bdt_multi_scores = TMVATools::getMulticlassScores(reader_multi, methodName, tmap_multi, s->vars);
+              //const std::vector<float>& bdt_multi_scores = evaluator_multi->getMulticlassScores(s->vars);
               //s->vars.bdt_ggh_out = bdt_multi_scores[0];
               //s->vars.bdt_vbf_out = bdt_multi_scores[1];
               //s->vars.bdt_vh_out  = bdt_multi_scores[2];
@@ -652,37 +1121,46 @@ Categorizer* plotWithSystematic(TString systematic, Settings& settings)
           }
 
           // Figure out which category the event belongs to
-          categorySelection->evaluate(s->vars);
+          g.categorySelection->evaluate(s->vars);
 
-          // Look at each category, if the event belongs to that category fill the histogram for the sample x category
-          for(auto &c : categorySelection->categoryMap)
-          {
-              // skip categories that we decided to hide (usually some intermediate categories)
-              if(c.second.hide) continue;
-              if(!c.second.inCategory) continue;
+          ///////////////////////////////////////////////////////////////////
+          // FILL HISTOGRAMS FOR REQUESTED VARIABLES ------------------------
+          ///////////////////////////////////////////////////////////////////
 
-              ///////////////////////////////////////////////////////////////////
-              // FILL HISTOGRAMS FOR REQUESTED VARIABLE -------------------------
-              ///////////////////////////////////////////////////////////////////
+          // get the value of each variable once, not once per category and systematic
+          if(fillHistos)
+          {
+              for(unsigned int k=0; k<g.ivars.size(); k++)
+                  varvalues[k] = plotFeatures[g.ivars[k]].get(s->vars);
+          }
 
-              // now that we have a lot of these in the VarSet map we should just fill the s->vars.getValue("varName")
-              // would save a lot of explicit code here ...
+          // nominal, PU_up, and PU_down share the categories, they only change the weight
+          for(auto& sf: jv.systematics)
+          {
+              double weight = s->getWeight(sf.weightId);
+              if(sf.skimWriter != 0) sf.skimWriter->fill(weight);
+              if(!fillHistos) continue;
 
-              if(settings.varname.Contains("dimu_mass")) 
+              // Look at each category, if the event belongs to that category fill the histograms for the sample x category
+              for(auto &c : sf.fills)
               {
-                  if(isData && dimu.mass > 120 && dimu.mass < 130 && isblinded) continue; // blind signal region
+                  if(!c.first->inCategory) continue;
 
-                  // if the event is in the current category then fill the category's histogram for the given sample and variable
-                  c.second.histoMap[hkey]->Fill(s->vars.getValue(settings.varname.Data()), s->getWeight());
-                  //std::cout << "    " << c.first << ": " << varvalue;
-                  continue;
-              }
-              else
-              {
-                  c.second.histoMap[hkey]->Fill(s->vars.getValue(settings.varname.Data()), s->getWeight());
-              }
+                  for(unsigned int k=0; k<g.ivars.size(); k++)
+                  {
+                      const PlotVar& var = settings.plotvars[g.ivars[k]];
+                      if(var.isMass) 
+                      {
+                          if(isData && dimu.mass > 120 && dimu.mass < 130 && isblinded) continue; // blind signal region
+                          if(dimu.mass < var.min || dimu.mass > var.max) continue;                // in range for another variable
+                      }
 
-          } // end category loop
+                      // if the event is in the current category then fill the category's histogram for the given sample and variable
+                      c.second[k]->fill(varvalues[k], weight);
+                  }
+
+              } // end category loop
+          } // end systematic loop
 
           ////////////////////////////////////////////////////////////////////
           // DEBUG ----------------------------------------------------------
@@ -690,92 +1168,401 @@ Categorizer* plotWithSystematic(TString systematic, Settings& settings)
           // ouput pt, mass info etc for the event
           if(false)
           {
-            EventTools::outputEvent(s->vars, *categorySelection);
-            return categorySelection;
+            EventTools::outputEvent(s->vars, *g.categorySelection);
           }
            
           //------------------------------------------------------------------
           ////////////////////////////////////////////////////////////////////
 
-          if(found_good_dimuon) break; // only fill one dimuon, break from dimu cand loop
+          // put the nominal jets back before the next GetEntry
+          if(jv.jes != 0) jv.jes->swap(s->vars);
+
+          } // end jet variation loop
+
+          if(found_good_dimuon && !writeSkim) break; // only fill one dimuon, break from dimu cand loop
 
         } // end dimu cand loop //
+        } // end calibration group loop //
       } // end event loop //
 
-      if(settings.whichCategories >= 2) delete reader;
-      //if(settings.whichCategories >= 2) delete reader_multi;
+      if(evaluator != 0)
+      {
+          std::lock_guard<std::mutex> lock(statsMutex);
+          tmvaTiming.add(evaluator->timing);
+      }
+      delete evaluator;
+      //delete evaluator_multi;
 
-      // Scale according to settings.luminosity and sample xsec now that the histograms are done being filled for that sample
-      for(auto &c : categorySelection->categoryMap)
+      for(auto& g: groups)
       {
-          // Only used half of the signal events in this case, need to boost the normalization by 2 to make up for that
-          if(settings.whichCategories >= 2 && isSignal && settings.binning < 0) c.second.histoMap[hkey]->Scale(2*s->getLumiScaleFactor(settings.luminosity));
-          else c.second.histoMap[hkey]->Scale(s->getLumiScaleFactor(settings.luminosity));
+          for(auto& jv: g.jetVariations)
+          {
+              for(auto& sf: jv.systematics)
+              {
+                  if(sf.skimWriter == 0) continue;
+                  std::cout << Form("  /// Wrote %llu events to %s \n", sf.skimWriter->writer.nRows, sf.skimWriter->writer.filename.Data());
+                  sf.skimWriter->close();
+                  delete sf.skimWriter;
+              }
+          }
+          delete g.categorySelection;
       }
 
-      std::cout << Form("  /// Done processing %s \n", s->name.Data());
+      // Scale according to settings.luminosity and sample xsec now that the histograms are done being filled for that chunk
+      scaleHistos(shard, s, settings);
+
+      {
+          std::lock_guard<std::mutex> lock(statsMutex);
+          bytesRead.addBytesRead(s->branches);
+          ioStats[s->name].add(s->getIOStats());
+      }
+
+      std::cout << Form("  /// Done processing %s chunk %d/%d \n", s->name.Data(), ichunk+1, nchunks);
       delete s;
-      return categorySelection;
+      return shard;
 
     }; // done defining makeHistoForSample
 
+    ///////////////////////////////////////////////////////////////////
+    // Define Task to Fill From the Skim ------------------------------
+    ///////////////////////////////////////////////////////////////////
+
+    auto makeHistoFromSkim = [settings, systematics](Sample* s)
+    {
+      bool isblinded = true;              // negative settings.binning: unblind data in 120-130 GeV 
+      if(settings.binning < 0) isblinded = false;
+
+      bool isData = s->sampleType.EqualTo("data");
+      bool isSignal = s->sampleType.EqualTo("signal");
+
+      Categorizer* categorySelection = getCategorizer(settings);
+      HistoShard shard = bookHistos(categorySelection, s, systematics, settings);
+      delete categorySelection;
+
+      for(unsigned int isyst=0; isyst<systematics.size(); isyst++)
+      {
+      TString systematic = systematics[isyst];
+      if(!shard.booked[isyst]) continue;
+
+      // there is one skim per calibration and chunk, the first chunk knows how many chunks there are.
+      // a missing chunk would quietly leave its events out of the plots, so the shard is marked incomplete
+      std::vector<CalibrationGroup> groups = getCalibrationGroups(settings);
+      for(auto& g: groups)
+      {
+        int nchunks = 1;
+        for(int ichunk=0; ichunk<nchunks; ichunk++)
+        {
+          TString skimname = getSkimFilename(settings, s->name, g.calibration, systematic, ichunk);
+          std::cout << Form("  /// Processing %s from %s \n", s->name.Data(), skimname.Data());
+
+          ColumnFileReader skim;
+          if(!skim.open(skimname))
+          {
+              std::cout << Form("  !!! Could not open %s, make it with --skim=write first \n", skimname.Data());
+              shard.complete = false;
+              continue;
+          }
+          int skimChunks = skim.getMetadata("nchunks") != ""?skim.getMetadata("nchunks").Atoi():1;
+          if(ichunk == 0) nchunks = skimChunks;
+          else if(skimChunks != nchunks)
+          {
+              std::cout << Form("  !!! %s is one of %d chunks but the first chunk has %d, make the skims again with --skim=write \n", 
+                                skimname.Data(), skimChunks, nchunks);
+              shard.complete = false;
+              continue;
+          }
+
+          // the info_only samples didn't look at the metadata tree, get the normalization from the skim
+          s->nOriginal = skim.getMetadata("nOriginal").Atoi();
+          s->nOriginalWeighted = skim.getMetadata("nOriginalWeighted").Atoi();
+          s->N = skim.getMetadata("N").Atoi();
+
+          // only read the columns we need
+          int imass   = skim.findColumn("dimu_mass");    // set to the calibration of the skim 
+          int iweight = skim.findColumn("weight");
+          int irun    = skim.findColumn("run");
+          int ievent  = skim.findColumn("event");
+
+          std::vector<int> ivars;
+          std::vector<int> varColumns;
+          for(auto& v: g.ivars)
+          {
+              int icol = skim.findColumn(settings.plotvars[v].varname);
+              if(icol < 0) std::cout << Form("  !!! %s is not a valid variable %s \n", settings.plotvars[v].varname.Data(), s->name.Data());
+              else
+              {
+                  ivars.push_back(v);
+                  varColumns.push_back(icol);
+              }
+          }
+
+          // the histos to fill for each variable, one entry per category column
+          std::vector< std::pair<int, std::vector<FastHist*> > > catColumns;
+          for(unsigned int c=0; c<shard.categories.size(); c++)
+          {
+              int icat = skim.findColumn("cat_"+shard.categories[c]);
+              if(icat < 0) continue;
+
+              std::vector<FastHist*> histos;
+              for(auto& v: ivars)
+                  histos.push_back(shard.get(isyst, v, c));
+              catColumns.push_back(std::pair<int, std::vector<FastHist*> >(icat, histos));
+          }
+
+          // the rows of an event's selected candidates are next to each other, use the first one that passes the 
+          // plotting cuts like makeHistoForSample does
+          long long lastRun = -1;
+          long long lastEvent = -1;
+          bool filledEvent = false;
+
+          for(int ig=0; ig<skim.nGroups(); ig++)
+          {
+              const float* mass       = skim.getFloats(ig, imass);
+              const double* weight    = skim.getDoubles(ig, iweight);
+              const long long* run    = skim.getLongs(ig, irun);
+              const long long* event  = skim.getLongs(ig, ievent);
+
+              std::vector<const float*> values;
+              for(auto& icol: varColumns)
+                  values.push_back(skim.getFloats(ig, icol));
+
+              std::vector<const unsigned char*> inCategory;
+              for(auto& c: catColumns)
+                  inCategory.push_back(skim.getBytes(ig, c.first));
+
+              for(unsigned long long i=0; i<skim.groupSize(ig); i++)
+              {
+                  if(run[i] != lastRun || event[i] != lastEvent)
+                  {
+                      lastRun = run[i];
+                      lastEvent = event[i];
+                      filledEvent = false;
+                  }
+                  if(filledEvent) continue;
+
+                  // same plotting cuts as makeHistoForSample
+                  if(isSignal && settings.whichCategories==3 && settings.binning<0 && (event[i] % 2 == 1)) continue;
+                  if(TMath::Abs(settings.binning) == 1 && (mass[i] < 110 || mass[i] > 160)) continue;
+
+                  bool inRange = false;
+                  for(auto& v: g.ivars)
+                  {
+                      const PlotVar& var = settings.plotvars[v];
+                      if(!var.isMass || (mass[i] >= var.min && mass[i] <= var.max)) inRange = true;
+                  }
+                  if(!inRange) continue;
+                  filledEvent = true;
+
+                  for(unsigned int c=0; c<catColumns.size(); c++)
+                  {
+                      if(!inCategory[c][i]) continue;
+                      for(unsigned int k=0; k<ivars.size(); k++)
+                      {
+                          const PlotVar& var = settings.plotvars[ivars[k]];
+                          if(var.isMass && (mass[i] < var.min || mass[i] > var.max)) continue;
+                          if(var.isMass && isData && mass[i] > 120 && mass[i] < 130 && isblinded) continue; // blind signal region
+
+                          catColumns[c].second[k]->fill(values[k][i], weight[i]);
+                      }
+                  }
+              }
+          }
+        } // end chunk loop
+      }
+      } // end systematic loop
+
+      scaleHistos(shard, s, settings);
+
+      std::cout << Form("  /// Done processing %s \n", s->name.Data());
+      delete s;
+      return shard;
+
+    }; // done defining makeHistoFromSkim
+
    ///////////////////////////////////////////////////////////////////
-   // PARALLELIZE BY SAMPLE -----------------------------------------
+   // PARALLELIZE BY SAMPLE CHUNK ------------------------------------
    ///////////////////////////////////////////////////////////////////
 
-    ThreadPool pool(settings.nthreads);
-    std::vector< std::future<Categorizer*> > results;
+    // a sample or a chunk of a sample to process, the number of entries is the cost hint
+    struct Task
+    {
+        Sample* s;
+        Long64_t first;
+        Long64_t last;
+        int ichunk;
+        int nchunks;
+        double cost;
+    };
+    std::vector<Task> tasks;
 
     for(auto &s : samplevec)
-        results.push_back(pool.enqueue(makeHistoForSample, s));
+    {
+        if(readSkim) 
+        {
+            // the skims are small, one task per sample is plenty
+            tasks.push_back(Task{s, 0, s->N, 0, 1, (double)s->N});
+            continue;
+        }
+
+        // the samples that only keep some of the runs in their files skip the other runs' entries,
+        // the readers share the index so we make it here
+        if(s->hasRunRange()) s->getEventIndex();
+
+        // stat the ntuples once per sample instead of once per chunk
+        if(settings.cachePreselection) preselectionKeys[s->name] = getPreselectionKey(settings, s);
+
+        // split the sample into entry ranges, each chunk gets its own reader so the threads don't share a TChain
+        std::vector< std::pair<Long64_t, Long64_t> > ranges = s->getEntryRanges(settings.chunkSize, s->N/settings.reductionFactor);
+        for(unsigned int r=0; r<ranges.size(); r++)
+        {
+            double cost = 0;
+            for(auto& rr: s->getRunRanges(s->minRun, s->maxRun, ranges[r].first, ranges[r].second))
+                cost += rr.second - rr.first;
+            tasks.push_back(Task{s, ranges[r].first, ranges[r].second, (int)r, (int)ranges.size(), cost});
+        }
+    }
+    std::cout << "@@@ nTasks         : " << tasks.size() << std::endl;
+
+    // start the biggest tasks first so that they don't make a long tail at the end,
+    // results stays in xsec order for the stacks
+    std::vector<unsigned int> order(tasks.size());
+    for(unsigned int t=0; t<tasks.size(); t++) order[t] = t;
+    std::stable_sort(order.begin(), order.end(), [&tasks](unsigned int a, unsigned int b){ return tasks[a].cost > tasks[b].cost; });
+
+    WorkStealingThreadPool pool(settings.nthreads);
+    std::vector< std::future<HistoShard> > results(tasks.size());
+
+    for(auto& t: order)
+    {
+        Task& task = tasks[t];
+        if(readSkim) 
+        {
+            results[t] = pool.enqueueWithCost(task.cost, makeHistoFromSkim, task.s);
+            continue;
+        }
+
+        // the readers copy the I/O options from the sample
+        task.s->cacheSize = (Long64_t)(settings.cacheSize*1000000);
+        task.s->ioStats = settings.ioStats;
+
+        Sample* reader = 0;
+        if(oneLoop)
+        {
+            reader = task.s->makeReader("");
+            reader->setSystematicBranchAddresses(systematics);
+        }
+        else reader = task.s->makeReader(systematics[0]);
+        reader->setActiveBranches(activeBranches);
+
+        results[t] = pool.enqueueWithCost(task.cost, makeHistoForSample, reader, task.first, task.last, task.ichunk, task.nchunks);
+    }
 
    ///////////////////////////////////////////////////////////////////
-   // Gather all the Histos into one Categorizer----------------------
+   // Gather all the Histos into one Categorizer per variable --------
    ///////////////////////////////////////////////////////////////////
 
-    Categorizer* cAll = 0;
-    if(settings.whichCategories == 1) cAll = new CategorySelectionRun1();                            // run1 categories 
-    else if(settings.whichCategories == 2) cAll = new CategorySelectionBDT();                        // run2 categories
-    else if(settings.whichCategories == 3 && settings.xmlfile.Contains("hybrid")) 
-        cAll = new CategorySelectionHybrid(settings.xmlfile);                                        // XML + Object cuts
-    else if(settings.whichCategories == 3) cAll = new XMLCategorizer(settings.xmlfile);              // XML only
+    std::map<TString, std::vector<Categorizer*> > cAllSystematics;
+    for(auto& systematic: systematics)
+        for(auto& v: settings.plotvars)
+            cAllSystematics[systematic].push_back(getCategorizer(settings));
 
-    // get histos from all categorizers and put them into one categorizer
-    for(auto && categorizer: results)  // loop through each Categorizer object, one per sample
+    // add up the chunks of each sample in task order, the same pairwise tree no matter which thread finished first
+    std::vector<TString> sampleOrder;
+    std::map<TString, TreeReduction<HistoShard> > sampleShards;
+    for(auto && result: results)  // loop through each sample chunk
     {
-        int i = 0;
-        for(auto& category: categorizer.get()->categoryMap) // loop through each category for the given sample
-        {
-            // category.first is the category name, category.second is the Category object
-            if(category.second.hide) continue;
-            for(auto& h: category.second.histoMap) // loop through each histogram in this category's histo map
-            {
-                // std::cout << Form("%s: %f", h.first.Data(), h.second->Integral()) << std::endl;
-                // we defined hkey = h.first as the sample name earlier so we have 
-                // our histomap : category.histoMap<samplename, TH1D*>
-                Sample* s = samples[h.first];
+        HistoShard shard = result.get();
+        if(sampleShards.count(shard.sample) == 0) sampleOrder.push_back(shard.sample);
+        sampleShards[shard.sample].push(std::move(shard));
+    }
 
-                cAll->categoryMap[category.first].histoMap[h.first] = h.second;
-                cAll->categoryMap[category.first].histoList->Add(h.second);
+    // make the TH1Ds and put them into one categorizer per variable, in xsec order for the stacks
+    bool complete = true;
+    for(auto& name: sampleOrder)
+    {
+        HistoShard shard = sampleShards[name].result();
+        if(!shard.complete)
+        {
+            std::cout << Form("  !!! Some of the input for %s is missing \n", name.Data());
+            complete = false;
+        }
 
-                if(s->sampleType.EqualTo("signal"))          cAll->categoryMap[category.first].signalList->Add(h.second);
-                else if(s->sampleType.EqualTo("background")) cAll->categoryMap[category.first].bkgList->Add(h.second);
-                else                                         cAll->categoryMap[category.first].dataList->Add(h.second);
+        for(unsigned int k=0; k<systematics.size(); k++)         // loop through the systematics
+        {
+            if(!shard.booked[k]) continue;
+            std::vector<Categorizer*>& cAll = cAllSystematics[systematics[k]];
+            for(unsigned int v=0; v<shard.nvars; v++)            // loop through the variables
+            {
+                for(unsigned int c=0; c<shard.categories.size(); c++)
+                {
+                    // histomap : category.histoMap<samplename, TH1D*>
+                    Category& category = cAll[v]->categoryMap[shard.categories[c]];
+                    TString hname = category.name+"_"+name;
+                    if(systematics[k] != "" && !shard.sampleType.EqualTo("data")) hname+="_"+systematics[k];
+
+                    TH1D* h = shard.get(k, v, c)->toTH1D(hname, hname);
+                    h->GetXaxis()->SetTitle(settings.plotvars[v].varname);
+
+                    category.histoMap[name] = h;
+                    category.histoList->Add(h);
+                    if(shard.sampleType.EqualTo("signal"))          category.signalList->Add(h);
+                    else if(shard.sampleType.EqualTo("background")) category.bkgList->Add(h);
+                    else                                            category.dataList->Add(h);
+                }
             }
         }
     }
 
-    return cAll;
+    // how well were the threads used
+    pool.outputStats();
+    if(!readSkim) bytesRead.outputBytesRead();
+    if(!readSkim && settings.ioStats)
+    {
+        std::cout << "======== I/O Per Sample ========" << std::endl;
+        IOStats::outputHeader();
+        for(auto& io: ioStats)
+            io.second.output();
+        std::cout << std::endl;
+    }
+    if(tmvaTiming.nevents > 0)
+    {
+        std::cout << "======== TMVA Evaluation Rate ========" << std::endl;
+        tmvaTiming.output();
+        std::cout << std::endl;
+    }
+
+    // don't save plots that are missing events
+    if(!complete) return std::map<TString, std::vector<Categorizer*> >();
+    return cAllSystematics;
 }
 
 //////////////////////////////////////////////////////////////////
 //---------------------------------------------------------------
 //////////////////////////////////////////////////////////////////
 
+// everything we save for one variable
+struct PlotOutput
+{
+    std::map<TString, TH1D*> netDataMap;
+    TList* varstacklist = new TList();   // list to save all of the stacks
+    TList* signallist = new TList();     // list to save all of the signal histos
+    TList* bglist = new TList();         // list to save all of the background histos
+    TList* datalist = new TList();       // list to save all of the data histos
+    TList* netlist = new TList();        // list to save all of the net histos
+};
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
 int main(int argc, char* argv[])
 {
+    // the sample chunks open their files in the worker threads
+    ROOT::EnableThreadSafety();
+
     Settings settings;
     std::vector<TString> systematics = {""};
+    TString varlist = settings.varname;
 
     ///////////////////////////////////////////////////////////////
     // Parse Arguments -------------------------------------------
@@ -801,7 +1588,7 @@ int main(int argc, char* argv[])
             else
                 ss >> settings.whichCategories;
         }
-        else if(option=="var")             settings.varname = value;
+        else if(option=="var")             varlist = value;
         else if(option=="binning")         ss >> settings.binning;
         else if(option=="nthreads")        ss >> settings.nthreads;
         else if(option=="rebinRatio")      ss >> settings.rebin;
@@ -811,6 +1598,20 @@ int main(int argc, char* argv[])
         else if(option=="subleadPt")       ss >> settings.subleadPt;
         else if(option=="whichDY")         settings.whichDY = value;
         else if(option=="sig_xlumi")       ss >> settings.sig_xlumi;
+        else if(option=="skim")            settings.skim = value;
+        else if(option=="skimdir")         settings.skimdir = value;
+        else if(option=="chunkSize")       ss >> settings.chunkSize;
+        else if(option=="batchSize")       ss >> settings.batchSize;
+        else if(option=="cachePreselection") ss >> settings.cachePreselection;
+        else if(option=="preselectiondir") settings.preselectiondir = value;
+        else if(option=="cacheSize")       ss >> settings.cacheSize;
+        else if(option=="asyncPrefetch")   ss >> settings.asyncPrefetch;
+        else if(option=="parallelUnzip")   ss >> settings.parallelUnzip;
+        else if(option=="ioStats")         ss >> settings.ioStats;
+        else if(option=="location")        settings.location = value;
+        else if(option=="mirrordir")       settings.mirrordir = value;
+        else if(option=="mirrorSize")      ss >> settings.mirrorSize;
+        else if(option=="oneLoop")         ss >> settings.oneLoop;
         else if(option=="systematics")
         {
             TString tok;
@@ -822,25 +1623,46 @@ int main(int argc, char* argv[])
         }
         else
         {
-            std::cout << Form("!!! %s is not a recognized option.", option) << std::endl;
+            std::cout << Form("!!! %s is not a recognized option.", option.Data()) << std::endl;
         }
     }   
 
+    // set nbins, min, max for each var to plot based upon input from the terminal: var and settings.binning
+    initPlotVars(settings, varlist);
+
+    if(settings.skim == "write") gSystem->mkdir(settings.skimdir, true);
+    if(settings.cachePreselection) gSystem->mkdir(settings.preselectiondir, true);
+
+    // before any files are opened
+    Sample::setGlobalIOOptions(settings.asyncPrefetch, settings.parallelUnzip);
+    if(settings.parallelUnzip) ROOT::EnableImplicitMT();
+    FileMirror::setup(settings.mirrordir, settings.mirrorSize);
+
     ///////////////////////////////////////////////////////////////////
     // SAMPLES---------------------------------------------------------
     ///////////////////////////////////////////////////////////////////
 
     // get the signal samples so that we know their lumi and xsec
     std::map<TString, Sample*> samples;
-    GetSamples(samples, "UF", "SIGNALX", true);
+    GetSamples(samples, settings.location, "SIGNALX", true);
 
-    std::map<TString, TH1D*> netDataMap;
-    TList* varstacklist = new TList();   // list to save all of the stacks
-    TList* signallist = new TList();     // list to save all of the signal histos
-    TList* bglist = new TList();         // list to save all of the background histos
-    TList* datalist = new TList();       // list to save all of the data histos
-    TList* netlist = new TList();        // list to save all of the net histos
+    std::vector<PlotOutput> outputs(settings.plotvars.size());
 
+    // read the MC once for all of the systematics
+    std::map<TString, std::vector<Categorizer*> > cAllSystematics;
+    if(settings.oneLoop && systematics.size() > 1)
+    {
+        TStopwatch timerWatch;
+        timerWatch.Start();
+        cAllSystematics = plotWithSystematics(systematics, settings);
+        timerWatch.Stop();
+        if(cAllSystematics.size() == 0)
+        {
+            std::cout << "!!! Could not make the histograms, not saving any plots" << std::endl;
+            return 1;
+        }
+        std::cout << "### DONE WITH THE EVENT LOOP FOR ALL SYSTEMATICS " << timerWatch.RealTime() << " seconds" << std::endl;
+    }
 
     for(auto& systematic: systematics)
     {
@@ -853,7 +1675,18 @@ int main(int argc, char* argv[])
         std::cout << "/////////////////////////////////////////////////////////////////////" << std::endl;
         std::cout << std::endl;
 
-        Categorizer* cAll = plotWithSystematic(systematic, settings);
+        // otherwise rerun over the samples for each systematic
+        if(cAllSystematics.count(systematic) == 0)
+        {
+            std::map<TString, std::vector<Categorizer*> > cThisSystematic = plotWithSystematics(std::vector<TString>{systematic}, settings);
+            if(cThisSystematic.count(systematic) == 0)
+            {
+                std::cout << "!!! Could not make the histograms for systematic " << systematic << std::endl;
+                return 1;
+            }
+            cAllSystematics[systematic] = cThisSystematic[systematic];
+        }
+        std::vector<Categorizer*> cAllVars = cAllSystematics[systematic];
 
         ///////////////////////////////////////////////////////////////////
         // Gather All of the Histos---------------------------------------
@@ -863,7 +1696,13 @@ int main(int argc, char* argv[])
         TString suffix = "";
         if(systematic != "") suffix = "_"+systematic;
 
-        std::cout << "About to loop through cAll" << std::endl;
+        for(unsigned int v=0; v<settings.plotvars.size(); v++)
+        {
+        Categorizer* cAll = cAllVars[v];
+        PlotVar& var = settings.plotvars[v];
+        PlotOutput& out = outputs[v];
+
+        std::cout << "About to loop through cAll for " << var.varname << std::endl;
         int i = 0;
         for(auto &c : cAll->categoryMap)
         {
@@ -898,10 +1737,10 @@ int main(int argc, char* argv[])
             if(c.second.dataList->GetSize()!=0) 
             {
                 hNetData = DiMuPlottingSystem::addHists(c.second.dataList,   c.second.name+"_Net_Data"+suffix,   "Data");
-                netDataMap[c.second.name] = hNetData;
+                out.netDataMap[c.second.name] = hNetData;
             }
             else
-                hNetData = netDataMap[c.second.name];
+                hNetData = out.netDataMap[c.second.name];
 
 
             TList* groupedlist = DiMuPlottingSystem::groupMC(c.second.histoList, c.second.name, suffix);
@@ -913,8 +1752,8 @@ int main(int argc, char* argv[])
             //stackedHistogramsAndRatio(TList* list, TString name, TString title, TString xaxistitle, TString yaxistitle, bool settings.rebin = false, bool fit = true,
                                       //TString ratiotitle = "Data/MC", bool log = true, bool stats = false, int legend = 0);
             // stack signal, bkg, and data
-            TCanvas* stack = DiMuPlottingSystem::stackedHistogramsAndRatio(groupedlist, stackname, stackname, settings.varname, "Num Entries", settings.rebin, settings.fitratio);
-            varstacklist->Add(stack);
+            TCanvas* stack = DiMuPlottingSystem::stackedHistogramsAndRatio(groupedlist, stackname, stackname, var.varname, "Num Entries", settings.rebin, settings.fitratio);
+            out.varstacklist->Add(stack);
 
             // we scaled by lumi*xsec/n_weighted for the stack comparisons
             // the limit setting needs the signal scaled only by 1/n_weighted
@@ -939,18 +1778,19 @@ int main(int argc, char* argv[])
             std::cout << Form("%s: %f \n", hNetSignal125->GetName(), hNetSignal125->Integral());
             std::cout << Form("%s: %f \n\n", hNetSignal130->GetName(), hNetSignal130->Integral());
 
-            signallist->Add(c.second.signalList);
-            bglist->Add(c.second.bkgList);
-            datalist->Add(c.second.dataList);
+            out.signallist->Add(c.second.signalList);
+            out.bglist->Add(c.second.bkgList);
+            out.datalist->Add(c.second.dataList);
 
-            netlist->Add(hNetSignal125);
-            netlist->Add(hNetSignal120);
-            netlist->Add(hNetSignal130);
-            netlist->Add(hNetBkg);
-            netlist->Add(groupedlist);
+            out.netlist->Add(hNetSignal125);
+            out.netlist->Add(hNetSignal120);
+            out.netlist->Add(hNetSignal130);
+            out.netlist->Add(hNetBkg);
+            out.netlist->Add(groupedlist);
            
-            stack->SaveAs("imgs/"+settings.varname+"_"+stackname+"_"+settings.whichDY+Form("_b%d.png", settings.binning));
+            stack->SaveAs("imgs/"+var.varname+"_"+stackname+"_"+settings.whichDY+Form("_b%d.png", settings.binning));
         }
+        } // end var loop
         timerWatch.Stop();
         std::cout << "### DONE " << timerWatch.RealTime() << " seconds" << std::endl;
     }
@@ -974,40 +1814,47 @@ int main(int argc, char* argv[])
         xcategoryString = "_"+xcategoryString;
     }
 
-    TString xvarname = settings.varname;
-    if(settings.varname.Contains("dimu_mass")) xvarname=blinded+"_"+xvarname;
-    TString savename = Form("rootfiles/validate_%s_%d_%d_categories%d%s_%d_%s_minpt%d_b%d_sig-xlumi%d.root", xvarname.Data(), (int)settings.min, 
-                            (int)settings.max, settings.whichCategories, xcategoryString.Data(), (int)settings.luminosity, 
-                            settings.whichDY.Data(), (int)settings.subleadPt, settings.binning, settings.sig_xlumi);
+    // one file per variable, same layout as when we plotted one variable per job
+    for(unsigned int v=0; v<settings.plotvars.size(); v++)
+    {
+        PlotVar& var = settings.plotvars[v];
+        PlotOutput& out = outputs[v];
 
-    std::cout << "  /// Saving plots to " << savename << " ..." << std::endl;
-    std::cout << std::endl;
+        TString xvarname = var.varname;
+        if(var.varname.Contains("dimu_mass")) xvarname=blinded+"_"+xvarname;
+        TString savename = Form("rootfiles/validate_%s_%d_%d_categories%d%s_%d_%s_minpt%d_b%d_sig-xlumi%d.root", xvarname.Data(), (int)var.min, 
+                                (int)var.max, settings.whichCategories, xcategoryString.Data(), (int)settings.luminosity, 
+                                settings.whichDY.Data(), (int)settings.subleadPt, settings.binning, settings.sig_xlumi);
 
-    TFile* savefile = new TFile(savename, "RECREATE");
+        std::cout << "  /// Saving plots to " << savename << " ..." << std::endl;
+        std::cout << std::endl;
+
+        TFile* savefile = new TFile(savename, "RECREATE");
 
-    TDirectory* stacks        = savefile->mkdir("stacks");
-    TDirectory* signal_histos = savefile->mkdir("signal_histos");
-    TDirectory* bg_histos     = savefile->mkdir("bg_histos");
-    TDirectory* data_histos   = savefile->mkdir("data_histos");
-    TDirectory* net_histos    = savefile->mkdir("net_histos");
+        TDirectory* stacks        = savefile->mkdir("stacks");
+        TDirectory* signal_histos = savefile->mkdir("signal_histos");
+        TDirectory* bg_histos     = savefile->mkdir("bg_histos");
+        TDirectory* data_histos   = savefile->mkdir("data_histos");
+        TDirectory* net_histos    = savefile->mkdir("net_histos");
 
-    // save the different histos and stacks in the appropriate directories in the tfile
-    stacks->cd();
-    varstacklist->Write();
+        // save the different histos and stacks in the appropriate directories in the tfile
+        stacks->cd();
+        out.varstacklist->Write();
 
-    signal_histos->cd();
-    signallist->Write();
+        signal_histos->cd();
+        out.signallist->Write();
 
-    bg_histos->cd();
-    bglist->Write();
+        bg_histos->cd();
+        out.bglist->Write();
 
-    data_histos->cd();
-    datalist->Write();
+        data_histos->cd();
+        out.datalist->Write();
 
-    net_histos->cd();
-    netlist->Write();
+        net_histos->cd();
+        out.netlist->Write();
 
-    savefile->Close();
+        savefile->Close();
+    }
  
     return 0;
 }
@@ -0,0 +1,158 @@
+/////////////////////////////////////////////////////////////////////////////
+//                           checkDimuonBatch.cxx                          //
+//=========================================================================//
+//                                                                         //
+// Check that the DimuonBatch preselection categorize uses gives the same  //
+// candidates as the per-event cuts on the VarSet, for PF, Roch, and KaMu. //
+// The fake events have calibrated pts a few percent away from the raw pt  //
+// and isolation sums near the cut, so a batch column that used the wrong  //
+// pt would show up as a mismatch.                                         //
+// ./checkDimuonBatch [nevents]                                            //
+//                                                                         //
+/////////////////////////////////////////////////////////////////////////////
+
+#include "DimuonBatch.h"
+#include "EventSelection.h"
+#include "MuonSelection.h"
+#include "VarSet.h"
+
+#include "TRandom3.h"
+#include "TMath.h"
+
+#include <sstream>
+#include <vector>
+#include <iostream>
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+// a few muons and every pair of them, enough for the preselection
+struct FakeEvent
+{
+    EventInfo eventInfo;
+    std::vector<MuonInfo> muons;
+    std::vector<MuPairInfo> muPairs;
+
+    FakeEvent(TRandom3& random)
+    {
+        eventInfo.run = 278000 + random.Integer(1600);
+        muons.resize(2 + random.Integer(3));
+        for(auto& mu: muons)
+        {
+            mu.pt = random.Uniform(5, 60);
+            mu.pt_PF = mu.pt*random.Gaus(1, 0.03);
+            mu.pt_Roch = mu.pt*random.Gaus(1, 0.03);
+            mu.pt_KaMu = mu.pt*random.Gaus(1, 0.03);
+            mu.eta = random.Uniform(-2.6, 2.6);
+            mu.charge = random.Rndm() < 0.5?-1:1;
+            mu.isMediumID = random.Rndm() < 0.9;
+            for(unsigned int t=0; t<sizeof(mu.isHltMatched)/sizeof(mu.isHltMatched[0]); t++)
+                mu.isHltMatched[t] = random.Rndm() < 0.7;
+
+            // relative isolation spread around the 0.25 cut
+            mu.sumChargedHadronPtR04 = mu.pt*random.Uniform(0, 0.3);
+            mu.sumNeutralHadronEtR04 = mu.pt*random.Uniform(0, 0.1);
+            mu.sumPhotonEtR04 = mu.pt*random.Uniform(0, 0.1);
+            mu.sumPUPtR04 = mu.pt*random.Uniform(0, 0.1);
+        }
+
+        for(unsigned int i=0; i<muons.size(); i++)
+        {
+            for(unsigned int j=i+1; j<muons.size(); j++)
+            {
+                MuPairInfo dimu;
+                dimu.iMu1 = i;
+                dimu.iMu2 = j;
+                dimu.mass = random.Uniform(40, 200);
+                dimu.mass_PF = dimu.mass*random.Gaus(1, 0.01);
+                dimu.mass_Roch = dimu.mass*random.Gaus(1, 0.01);
+                dimu.mass_KaMu = dimu.mass*random.Gaus(1, 0.01);
+                muPairs.push_back(dimu);
+            }
+        }
+    }
+
+    void setVars(VarSet& vars)
+    {
+        vars.eventInfo = &eventInfo;
+        vars.muons = &muons;
+        vars.muPairs = &muPairs;
+    }
+};
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+    int nevents = 100000;
+    if(argc > 1)
+    {
+        std::stringstream ss;
+        ss << argv[1];
+        ss >> nevents;
+    }
+
+    // same cuts as categorize with the default settings
+    Run2MuonSelectionCuts  run2MuonSelection;
+    Run2EventSelectionCuts run2EventSelection;
+    run2MuonSelection.cMinPt = 20;
+    long long minRun = 278000;
+    long long maxRun = 278801;
+
+    TRandom3 random(42);
+    std::vector<FakeEvent> events;
+    for(int i=0; i<nevents; i++)
+        events.push_back(FakeEvent(random));
+
+    int nmismatchTotal = 0;
+    std::vector<TString> calibrations = {"PF", "Roch", "KaMu"};
+    for(auto& calibration: calibrations)
+    {
+        // the batch cuts, on the raw muon branches like Sample::getBatch loads them
+        VarSet vars;
+        DimuonBatch batch(calibration);
+        for(int i=0; i<nevents; i++)
+        {
+            events[i].setVars(vars);
+            batch.add(vars, i);
+        }
+        run2EventSelection.evaluate(batch);
+        batch.applyMediumID();
+        run2MuonSelection.evaluate(batch);
+        batch.applyRunRange(minRun, maxRun);
+
+        // the per-event cuts after setCalibrationType, on a copy since that changes the muon pts
+        int npass = 0;
+        int nmismatch = 0;
+        unsigned int row = 0;
+        for(int i=0; i<nevents; i++)
+        {
+            FakeEvent event = events[i];
+            event.setVars(vars);
+            for(auto& dimu: event.muPairs)
+            {
+                vars.dimuCand = &dimu;
+                vars.setCalibrationType(calibration);
+                MuonInfo& mu1 = event.muons[dimu.iMu1];
+                MuonInfo& mu2 = event.muons[dimu.iMu2];
+
+                bool pass = run2EventSelection.evaluate(vars) && mu1.isMediumID && mu2.isMediumID
+                            && run2MuonSelection.evaluate(vars)
+                            && event.eventInfo.run >= minRun && event.eventInfo.run <= maxRun;
+
+                if(pass) npass++;
+                if(pass != (bool)batch.pass[row]) nmismatch++;
+                row++;
+            }
+        }
+
+        std::cout << Form("  /// %-4s: %d/%d candidates pass, %d differ between the batch and the per-event cuts \n",
+                          calibration.Data(), npass, batch.size(), nmismatch);
+        nmismatchTotal += nmismatch;
+    }
+
+    return (nmismatchTotal == 0) ? 0 : 1;
+}
@@ -288,6 +288,7 @@ void classify(TString factoryname, TString dlname, std::vector<TString>& trainVa
    for(auto &s: samples)
    {
      Sample* samp = s.second;
+     samp->setBranchAddresses("");   // the samples don't open their files until we ask
      int num_passed_in_sample = 0;
 
      std::cout << "///////////////////////////////////////////////////////////////////////" << std::endl;
@@ -302,10 +303,8 @@ void classify(TString factoryname, TString dlname, std::vector<TString>& trainVa
        //////////////////////////////////////////////////////////////////
        samp->branches.eventInfo->GetEntry(iEvt); 
 
-       // Prevent double counting in RunF
-       if (samp->name == "RunF_1" && samp->vars.eventInfo->run > 278801)
-	 continue;
-       if (samp->name == "RunF_2" && samp->vars.eventInfo->run < 278802)
+       // Skip the duplicate data events and the ones outside the sample's runs, see EventVeto
+       if (samp->isVetoed(iEvt))
 	 continue;
 
        // Only use half of the signal events for training
@@ -619,12 +619,8 @@ int main(int argc, char* argv[])
               continue; 
           }
 
-          // avoid double counting for RunF
-          if(s->name == "RunF_1" && s->vars.eventInfo->run > 278801)
-          {
-              continue;
-          }
-          if(s->name == "RunF_2" && s->vars.eventInfo->run < 278802)
+          // the duplicate data events and the ones outside the sample's runs, see EventVeto
+          if(s->isVetoed(i))
           {
               continue;
           }
@@ -62,6 +62,7 @@ int main(int argc, char* argv[])
    for(auto& sample: samples)
    {
       Sample* s = sample.second;
+      s->setBranchAddresses("");   // the samples don't open their files until we ask
       std::cout << Form("  /// Processing %s \n", s->name.Data());
 
       /////////////////////////////////////////////////////
@@ -263,6 +263,9 @@ UInt_t getNumCPUs()
 
 int main(int argc, char* argv[])
 {
+    // the samples are processed and the x bins fit in worker threads
+    ROOT::EnableThreadSafety();
+
     Settings settings;
 
     gROOT->SetBatch();
@@ -472,12 +475,8 @@ int main(int argc, char* argv[])
               continue; 
           }
 
-          // avoid double counting for RunF
-          if(s->name == "RunF_1" && s->vars.eventInfo->run > 278801)
-          {
-              continue;
-          }
-          if(s->name == "RunF_2" && s->vars.eventInfo->run < 278802)
+          // the duplicate data events and the ones outside the sample's runs, see EventVeto
+          if(s->isVetoed(i))
           {
               continue;
           }
@@ -655,7 +654,9 @@ int main(int argc, char* argv[])
         TString masscal_key = item.first;
         MassCalibration* masscal = item.second;
         std::cout << masscal_key << ": " << masscal->histos[0]->GetName() << ": " << masscal->histos[1]->Integral() << std::endl;
-        masscal->plot();
+        masscal->plot(settings.nthreads);
+        std::cout << Form("  /// Fit %s: %d bins in %.2f s, %d from the cache \n", masscal->massname.Data(),
+                          (int)masscal->histos.size(), masscal->fitTime, masscal->nCachedFits);
 
         TGraph* mean_graph = masscal->mean_vs_x;
         TGraph* res_graph = masscal->resolution_vs_x;
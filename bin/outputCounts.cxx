@@ -105,7 +105,7 @@ std::pair<int,int> fwhm(TH1D* h, int start=2)
 //---------------------------------------------------------------
 //////////////////////////////////////////////////////////////////
 
-Categorizer* getHistos(TString xmlfile, int nthreads, float reductionFactor, float luminosity, TString whichDY)
+Categorizer* getHistos(TString xmlfile, int nthreads, float reductionFactor, float luminosity, TString whichDY, Long64_t chunkSize)
 {
     std::map<TString, Sample*> samples;
     // Second container so that we can have a copy sorted by cross section.
@@ -143,7 +143,7 @@ Categorizer* getHistos(TString xmlfile, int nthreads, float reductionFactor, flo
         std::cout << "    nOriginalWeighted: " << i.second->nOriginalWeighted << std::endl;
         std::cout << std::endl;
 
-        i.second->setBranchAddresses("");
+        // the readers for each chunk set their own branch addresses
         samplevec.push_back(i.second);
     }
 
@@ -154,10 +154,11 @@ Categorizer* getHistos(TString xmlfile, int nthreads, float reductionFactor, flo
     std::cout << "@@@ nCPUs used     : " << nthreads << std::endl;
     std::cout << "@@@ nSamples used  : " << samplevec.size() << std::endl;
 
-    auto outputSampleInfo = [xmlfile, luminosity, reductionFactor](Sample* s)
+    // process entries [first, last) of the sample, s is a reader made for this chunk alone
+    auto outputSampleInfo = [xmlfile, luminosity](Sample* s, Long64_t first, Long64_t last)
     {
       // Output some info about the current file
-      std::cout << Form("  /// Processing %s \n", s->name.Data());
+      std::cout << Form("  /// Processing %s entries %lld to %lld \n", s->name.Data(), first, last);
 
       bool isData = s->sampleType == "data";
 
@@ -182,17 +183,9 @@ Categorizer* getHistos(TString xmlfile, int nthreads, float reductionFactor, flo
       /////////////////////////////////////////////////////
       // Book training and spectator vars into reader
 
-      TMVA::Reader* reader = 0;
-      std::map<TString, Float_t> tmap;
-      std::map<TString, Float_t> smap;
-
-      //TMVA::Reader* reader_multi = 0;
-      //std::map<TString, Float_t> tmap_multi;
-      //std::map<TString, Float_t> smap_multi;
-
       // load tmva binary classification and multiclass classifiers
-      reader       = TMVATools::bookVars(methodName, weightfile, tmap, smap);
-      //reader_multi = TMVATools::bookVars(methodName, weightfile_multi, tmap_multi, smap_multi);
+      TMVAEvaluator evaluator(methodName, weightfile, s->vars);
+      //TMVAEvaluator evaluator_multi(methodName, weightfile_multi, s->vars);
 
       // Objects to help with the cuts and selections
       JetCollectionCleaner      jetCollectionCleaner;
@@ -221,6 +214,7 @@ Categorizer* getHistos(TString xmlfile, int nthreads, float reductionFactor, flo
 
             // The number of events histo
             c.second.histoMap[hkeyn] = new TH1D(hnamen, hnamen, hbins, -1, 20);
+            c.second.histoMap[hkeyn]->SetDirectory(0);    // the chunks of a sample all use the same names
             c.second.histoMap[hkeyn]->GetXaxis()->SetTitle("bin");
             c.second.histoList->Add(c.second.histoMap[hkeyn]);                                        
             if(s->sampleType.Contains("data")) c.second.dataList->Add(c.second.histoMap[hkeyn]);      
@@ -229,6 +223,7 @@ Categorizer* getHistos(TString xmlfile, int nthreads, float reductionFactor, flo
 
             // The sum of weights histo
             c.second.histoMap[hkeyw] = new TH1D(hnamew, hnamew, hbins, -1, 20);
+            c.second.histoMap[hkeyw]->SetDirectory(0);    // the chunks of a sample all use the same names
             c.second.histoMap[hkeyw]->GetXaxis()->SetTitle("bin");
             c.second.histoList->Add(c.second.histoMap[hkeyw]);                                        
             if(s->sampleType.Contains("data")) c.second.dataList->Add(c.second.histoMap[hkeyw]);      
@@ -236,7 +231,7 @@ Categorizer* getHistos(TString xmlfile, int nthreads, float reductionFactor, flo
             if(s->sampleType.Contains("background")) c.second.bkgList->Add(c.second.histoMap[hkeyw]); 
       }   
 
-      for(unsigned int i=0; i<s->N/reductionFactor; i++)
+      for(Long64_t i=first; i<last; i++)
       {
 
         // We are stitching together zjets_ht from 70-inf. We use the inclusive for
@@ -291,12 +286,8 @@ Categorizer* getHistos(TString xmlfile, int nthreads, float reductionFactor, flo
               continue; 
           }
 
-          // avoid double counting for RunF
-          if(s->name == "RunF_1" && s->vars.eventInfo->run > 278801)
-          {
-              continue;
-          }
-          if(s->name == "RunF_2" && s->vars.eventInfo->run < 278802)
+          // the duplicate data events and the ones outside the sample's runs, see EventVeto
+          if(s->isVetoed(i))
           {
               continue;
           }
@@ -325,7 +316,7 @@ Categorizer* getHistos(TString xmlfile, int nthreads, float reductionFactor, flo
           //std::cout << i << " !!! SETTING JETS " << std::endl;
           //s->vars.setJets();    // jets sorted and paired by mjj, turn this off to simply take the leading two jets
           s->vars.setVBFjets();   // jets sorted and paired by vbf criteria
-          s->vars.bdt_out = TMVATools::getClassifierScore(reader, methodName, tmap, s->vars); // set tmva's bdt score
+          s->vars.bdt_out = evaluator.getClassifierScore(s->vars); // set tmva's bdt score
 
           categorySelection->evaluate(s->vars);
 
@@ -356,7 +347,7 @@ Categorizer* getHistos(TString xmlfile, int nthreads, float reductionFactor, flo
         } // end dimucand loop
       } // end event loop
 
-      delete reader;
+      evaluator.timing.output();
 
       for(auto& c : categorySelection->categoryMap)
       {
@@ -375,11 +366,17 @@ Categorizer* getHistos(TString xmlfile, int nthreads, float reductionFactor, flo
       return categorySelection;
     }; // end sample lambda function
 
+    // split the big samples into entry ranges so they don't run on one thread long after the rest finish
     ThreadPool pool(nthreads);
     std::vector< std::future<Categorizer*> > results;
 
     for(auto& s: samplevec)
-        results.push_back(pool.enqueue(outputSampleInfo, s));
+    {
+        std::vector< std::pair<Long64_t, Long64_t> > ranges = s->getEntryRanges(chunkSize, s->N/reductionFactor);
+        for(auto& r: ranges)
+            results.push_back(pool.enqueue(outputSampleInfo, s->makeReader(""), r.first, r.second));
+    }
+    std::cout << "@@@ nTasks         : " << results.size() << std::endl;
 
    ///////////////////////////////////////////////////////////////////
    // Gather all the Histos into one Categorizer----------------------
@@ -390,14 +387,24 @@ Categorizer* getHistos(TString xmlfile, int nthreads, float reductionFactor, flo
     else cAll = new CategorySelectionRun1();
 
     // get histos from all categorizers and put them into one
-    for(auto && categorizer: results)  // loop through each Categorizer object, one per sample
+    for(auto && result: results)  // loop through each Categorizer object, one per sample chunk
     {
-        for(auto& category: categorizer.get()->categoryMap) // loop through each category
+        Categorizer* categorizer = result.get();
+        for(auto& category: categorizer->categoryMap) // loop through each category
         {
             // category.first is the category name, category.second is the Category object
             if(category.second.hide) continue;
             for(auto& h: category.second.histoMap) // loop through each histogram in the category
             {
+                // merge the chunks of a sample into the histogram from the first chunk
+                std::map<TString, TH1D*>& histoMap = cAll->categoryMap[category.first].histoMap;
+                if(histoMap.count(h.first) > 0)
+                {
+                    histoMap[h.first]->Add(h.second);
+                    delete h.second;
+                    continue;
+                }
+
                 cAll->categoryMap[category.first].histoMap[h.first] = h.second;
                 cAll->categoryMap[category.first].histoList->Add(h.second);
 
@@ -406,6 +413,7 @@ Categorizer* getHistos(TString xmlfile, int nthreads, float reductionFactor, flo
                 else                              cAll->categoryMap[category.first].bkgList->Add(h.second);
             }
         }
+        delete categorizer;
     }
 
     return cAll;
@@ -417,6 +425,9 @@ Categorizer* getHistos(TString xmlfile, int nthreads, float reductionFactor, flo
 
 int main(int argc, char* argv[])
 {
+    // the sample chunks open their files in the worker threads
+    ROOT::EnableThreadSafety();
+
     // save the errors for the histogram correctly so they depend upon 
     // the number used to fill originally rather than the scaling
     TH1::SetDefaultSumw2();
@@ -427,6 +438,7 @@ int main(int argc, char* argv[])
     float luminosity = 36814;      // pb-1
     //TString whichDY = "dyAMC";
     TString whichDY = "dyAMC-J";
+    Long64_t chunkSize = 1000000;  // max entries per task
 
     for(int i=1; i<argc; i++)
     {   
@@ -434,6 +446,7 @@ int main(int argc, char* argv[])
         ss << argv[i];
         if(i==1) xmlfile = ss.str().c_str();
         if(i==2) ss >> nthreads;
+        if(i==3) ss >> chunkSize;
     }   
 
     TStopwatch timerWatch;
@@ -443,7 +456,7 @@ int main(int argc, char* argv[])
     // Categorize Events, Make Histograms -----------------------------
     ///////////////////////////////////////////////////////////////////
 
-    Categorizer* cAll = getHistos(xmlfile, nthreads, reductionFactor, luminosity, whichDY);
+    Categorizer* cAll = getHistos(xmlfile, nthreads, reductionFactor, luminosity, whichDY, chunkSize);
 
     ///////////////////////////////////////////////////////////////////
     // Make Tables, Save Histos ---------------------------------------
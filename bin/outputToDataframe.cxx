@@ -23,12 +23,15 @@
 #include "TMVATools.h"
 #include "PUTools.h"
 #include "ThreadPool.hxx"
+#include "DataframeWriter.h"
 
 #include "TLorentzVector.h"
 #include "TSystem.h"
 #include "TNtuple.h"
+#include "TFileMerger.h"
 #include "TRandom3.h"
 #include <sstream>
+#include <fstream>
 #include <map>
 #include <vector>
 #include <utility>
@@ -56,6 +59,9 @@ int main(int argc, char* argv[])
     TH1::SetDefaultSumw2();
     int nthreads = 10;
 
+    // the sample chunks open their files in the worker threads
+    ROOT::EnableThreadSafety();
+
     for(int i=1; i<argc; i++)
     {   
         std::stringstream ss; 
@@ -76,6 +82,8 @@ int main(int argc, char* argv[])
 
     float reductionFactor = 1;
     float luminosity = 36814;      // pb-1
+    Long64_t chunkSize = 1000000;  // max entries per task, the big samples are split into several tasks
+    bool writeNtuple = true;       // also write the flat ntuples in rootfiles/bdt/ for the autocategorizer
 
     TString whichDY = "dyAMC-J";
     //TString whichDY = "dyMG";
@@ -108,7 +116,7 @@ int main(int argc, char* argv[])
         std::cout << "    nOriginalWeighted: " << i.second->nOriginalWeighted << std::endl;
         std::cout << std::endl;
 
-        i.second->setBranchAddresses("");
+        // the readers for each chunk set their own branch addresses
         samplevec.push_back(i.second);
     }
 
@@ -119,10 +127,16 @@ int main(int argc, char* argv[])
     std::cout << "@@@ nCPUs used     : " << nthreads << std::endl;
     std::cout << "@@@ nSamples used  : " << samplevec.size() << std::endl;
 
-    auto outputSampleInfo = [whichDY, luminosity, reductionFactor](Sample* s)
+    gSystem->mkdir("csv/bdtcsv", true);
+    gSystem->mkdir("dataframes/bdt", true);
+    if(writeNtuple) gSystem->mkdir("rootfiles/bdt", true);
+
+    // process entries [first, last) of the sample, s is a reader made for this chunk alone
+    // each chunk writes its own csv, ColumnFile, and ntuple, the chunks are put back together in order at the end
+    auto outputSampleInfo = [whichDY, luminosity, writeNtuple](Sample* s, Long64_t first, Long64_t last, int ichunk)
     {
       // Output some info about the current file
-      std::cout << Form("  /// Processing %s \n", s->name.Data());
+      std::cout << Form("  /// Processing %s entries %lld to %lld \n", s->name.Data(), first, last);
 
       TString dir    = "classification/";
       //TString methodName = "BDTG_default";
@@ -143,13 +157,8 @@ int main(int argc, char* argv[])
       /////////////////////////////////////////////////////
       // Book training and spectator vars into reader
 
-      std::map<TString, Float_t> tmap;
-      std::map<TString, Float_t> smap;
-      TMVA::Reader* reader = TMVATools::bookVars(methodName, weightfile, tmap, smap);
-
-      //std::map<TString, Float_t> tmap_multi;
-      //std::map<TString, Float_t> smap_multi;
-      //TMVA::Reader* reader_multi = TMVATools::bookVars(methodName, weightfile_multi, tmap_multi, smap_multi);
+      TMVAEvaluator evaluator(methodName, weightfile, s->vars);
+      //TMVAEvaluator evaluator_multi(methodName, weightfile_multi, s->vars);
 
       bool isData = s->sampleType == "data";
       bool isSignal = s->sampleType == "signal";
@@ -166,28 +175,30 @@ int main(int argc, char* argv[])
       //tfile->cd();
       //TNtuple* ntuple = new TNtuple("theNtuple", "theNtuple");
 
-      std::map<TString, double> vars;
-      vars["bin"] = -999;
-      vars["is_signal"] = -999;
-      vars["weight"] = -999;
-
-      // loop through all features in the varset (Sample->vars)
-      // and initialize values
-      for(auto& item: s->vars.varMap)
-          vars[item.first.c_str()] = -999;
-
-      for(auto& item: s->vars.varMapI)
-          vars[item.first.c_str()] = -999;
-
-      // !!!! output first line of csv to file
-      std::ofstream file(Form("csv/bdtcsv/%s_bdt_training_%s.csv", s->name.Data(), whichDY.Data()), std::ofstream::out);
-      file << EventTools::outputMapKeysCSV(vars).Data() << std::endl;
-
-      // ntuple requires list of variables to be separated by ":" rather than ","
-      TString ntuplevars = EventTools::outputMapKeysCSV(vars).ReplaceAll(",", ":");
-      //std::cout << Form("\n   /// Vars to be saved in ntuple \n\n");
-      //std::cout << Form("%s\n", ntuplevars.Data());
-      TNtuple* ntuple = new TNtuple(s->name.Data(), s->name.Data(), ntuplevars.Data());
+      // every feature in the varset (Sample->vars) plus these, the columns are resolved once here.
+      // each chunk streams its rows to its own csv and ColumnFile, the csv chunks are put back together at the end
+      TString chunkname = Form("%s_bdt_training_%s_chunk%d", s->name.Data(), whichDY.Data(), ichunk);
+      DataframeWriter dataframe("csv/bdtcsv/"+chunkname+".csv", "dataframes/bdt/"+chunkname+".col", s,
+                                {"bin", "is_signal", "weight"}, ichunk == 0);
+      int ibin = dataframe.getColumn("bin");
+      int iis_signal = dataframe.getColumn("is_signal");
+      int iweight = dataframe.getColumn("weight");
+
+      // the same for every event in the chunk
+      double lumiScaleFactor = isData?1:s->getLumiScaleFactor(luminosity);
+      dataframe.set(iis_signal, isData?-1:(s->sampleType.Contains("signal")?1:0));
+
+      // ntuple requires list of variables to be separated by ":" rather than ",".
+      // it goes straight into its own file so the baskets are written out as it fills
+      TFile* tfile = 0;
+      TNtuple* ntuple = 0;
+      std::vector<Float_t> varvalues(dataframe.getColumnNames().size());
+      if(writeNtuple)
+      {
+          tfile = new TFile("rootfiles/bdt/"+chunkname+".root", "RECREATE");
+          tfile->cd();
+          ntuple = new TNtuple("theNtuple", "theNtuple", dataframe.getHeader(":"));
+      }
 
       // Objects to help with the cuts and selections
       JetCollectionCleaner      jetCollectionCleaner;
@@ -199,7 +210,7 @@ int main(int argc, char* argv[])
 
       Categorizer* categorySelection = new CategorySelectionRun1();
 
-      for(unsigned int i=0; i<s->N/reductionFactor; i++)
+      for(Long64_t i=first; i<last; i++)
       {
 
         // We are stitching together zjets_ht from 70-inf. We use the inclusive for
@@ -266,12 +277,8 @@ int main(int argc, char* argv[])
               continue; 
           }
 
-          // avoid double counting in RunF
-          if(s->name == "RunF_1" && s->vars.eventInfo->run > 278801)
-          {
-              continue;
-          }
-          if(s->name == "RunF_2" && s->vars.eventInfo->run < 278802)
+          // the duplicate data events and the ones outside the sample's runs, see EventVeto
+          if(s->isVetoed(i))
           {
               continue;
           }
@@ -314,21 +321,19 @@ int main(int argc, char* argv[])
           }
 
           // nonfeature variables
-          vars["bin"] = bin;
-          if(isData) vars["is_signal"] = -1;
-          else vars["is_signal"] = s->sampleType.Contains("signal")?1:0;
-          if(isData) vars["weight"] = 1;
-          else vars["weight"] = s->getLumiScaleFactor(luminosity)*s->getWeight();
+          dataframe.set(ibin, bin);
+          double weight = isData?1:lumiScaleFactor*s->getWeight();
 
           // only using half of the signal events. need to boost the weight to get the correct estimate
           // of the expected signal
-          if(isSignal) vars["weight"] = vars["weight"]*2;
+          if(isSignal) weight = weight*2;
+          dataframe.set(iweight, weight);
 
           // set tmva's bdt_score
-          s->vars.bdt_out = TMVATools::getClassifierScore(reader, methodName, tmap, s->vars);
+          s->vars.bdt_out = evaluator.getClassifierScore(s->vars);
 
           // load multi results into varset
-          //std::vector<float> bdt_multi_scores = TMVATools::getMulticlassScores(reader_multi, methodName, tmap_multi, s->vars);
+          //const std::vector<float>& bdt_multi_scores = evaluator_multi.getMulticlassScores(s->vars);
           //s->vars.bdt_ggh_out = bdt_multi_scores[0];
           //s->vars.bdt_vbf_out = bdt_multi_scores[1];
           //s->vars.bdt_vh_out  = bdt_multi_scores[2];
@@ -345,74 +350,83 @@ int main(int argc, char* argv[])
           //s->vars.setJets();    // jets sorted and paired by mjj, turn this off to simply take the leading two jets
           s->vars.setVBFjets();   // jets sorted and paired by vbf criteria
 
-          // put the actual value for each feature into our map
-          // then output the map to CSV later
-          for(auto& item: s->vars.varMap)
-          {
-              // item.first is the name of the feature
-              //std::cout << item.first.c_str() << std::endl;
-              vars[item.first.c_str()] = s->vars.getValue(item.first);
-          }
-          for(auto& item: s->vars.varMapI)
-          {
-              // item.first is the name of the feature
-              //std::cout << item.first.c_str() << std::endl;
-              vars[item.first.c_str()] = s->vars.getValue(item.first);
-          }
-
           if(false)
             EventTools::outputEvent(s->vars, (*categorySelection));
 
-          // !!!! output event info to file
-          file << EventTools::outputMapValuesCSV(vars).Data() << std::endl;
+          // !!!! output event info to file, the writer gets each feature from s->vars
+          dataframe.fill();
 
-          std::vector<Float_t> varvalues;
-          //std::cout << Form("\n   /// Vars to be saved \n\n");
-          for(auto& item: vars)
+          // fill the ntuple
+          if(ntuple != 0)
           {
-              //std::cout << Form("%s: %f\n", item.first.Data(), item.second);
-              varvalues.push_back((Float_t)item.second);
+              const std::vector<double>& row = dataframe.getRow();
+              for(unsigned int v=0; v<row.size(); v++)
+                  varvalues[v] = row[v];
+              ntuple->Fill(&varvalues[0]);
           }
 
-          // fill the ntuple
-          ntuple->Fill(&varvalues[0]);
-
           if(found_good_dimuon) break; // only fill one dimuon, break from dimu cand loop
 
         } // end dimucand loop
       } // end event loop
-      delete reader;
-      //delete reader_multi;
-      file.close();
-
-      std::cout << Form("  /// Done processing %s \n", s->name.Data());
-      return ntuple;
+      evaluator.timing.output();
+      dataframe.close();
+      if(tfile != 0)
+      {
+          tfile->cd();
+          ntuple->Write();
+          tfile->Close();
+          delete tfile;
+      }
+
+      std::cout << Form("  /// Done processing %s entries %lld to %lld, %llu rows \n", s->name.Data(), first, last, dataframe.nRows);
+      delete s;
+      return dataframe.nRows;
     }; // end sample lambda function
 
     ThreadPool pool(nthreads);
-    std::vector< std::future<TNtuple*> > results;
+    std::vector< std::future<unsigned long long> > results;
+    std::vector<int> nchunks;
 
     for(auto& s: samplevec)
-        results.push_back(pool.enqueue(outputSampleInfo, s));
-
-    std::vector<TNtuple*> ntuples;
-    for(auto && result: results)  // get each ntuple and save it to a tfile
     {
-        TNtuple* ntuple = result.get();
-        ntuples.push_back(ntuple);
+        std::vector< std::pair<Long64_t, Long64_t> > ranges = s->getEntryRanges(chunkSize, s->N/reductionFactor);
+        for(unsigned int r=0; r<ranges.size(); r++)
+            results.push_back(pool.enqueue(outputSampleInfo, s->makeReader(""), ranges[r].first, ranges[r].second, (int)r));
+        nchunks.push_back(ranges.size());
     }
 
-    for(auto& ntuple: ntuples)
+    // the results are in sample order then chunk order
+    unsigned int iresult = 0;
+    for(unsigned int isample=0; isample<samplevec.size(); isample++)
     {
-        TString sname = ntuple->GetName();
-        ntuple->SetName("theNtuple");
-        ntuple->SetTitle("theNtuple");
-        TString filename = Form("rootfiles/bdt/%s_bdt_training_%s.root", sname.Data(), whichDY.Data());
-        std::cout << Form("  /// Writing ntuple to %s \n", filename.Data());
-        TFile* tfile = new TFile(filename,"RECREATE");
-        tfile->cd();
-        ntuple->Write();
-        tfile->Write();
-        tfile->Close();
+        TString sname = samplevec[isample]->name;
+        unsigned long long nrows = 0;
+
+        // glue the csv chunks together, the binary ColumnFiles stay one per chunk like the categorize skims
+        TString basename = Form("%s_bdt_training_%s", sname.Data(), whichDY.Data());
+        std::ofstream csv("csv/bdtcsv/"+basename+".csv", std::ofstream::out);
+        TFileMerger merger(false);
+        if(writeNtuple) merger.OutputFile("rootfiles/bdt/"+basename+".root", "RECREATE");
+        for(int c=0; c<nchunks[isample]; c++)
+        {
+            nrows += results[iresult++].get();
+            TString chunkname = basename+Form("_chunk%d", c);
+            std::ifstream chunk(("csv/bdtcsv/"+chunkname+".csv").Data());
+            csv << chunk.rdbuf();
+            chunk.close();
+            gSystem->Unlink("csv/bdtcsv/"+chunkname+".csv");
+            if(writeNtuple) merger.AddFile("rootfiles/bdt/"+chunkname+".root", false);
+        }
+        csv.close();
+        std::cout << Form("  /// %s: %llu rows in %d chunks \n", sname.Data(), nrows, nchunks[isample]);
+        if(!writeNtuple || nchunks[isample] == 0) continue;
+
+        // merge the chunks into one ntuple in the output file, the baskets are copied without unzipping them
+        std::cout << Form("  /// Writing ntuple to rootfiles/bdt/%s.root \n", basename.Data());
+        merger.SetFastMethod(true);
+        merger.Merge();
+        for(int c=0; c<nchunks[isample]; c++)
+            gSystem->Unlink("rootfiles/bdt/"+basename+Form("_chunk%d.root", c));
     }
 }
@@ -61,12 +61,16 @@ int main(int argc, char* argv[])
     TH1::SetDefaultSumw2();
 
     int nthreads = 1;        // number of threads to use in parallelization
+    TString otherGroup = ""; // compare our events to the other group's in csv/synchcsv/<otherGroup>/, "" to skip
+    TString eventList = "";  // only look at the events in this csv of run, event
 
     for(int i=1; i<argc; i++)
     {   
         std::stringstream ss; 
         ss << argv[i];
         if(i==1) ss >> nthreads;
+        if(i==2) otherGroup = argv[i];
+        if(i==3) eventList = argv[i];
     }   
     // Not sure that we need a map if we have a vector
     // Should use this as the main database and choose from it to make the vector
@@ -139,7 +143,7 @@ int main(int argc, char* argv[])
     // Define Task for Parallelization -------------------------------
     ///////////////////////////////////////////////////////////////////
 
-    auto synchSample = [reductionFactor](Sample* s)
+    auto synchSample = [reductionFactor, eventList](Sample* s)
     {
       // set the muon calibration type for synchronization
       TString pf_roch_or_kamu = "PF";
@@ -150,18 +154,25 @@ int main(int argc, char* argv[])
       TString methodName = "BDTG_UF_v1";
       TString weightfile = dir+"f_Opt_v1_all_sig_all_bkg_ge0j_BDTG_UF_v1.weights.xml";
 
-      TMVA::Reader* reader = 0; 
-      std::map<TString, Float_t> tmap;
-      std::map<TString, Float_t> smap;
-      reader = TMVATools::bookVars(methodName, weightfile, tmap, smap);
+      TMVAEvaluator evaluator(methodName, weightfile, s->vars);
 
-      std::vector<std::pair<int,long long int>> eventsToCheck;
-      //loadEventsFromFile("synchcsv/xCheck.txt", eventsToCheck);
+      EventSet eventsToCheck;
+      //EventTools::loadEventsFromFile("synchcsv/xCheck.txt", eventsToCheck);
 
-      //eventsToCheck.push_back(std::pair<int, long long int>(1, 212289));
-      //eventsToCheck.push_back(std::pair<int, long long int>(1, 215743));
-      //eventsToCheck.push_back(std::pair<int, long long int>(1, 232626));
-      //eventsToCheck.push_back(std::pair<int, long long int>(1, 241209));
+      //eventsToCheck.insert(1, 212289);
+      //eventsToCheck.insert(1, 215743);
+      //eventsToCheck.insert(1, 232626);
+      //eventsToCheck.insert(1, 241209);
+
+      // with a list we only visit the entries of the listed events
+      std::vector<Long64_t> entries;
+      if(eventList != "")
+      {
+          EventTools::loadEventsFromFile(eventList, eventsToCheck);
+          entries = s->getEntries(eventsToCheck);
+          std::cout << Form("  /// %s has %d of the %d events in %s \n", s->name.Data(), (int)entries.size(), 
+                            eventsToCheck.size(), eventList.Data());
+      }
 
       ///////////////////////////////////////////////////////////////////
       // INIT Cuts and Categories ---------------------------------------
@@ -203,7 +214,7 @@ int main(int argc, char* argv[])
           c.second.histoMap[hkey]->GetXaxis()->SetTitle("count");
           c.second.histoList->Add(c.second.histoMap[hkey]);
 
-          c.second.eventsMap[hkey] = std::vector< std::pair<int, long long int> >();
+          c.second.eventsMap[hkey] = EventSet();
       }
 
 
@@ -211,8 +222,11 @@ int main(int argc, char* argv[])
       // LOOP OVER EVENTS -----------------------------------------------
       ///////////////////////////////////////////////////////////////////
 
-      for(unsigned int i=0; i<s->N/reductionFactor; i++)
+      Long64_t nentries = (eventList != "")?(Long64_t)entries.size():(Long64_t)(s->N/reductionFactor);
+      for(Long64_t n=0; n<nentries; n++)
       {
+        Long64_t i = (eventList != "")?entries[n]:n;
+
         // only load essential information for the first set of cuts 
         s->branches.muPairs->GetEntry(i);
         s->branches.muons->GetEntry(i);
@@ -258,9 +272,9 @@ int main(int argc, char* argv[])
           //CollectionCleaner::cleanByDR(s->vars.validElectrons, s->vars.validMuons, 0.4);
           //CollectionCleaner::cleanByDR(s->vars.validJets, s->vars.validElectrons, 0.4);
           
-          s->vars.bdt_out = TMVATools::getClassifierScore(reader, methodName, tmap, s->vars); // set tmva's bdt score
+          s->vars.bdt_out = evaluator.getClassifierScore(s->vars); // set tmva's bdt score
           
-          if(EventTools::eventInVector(e, eventsToCheck) || true) // Adrian gave a list of events to look at for synch purposes
+          if(eventsToCheck.contains(e) || true) // Adrian gave a list of events to look at for synch purposes
              EventTools::outputEvent(s->vars);
 
           ///////////////////////////////////////////////////////////////////
@@ -269,32 +283,28 @@ int main(int argc, char* argv[])
 
           if(!synchMuonSelection.evaluate(s->vars)) 
           {
-              if(EventTools::eventInVector(e, eventsToCheck) || true)
+              if(eventsToCheck.contains(e) || true)
                   std::cout << "   !!! Fail Muon Selection !!!" << std::endl;
 
               continue; 
           }
           if(!synchEventSelection.evaluate(s->vars))
           { 
-              if(EventTools::eventInVector(e, eventsToCheck) || true)
+              if(eventsToCheck.contains(e) || true)
                   std::cout << "   !!! Fail Event Selection !!!" << std::endl;
 
               continue; 
           }
           if(!mu1.isMediumID || !mu2.isMediumID)
           { 
-              if(EventTools::eventInVector(e, eventsToCheck) || true)
+              if(eventsToCheck.contains(e) || true)
                   std::cout << "   !!! Fail Medium ID !!!" << std::endl;
 
               continue; 
           }
 
-          // avoid double counting in RunF
-          if(s->name == "RunF_1" && s->vars.eventInfo->run > 278801)
-          {
-              continue;
-          }
-          if(s->name == "RunF_2" && s->vars.eventInfo->run < 278802)
+          // the duplicate data events and the ones outside the sample's runs, see EventVeto
+          if(s->isVetoed(i))
           {
               continue;
           }
@@ -315,10 +325,10 @@ int main(int argc, char* argv[])
               if(!c.second.inCategory) continue;
 
               c.second.histoMap[hkey]->Fill(1, 1);
-              c.second.eventsMap[hkey].push_back(e);
+              c.second.eventsMap[hkey].insert(e.first, e.second, s->vars.eventInfo->lumi);
           } // end category loop
 
-          if(EventTools::eventInVector(e, eventsToCheck) || true)
+          if(eventsToCheck.contains(e) || true)
             categorySelection->outputResults();
 
           if(found_good_dimuon) break; // only fill one dimuon, break from dimu cand loop
@@ -370,8 +380,22 @@ int main(int argc, char* argv[])
             }
             for(auto& v: category.second.eventsMap)
             {
-                TString filename = "csv/synchcsv/"+v.first+"_"+category.second.name+".csv";
-                EventTools::outputEventsToFile(v.second, filename);
+                TString basename = "csv/synchcsv/"+v.first+"_"+category.second.name;
+                EventTools::outputEventsToFile(v.second, basename+".csv");
+
+                // the events only one of the groups has in the category
+                if(otherGroup != "")
+                {
+                    EventSet theirs;
+                    EventTools::loadEventsFromFile("csv/synchcsv/"+otherGroup+"/"+v.first+"_"+category.second.name+".csv", theirs);
+                    EventSet onlyOurs = v.second.difference(theirs);
+                    EventSet onlyTheirs = theirs.difference(v.second);
+                    std::cout << Form("  %s %s: UF %d, %s %d, both %d, only UF %d, only %s %d \n", v.first.Data(), category.second.name.Data(),
+                                      v.second.size(), otherGroup.Data(), theirs.size(), v.second.intersection(theirs).size(), 
+                                      onlyOurs.size(), otherGroup.Data(), onlyTheirs.size());
+                    EventTools::outputEventsToFile(onlyOurs, basename+"_not_in_"+otherGroup+".csv");
+                    EventTools::outputEventsToFile(onlyTheirs, basename+"_only_in_"+otherGroup+".csv");
+                }
                 v.second.clear();
             }
         }
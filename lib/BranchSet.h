@@ -3,6 +3,9 @@
 // BranchSet.h                                                           //
 // ======================================================================//
 // Link TTree info to objects in VarSet.h                                //
+// Only the branches turned on in the active mask are read, VarSet,      //
+// the categorizers, and TMVATools declare which branches they need.     //
+// Keeps track of the bytes read from each branch.                       //
 // ======================================================================//
 ///////////////////////////////////////////////////////////////////////////
 
@@ -10,6 +13,9 @@
 #define ADD_BRANCHSET
 
 #include "TBranch.h"
+#include "TString.h"
+
+#include <iostream>
 
 class BranchSet
 {
@@ -17,6 +23,40 @@ class BranchSet
         BranchSet(){};
         ~BranchSet(){};
 
+        // one id per branch, used as the bit position in a Mask
+        enum BranchId { kNVertices, kNJets, kNJetsCent, kNJetsFwd, kNBLoose, kNBMed, kNBTight,
+                        kEventInfo, kMht, kMet,
+                        kMuons, kMuPairs, kElectrons, kJets, kJetPairs,
+                        kEffWgt, kPuWgt, kPuWgtUp, kPuWgtDown, kNPU, kGenWgt, kLheHt,
+                        kIsoMuSF3, kIsoMuSF4, kMuIDSF3, kMuIDSF4, kMuIsoSF3, kMuIsoSF4,
+                        kGenParents, kGenMuons, kGenDimuons,
+                        kNBranches };
+
+        typedef unsigned long long Mask;
+        static constexpr Mask bit(int id) { return 1ULL << id; };
+
+        static constexpr Mask kAllBranches = ~0ULL;
+
+        // what the dimuon selection looks at
+        static constexpr Mask kSelectionBranches = (1ULL << kMuons) | (1ULL << kMuPairs) | (1ULL << kEventInfo);
+
+        // what goes into the cleaned collections, validJets etc.
+        static constexpr Mask kCleaningBranches = (1ULL << kMuons) | (1ULL << kMuPairs) | (1ULL << kJets) | (1ULL << kElectrons);
+
+        // what Sample::getWeight uses for MC
+        static constexpr Mask kWeightBranches = (1ULL << kPuWgt) | (1ULL << kPuWgtUp) | (1ULL << kPuWgtDown) | (1ULL << kNPU) | (1ULL << kGenWgt) |
+                                                (1ULL << kIsoMuSF3) | (1ULL << kIsoMuSF4) | (1ULL << kMuIDSF3) | (1ULL << kMuIDSF4) |
+                                                (1ULL << kMuIsoSF3) | (1ULL << kMuIsoSF4);
+
+        // the branches that getEntry reads, everything by default
+        Mask active = kAllBranches;
+
+        // bytes read from each branch so far
+        Long64_t bytesRead[kNBranches] = {};
+
+        // counts the loads of the weight branches, Sample::getWeight recomputes the weights when it changes
+        unsigned long long weightLoads = 0;
+
         TBranch* nVertices = 0;
         TBranch* nJets     = 0;
         TBranch* nJetsCent = 0;
@@ -36,102 +76,123 @@ class BranchSet
 
         TBranch* eff_wgt = 0;
         TBranch* pu_wgt  = 0;
+        TBranch* pu_wgt_up   = 0;  // only linked when the systematics share one event loop
+        TBranch* pu_wgt_down = 0;
         TBranch* nPU     = 0;
         TBranch* gen_wgt = 0;
         TBranch* lhe_ht  = 0;
 
         TBranch* isoMu_SF_3 = 0;
-        TBranch* isoMu_SF_4 = 0; 
-        TBranch* muID_SF_3  = 0; 
-        TBranch* muID_SF_4  = 0; 
-        TBranch* muIso_SF_3 = 0; 
-        TBranch* muIso_SF_4 = 0; 
+        TBranch* isoMu_SF_4 = 0;
+        TBranch* muID_SF_3  = 0;
+        TBranch* muID_SF_4  = 0;
+        TBranch* muIso_SF_3 = 0;
+        TBranch* muIso_SF_4 = 0;
 
         TBranch* genParents = 0;
         TBranch* genMuons   = 0;
         TBranch* genDimuons = 0;
 
-        void getEntry(int i)
+        TBranch* branch(int id)
         {
-            if(nVertices != 0) nVertices->GetEntry(i);
-            if(nJets     != 0) nJets->GetEntry(i);
-            if(nJetsCent != 0) nJetsCent->GetEntry(i);
-            if(nJetsFwd  != 0) nJetsFwd->GetEntry(i);
-            if(nBLoose   != 0) nBLoose->GetEntry(i);
-            if(nBMed     != 0) nBMed->GetEntry(i);
-            if(nBTight   != 0) nBTight->GetEntry(i);
-            if(eventInfo != 0) eventInfo->GetEntry(i);
-            if(mht != 0) mht->GetEntry(i);
-            if(met != 0) met->GetEntry(i);
-
-            if(muons     != 0) muons->GetEntry(i);
-            if(muPairs   != 0) muPairs->GetEntry(i);
-            if(electrons != 0) electrons->GetEntry(i);
-            if(jets      != 0) jets->GetEntry(i);
-            if(jetPairs  != 0) jetPairs->GetEntry(i);
-
-            if(eff_wgt != 0) eff_wgt->GetEntry(i);
-            if(pu_wgt  != 0) pu_wgt->GetEntry(i);
-            if(nPU     != 0) nPU->GetEntry(i);
-            if(gen_wgt != 0) gen_wgt->GetEntry(i);
-            if(lhe_ht  != 0) lhe_ht->GetEntry(i);
-
-            if(isoMu_SF_3 != 0) isoMu_SF_3->GetEntry(i);
-            if(isoMu_SF_4 != 0) isoMu_SF_4->GetEntry(i);
-            if(muID_SF_3  != 0)  muID_SF_3->GetEntry(i);
-            if(muID_SF_4  != 0)  muID_SF_4->GetEntry(i);
-            if(muIso_SF_3 != 0) muIso_SF_3->GetEntry(i);
-            if(muIso_SF_4 != 0) muIso_SF_4->GetEntry(i);
-
-            if(genParents != 0) genParents->GetEntry(i);
-            if(genMuons   != 0) genMuons->GetEntry(i);
-            if(genDimuons != 0) genDimuons->GetEntry(i);
+            switch(id)
+            {
+                case kNVertices:  return nVertices;
+                case kNJets:      return nJets;
+                case kNJetsCent:  return nJetsCent;
+                case kNJetsFwd:   return nJetsFwd;
+                case kNBLoose:    return nBLoose;
+                case kNBMed:      return nBMed;
+                case kNBTight:    return nBTight;
+                case kEventInfo:  return eventInfo;
+                case kMht:        return mht;
+                case kMet:        return met;
+                case kMuons:      return muons;
+                case kMuPairs:    return muPairs;
+                case kElectrons:  return electrons;
+                case kJets:       return jets;
+                case kJetPairs:   return jetPairs;
+                case kEffWgt:     return eff_wgt;
+                case kPuWgt:      return pu_wgt;
+                case kPuWgtUp:    return pu_wgt_up;
+                case kPuWgtDown:  return pu_wgt_down;
+                case kNPU:        return nPU;
+                case kGenWgt:     return gen_wgt;
+                case kLheHt:      return lhe_ht;
+                case kIsoMuSF3:   return isoMu_SF_3;
+                case kIsoMuSF4:   return isoMu_SF_4;
+                case kMuIDSF3:    return muID_SF_3;
+                case kMuIDSF4:    return muID_SF_4;
+                case kMuIsoSF3:   return muIso_SF_3;
+                case kMuIsoSF4:   return muIso_SF_4;
+                case kGenParents: return genParents;
+                case kGenMuons:   return genMuons;
+                case kGenDimuons: return genDimuons;
+            }
+            return 0;
         }
 
-        void getEntryReco(int i)
+        static TString branchName(int id)
         {
-            if(nVertices != 0) nVertices->GetEntry(i);
-            if(nJets     != 0) nJets->GetEntry(i);
-            if(nJetsCent != 0) nJetsCent->GetEntry(i);
-            if(nJetsFwd  != 0) nJetsFwd->GetEntry(i);
-            if(nBLoose   != 0) nBLoose->GetEntry(i);
-            if(nBMed     != 0) nBMed->GetEntry(i);
-            if(nBTight   != 0) nBTight->GetEntry(i);
-            if(eventInfo != 0) eventInfo->GetEntry(i);
-            if(mht != 0) mht->GetEntry(i);
-            if(met != 0) met->GetEntry(i);
-
-            if(muons     != 0) muons->GetEntry(i);
-            if(muPairs   != 0) muPairs->GetEntry(i);
-            if(electrons != 0) electrons->GetEntry(i);
-            if(jets      != 0) jets->GetEntry(i);
-            if(jetPairs  != 0) jetPairs->GetEntry(i);
+            static const char* names[kNBranches] = { "nVertices", "nJets", "nJetsCent", "nJetsFwd", "nBLoose", "nBMed", "nBTight",
+                                                     "event", "mht", "met",
+                                                     "muons", "muPairs", "eles", "jets", "jetPairs",
+                                                     "IsoMu_eff_3", "PU_wgt", "PU_wgt_up", "PU_wgt_down", "nPU", "GEN_wgt", "LHE_HT",
+                                                     "IsoMu_SF_3", "IsoMu_SF_4", "MuID_SF_3", "MuID_SF_4", "MuIso_SF_3", "MuIso_SF_4",
+                                                     "genParents", "genMuons", "genMuPairs" };
+            if(id < 0 || id >= kNBranches) return "";
+            return names[id];
         }
 
-        void getEntryGenHT(int i)
+        // load the ith event for one branch if it is linked and active
+        void getEntry(int id, int i)
         {
-            if(lhe_ht  != 0) lhe_ht->GetEntry(i);
+            TBranch* b = branch(id);
+            if(b != 0 && (active & bit(id))) bytesRead[id] += b->GetEntry(i);
+            if(bit(id) & kWeightBranches) weightLoads++;
         }
 
-        void getEntryGenCollections(int i)
+        // load the ith event for all the active branches in [first, last]
+        void getEntryRange(int first, int last, int i)
         {
-            if(genParents != 0) genParents->GetEntry(i);
-            if(genMuons   != 0) genMuons->GetEntry(i);
-            if(genDimuons != 0) genDimuons->GetEntry(i);
+            for(int id=first; id<=last; id++)
+                getEntry(id, i);
         }
 
+        void getEntry(int i)              { getEntryRange(kNVertices, kGenDimuons, i); }
+        void getEntryReco(int i)          { getEntryRange(kNVertices, kJetPairs, i);   }
+        void getEntryGenHT(int i)         { getEntry(kLheHt, i);                       }
+        void getEntryGenCollections(int i){ getEntryRange(kGenParents, kGenDimuons, i);}
+
         void getEntryWeightsMC(int i)
         {
-            if(eff_wgt != 0) eff_wgt->GetEntry(i);
-            if(pu_wgt  != 0) pu_wgt->GetEntry(i);
-            if(gen_wgt != 0) gen_wgt->GetEntry(i);
-
-            if(isoMu_SF_3 != 0) isoMu_SF_3->GetEntry(i);
-            if(isoMu_SF_4 != 0) isoMu_SF_4->GetEntry(i);
-            if(muID_SF_3  != 0)  muID_SF_3->GetEntry(i);
-            if(muID_SF_4  != 0)  muID_SF_4->GetEntry(i);
-            if(muIso_SF_3 != 0) muIso_SF_3->GetEntry(i);
-            if(muIso_SF_4 != 0) muIso_SF_4->GetEntry(i);
+            getEntryRange(kEffWgt, kPuWgtDown, i);
+            getEntry(kGenWgt, i);
+            getEntryRange(kIsoMuSF3, kMuIsoSF4, i);
+        }
+
+        // add up the bytes read by several readers of the same sample
+        void addBytesRead(const BranchSet& other)
+        {
+            for(int id=0; id<kNBranches; id++)
+                bytesRead[id] += other.bytesRead[id];
+        }
+
+        void outputBytesRead()
+        {
+            Long64_t total = 0;
+            for(int id=0; id<kNBranches; id++)
+                total += bytesRead[id];
+
+            std::cout << std::endl;
+            std::cout << "======== Bytes Read Per Branch ========" << std::endl;
+            for(int id=0; id<kNBranches; id++)
+            {
+                if(bytesRead[id] == 0) continue;
+                std::cout << Form("  %-12s: %10.2f MB (%5.1f%%)", branchName(id).Data(), bytesRead[id]/1e6, 100.0*bytesRead[id]/total) << std::endl;
+            }
+            std::cout << Form("  %-12s: %10.2f MB", "total", total/1e6) << std::endl;
+            std::cout << std::endl;
         }
 };
 
@@ -0,0 +1,327 @@
+///////////////////////////////////////////////////////////////////////////
+// ======================================================================//
+// ColumnFile.cxx                                                        //
+// ======================================================================//
+// Compact columnar file for the skimmed events. Each column is a flat   //
+// array of floats, doubles, long longs, or bytes stored in row groups.  //
+// The writer buffers one row group per column and flushes it to disk.   //
+// The reader memory maps the file and hands out raw column pointers,    //
+// so only the pages for the columns we actually use are ever read.      //
+// ======================================================================//
+///////////////////////////////////////////////////////////////////////////
+
+// file layout
+//   "UFCOLS01"
+//   row group 0: column 0 data, column 1 data, ... (each padded to 8 bytes)
+//   row group 1: ...
+//   footer: ncols, (type, name) per column, ngroups, (nrows, offset per column) per group,
+//           nmetadata, (key, value) per entry
+//   footer offset (8 bytes), "UFCOLS01"
+
+///////////////////////////////////////////////////////////////////////////
+// _______________________Includes_______________________________________//
+///////////////////////////////////////////////////////////////////////////
+
+#include "ColumnFile.h"
+
+#include <iostream>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+static const char COLUMNFILE_MAGIC[9] = "UFCOLS01";
+
+///////////////////////////////////////////////////////////////////////////
+// _______________________ColumnFileWriter_______________________________//
+///////////////////////////////////////////////////////////////////////////
+
+ColumnFileWriter::ColumnFileWriter(TString ifilename, unsigned int irowsPerGroup)
+{
+    filename = ifilename;
+    rowsPerGroup = irowsPerGroup;
+
+    file = fopen(filename.Data(), "wb");
+    if(file == 0)
+    {
+        std::cout << Form("  !!! ColumnFileWriter could not open %s for writing \n", filename.Data());
+        return;
+    }
+    write(COLUMNFILE_MAGIC, 8);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+ColumnFileWriter::~ColumnFileWriter()
+{
+    if(!closed) close();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int ColumnFileWriter::typeWidth(ColumnType type)
+{
+    if(type == kColFloat)  return sizeof(float);
+    if(type == kColDouble) return sizeof(double);
+    if(type == kColLong)   return sizeof(long long);
+    return sizeof(unsigned char);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+int ColumnFileWriter::addColumn(TString name, ColumnType type)
+{
+    if(nRows > 0 || rowInGroup > 0)
+    {
+        std::cout << Form("  !!! ColumnFileWriter can't add column %s after rows were filled \n", name.Data());
+        return -1;
+    }
+    names.push_back(name);
+    types.push_back(type);
+    buffers.push_back(std::vector<char>(rowsPerGroup*typeWidth(type), 0));
+    return names.size()-1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void ColumnFileWriter::write(const void* data, unsigned long long size)
+{
+    if(file == 0) return;
+    fwrite(data, 1, size, file);
+    offset += size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void ColumnFileWriter::fillRow()
+{
+    rowInGroup++;
+    nRows++;
+    if(rowInGroup == rowsPerGroup) flushGroup();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void ColumnFileWriter::flushGroup()
+{
+// write the buffered rows for each column contiguously, pad so that
+// every column starts on an 8 byte boundary in the memory mapped file
+    if(rowInGroup == 0) return;
+
+    static const char zeros[8] = {0,0,0,0,0,0,0,0};
+    std::vector<unsigned long long> offsets;
+    for(unsigned int c=0; c<buffers.size(); c++)
+    {
+        offsets.push_back(offset);
+        write(&buffers[c][0], rowInGroup*typeWidth(types[c]));
+        if(offset%8 != 0) write(zeros, 8 - offset%8);
+    }
+    groupRows.push_back(rowInGroup);
+    groupOffsets.push_back(offsets);
+    rowInGroup = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+bool ColumnFileWriter::close()
+{
+    if(closed || file == 0) return false;
+    flushGroup();
+
+    unsigned long long footer = offset;
+
+    unsigned int ncols = names.size();
+    write(&ncols, sizeof(ncols));
+    for(unsigned int c=0; c<ncols; c++)
+    {
+        unsigned char type = types[c];
+        unsigned int length = names[c].Length();
+        write(&type, sizeof(type));
+        write(&length, sizeof(length));
+        write(names[c].Data(), length);
+    }
+
+    unsigned long long ngroups = groupRows.size();
+    write(&ngroups, sizeof(ngroups));
+    for(unsigned int g=0; g<ngroups; g++)
+    {
+        write(&groupRows[g], sizeof(unsigned long long));
+        write(&groupOffsets[g][0], ncols*sizeof(unsigned long long));
+    }
+
+    unsigned int nmeta = metadata.size();
+    write(&nmeta, sizeof(nmeta));
+    for(auto& m: metadata)
+    {
+        unsigned int klength = m.first.Length();
+        unsigned int vlength = m.second.Length();
+        write(&klength, sizeof(klength));
+        write(m.first.Data(), klength);
+        write(&vlength, sizeof(vlength));
+        write(m.second.Data(), vlength);
+    }
+
+    write(&footer, sizeof(footer));
+    write(COLUMNFILE_MAGIC, 8);
+
+    bool ok = (ferror(file) == 0);
+    fclose(file);
+    file = 0;
+    closed = true;
+
+    buffers.clear();
+    buffers.shrink_to_fit();
+
+    if(!ok) std::cout << Form("  !!! ColumnFileWriter failed writing %s \n", filename.Data());
+    return ok;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// _______________________ColumnFileReader_______________________________//
+///////////////////////////////////////////////////////////////////////////
+
+bool ColumnFileReader::open(TString ifilename)
+{
+    close();
+    filename = ifilename;
+
+    int fd = ::open(filename.Data(), O_RDONLY);
+    if(fd < 0) return false;
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size < 24)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    size = st.st_size;
+    void* mapped = mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(mapped == MAP_FAILED) return false;
+    data = (const char*) mapped;
+
+    if(memcmp(data, COLUMNFILE_MAGIC, 8) != 0 || memcmp(data+size-8, COLUMNFILE_MAGIC, 8) != 0)
+    {
+        std::cout << Form("  !!! %s is not a column file or was not closed properly \n", filename.Data());
+        close();
+        return false;
+    }
+
+    // parse the footer
+    unsigned long long footer;
+    memcpy(&footer, data+size-16, sizeof(footer));
+    const char* p = data+footer;
+
+    unsigned int ncols;
+    memcpy(&ncols, p, sizeof(ncols)); p+=sizeof(ncols);
+    for(unsigned int c=0; c<ncols; c++)
+    {
+        unsigned char type;
+        unsigned int length;
+        memcpy(&type, p, sizeof(type)); p+=sizeof(type);
+        memcpy(&length, p, sizeof(length)); p+=sizeof(length);
+        names.push_back(TString(p, length)); p+=length;
+        types.push_back((ColumnType) type);
+    }
+
+    unsigned long long ngroups;
+    memcpy(&ngroups, p, sizeof(ngroups)); p+=sizeof(ngroups);
+    for(unsigned int g=0; g<ngroups; g++)
+    {
+        unsigned long long rows;
+        memcpy(&rows, p, sizeof(rows)); p+=sizeof(rows);
+        std::vector<unsigned long long> offsets(ncols);
+        if(ncols > 0) memcpy(&offsets[0], p, ncols*sizeof(unsigned long long));
+        p+=ncols*sizeof(unsigned long long);
+
+        groupRows.push_back(rows);
+        groupOffsets.push_back(offsets);
+        nRows += rows;
+    }
+
+    unsigned int nmeta;
+    memcpy(&nmeta, p, sizeof(nmeta)); p+=sizeof(nmeta);
+    for(unsigned int m=0; m<nmeta; m++)
+    {
+        unsigned int klength, vlength;
+        memcpy(&klength, p, sizeof(klength)); p+=sizeof(klength);
+        TString key(p, klength); p+=klength;
+        memcpy(&vlength, p, sizeof(vlength)); p+=sizeof(vlength);
+        TString value(p, vlength); p+=vlength;
+        metadata[key] = value;
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void ColumnFileReader::close()
+{
+    if(data != 0) munmap((void*) data, size);
+    data = 0;
+    size = 0;
+    nRows = 0;
+    names.clear();
+    types.clear();
+    groupRows.clear();
+    groupOffsets.clear();
+    metadata.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+int ColumnFileReader::findColumn(TString name)
+{
+    for(unsigned int c=0; c<names.size(); c++)
+        if(names[c] == name) return c;
+    return -1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+const void* ColumnFileReader::columnPtr(int igroup, int icol, ColumnType type)
+{
+    if(data == 0 || icol < 0 || icol >= (int)names.size()) return 0;
+    if(types[icol] != type)
+    {
+        std::cout << Form("  !!! column %s in %s requested with the wrong type \n", names[icol].Data(), filename.Data());
+        return 0;
+    }
+    return data + groupOffsets[igroup][icol];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+double ColumnFileReader::getValue(int igroup, int icol, unsigned long long row)
+{
+    ColumnType type = types[icol];
+    if(type == kColFloat)  return getFloats(igroup, icol)[row];
+    if(type == kColDouble) return getDoubles(igroup, icol)[row];
+    if(type == kColLong)   return getLongs(igroup, icol)[row];
+    return getBytes(igroup, icol)[row];
+}
@@ -0,0 +1,127 @@
+///////////////////////////////////////////////////////////////////////////
+// ======================================================================//
+// ColumnFile.h                                                          //
+// ======================================================================//
+// Compact columnar file for the skimmed events. Each column is a flat   //
+// array of floats, doubles, long longs, or bytes stored in row groups.  //
+// The writer buffers one row group per column and flushes it to disk.   //
+// The reader memory maps the file and hands out raw column pointers,    //
+// so only the pages for the columns we actually use are ever read.      //
+// ======================================================================//
+///////////////////////////////////////////////////////////////////////////
+
+#ifndef ADD_COLUMNFILE
+#define ADD_COLUMNFILE
+
+#include "TString.h"
+
+#include <vector>
+#include <map>
+#include <cstdio>
+
+// the types a column may have
+enum ColumnType { kColFloat = 0, kColDouble = 1, kColLong = 2, kColByte = 3 };
+
+///////////////////////////////////////////////////////////////////////////
+// ______________________ColumnFileWriter_______________________________//
+///////////////////////////////////////////////////////////////////////////
+
+class ColumnFileWriter
+{
+    public:
+        ColumnFileWriter(TString filename, unsigned int rowsPerGroup = 65536);
+        ~ColumnFileWriter();
+
+        TString filename;
+        unsigned int rowsPerGroup;       // number of rows buffered per column before we flush to disk
+        unsigned long long nRows = 0;    // number of rows written so far
+
+        // define the schema, all columns must be added before the first fillRow
+        int addColumn(TString name, ColumnType type);
+
+        // store some key/value info (xsec, nOriginalWeighted, etc) in the footer
+        void setMetadata(TString key, TString value) { metadata[key] = value; };
+
+        // set the value of column icol for the current row
+        void setFloat(int icol, float value)           { ((float*)     rowPtr(icol))[0] = value; };
+        void setDouble(int icol, double value)         { ((double*)    rowPtr(icol))[0] = value; };
+        void setLong(int icol, long long int value)    { ((long long*) rowPtr(icol))[0] = value; };
+        void setByte(int icol, unsigned char value)    { ((unsigned char*) rowPtr(icol))[0] = value; };
+
+        void fillRow();  // done setting values for this row, move on to the next one
+        bool close();    // flush the last row group and write the footer
+
+    protected:
+        FILE* file = 0;
+        bool closed = false;
+        unsigned long long offset = 0;  // current write position in the file
+        unsigned int rowInGroup = 0;    // current row in the buffered group
+
+        std::vector<TString> names;
+        std::vector<ColumnType> types;
+        std::vector< std::vector<char> > buffers;               // one row group per column
+        std::vector<unsigned long long> groupRows;              // number of rows in each group
+        std::vector< std::vector<unsigned long long> > groupOffsets; // offset of each column in each group
+        std::map<TString, TString> metadata;
+
+        char* rowPtr(int icol) { return &buffers[icol][rowInGroup*typeWidth(types[icol])]; };
+        void flushGroup();
+        void write(const void* data, unsigned long long size);
+
+    public:
+        // number of bytes per entry for the column type
+        static unsigned int typeWidth(ColumnType type);
+};
+
+///////////////////////////////////////////////////////////////////////////
+// ______________________ColumnFileReader_______________________________//
+///////////////////////////////////////////////////////////////////////////
+
+class ColumnFileReader
+{
+    public:
+        ColumnFileReader(){};
+        ColumnFileReader(TString filename) { open(filename); };
+        ~ColumnFileReader() { close(); };
+
+        bool open(TString filename);
+        void close();
+        bool isOpen() { return data != 0; };
+
+        TString filename;
+        unsigned long long nRows = 0;
+
+        // column bookkeeping, -1 if the column isn't in the file
+        int findColumn(TString name);
+        int nColumns()                { return names.size(); };
+        TString columnName(int icol)  { return names[icol]; };
+        ColumnType columnType(int icol) { return types[icol]; };
+
+        // row groups, the pointers are into the memory mapped file
+        int nGroups()                            { return groupRows.size(); };
+        unsigned long long groupSize(int igroup) { return groupRows[igroup]; };
+
+        const float*         getFloats(int igroup, int icol)  { return (const float*)         columnPtr(igroup, icol, kColFloat);  };
+        const double*        getDoubles(int igroup, int icol) { return (const double*)        columnPtr(igroup, icol, kColDouble); };
+        const long long*     getLongs(int igroup, int icol)   { return (const long long*)     columnPtr(igroup, icol, kColLong);   };
+        const unsigned char* getBytes(int igroup, int icol)   { return (const unsigned char*) columnPtr(igroup, icol, kColByte);   };
+
+        // get the value of a column as a double no matter the type, slow, use for bookkeeping only
+        double getValue(int igroup, int icol, unsigned long long row);
+
+        TString getMetadata(TString key) { return (metadata.count(key) > 0) ? metadata[key] : TString(""); };
+        std::map<TString, TString> metadata;
+
+    protected:
+        const char* data = 0;
+        unsigned long long size = 0;
+
+        std::vector<TString> names;
+        std::vector<ColumnType> types;
+        std::vector<unsigned long long> groupRows;
+        std::vector< std::vector<unsigned long long> > groupOffsets;
+
+        const void* columnPtr(int igroup, int icol, ColumnType type);
+};
+
+#endif
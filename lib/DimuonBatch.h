@@ -0,0 +1,168 @@
+///////////////////////////////////////////////////////////////////////////
+// ======================================================================//
+// DimuonBatch.h                                                         //
+// ======================================================================//
+// The muon info the preselection needs for a block of events, stored    //
+// as columns with one row per dimuon candidate. Sample::getBatch loads  //
+// only the muon branches for the block, then the cuts in ../selection/  //
+// AND their result into the pass column for every candidate at once.    //
+// The event loop only loads the rest of the branches for the events     //
+// that still have a candidate passing, see getSurvivors.                //
+// ======================================================================//
+///////////////////////////////////////////////////////////////////////////
+
+#ifndef ADD_DIMUONBATCH
+#define ADD_DIMUONBATCH
+
+#include "VarSet.h"
+#include "TString.h"
+
+#include <vector>
+
+class DimuonBatch
+{
+    public:
+        DimuonBatch(){};
+        DimuonBatch(TString icalibration) { calibration = icalibration; };
+        ~DimuonBatch(){};
+
+        TString calibration;   // PF, Roch, or KaMu, which mass and pts to put in the columns
+
+        // one row per dimuon candidate, the rows for an event are contiguous and in muPairs order
+        std::vector<Long64_t> entry;         // the ttree entry
+        std::vector<int> ipair;              // index into vars.muPairs
+        std::vector<long long> run;
+
+        std::vector<double> mass;
+        std::vector<double> mu1_pt;
+        std::vector<double> mu2_pt;
+        std::vector<double> mu1_eta;
+        std::vector<double> mu2_eta;
+        std::vector<double> mu1_iso;
+        std::vector<double> mu2_iso;
+        std::vector<int> mu1_charge;
+        std::vector<int> mu2_charge;
+        std::vector<unsigned char> mu1_trig;      // isHltMatched[2] || isHltMatched[3]
+        std::vector<unsigned char> mu2_trig;
+        std::vector<unsigned char> mu1_mediumID;
+        std::vector<unsigned char> mu2_mediumID;
+
+        // 1 while the candidate passes every cut applied so far
+        std::vector<unsigned char> pass;
+
+        unsigned int size() const { return entry.size(); };
+
+        // keeps the memory for the next batch
+        void clear()
+        {
+            entry.clear(); ipair.clear(); run.clear();
+            mass.clear();
+            mu1_pt.clear(); mu2_pt.clear();
+            mu1_eta.clear(); mu2_eta.clear();
+            mu1_iso.clear(); mu2_iso.clear();
+            mu1_charge.clear(); mu2_charge.clear();
+            mu1_trig.clear(); mu2_trig.clear();
+            mu1_mediumID.clear(); mu2_mediumID.clear();
+            pass.clear();
+        }
+
+        // add the candidates of the event loaded into vars, needs muPairs, muons, and eventInfo
+        void add(VarSet& vars, Long64_t i)
+        {
+            for(unsigned int p=0; p<vars.muPairs->size(); p++)
+            {
+                const MuPairInfo& dimu = vars.muPairs->at(p);
+                MuonInfo& mu1 = vars.muons->at(dimu.iMu1);
+                MuonInfo& mu2 = vars.muons->at(dimu.iMu2);
+
+                entry.push_back(i);
+                ipair.push_back(p);
+                run.push_back(vars.eventInfo->run);
+
+                // same values VarSet::setCalibrationType puts in mass and pt
+                if(calibration == "PF")
+                {
+                    mass.push_back(dimu.mass_PF);
+                    mu1_pt.push_back(mu1.pt_PF);
+                    mu2_pt.push_back(mu2.pt_PF);
+                }
+                else if(calibration == "Roch")
+                {
+                    mass.push_back(dimu.mass_Roch);
+                    mu1_pt.push_back(mu1.pt_Roch);
+                    mu2_pt.push_back(mu2.pt_Roch);
+                }
+                else if(calibration == "KaMu")
+                {
+                    mass.push_back(dimu.mass_KaMu);
+                    mu1_pt.push_back(mu1.pt_KaMu);
+                    mu2_pt.push_back(mu2.pt_KaMu);
+                }
+                else
+                {
+                    mass.push_back(dimu.mass);
+                    mu1_pt.push_back(mu1.pt);
+                    mu2_pt.push_back(mu2.pt);
+                }
+
+                mu1_eta.push_back(mu1.eta);
+                mu2_eta.push_back(mu2.eta);
+                mu1_iso.push_back(getIso(mu1, mu1_pt.back()));
+                mu2_iso.push_back(getIso(mu2, mu2_pt.back()));
+                mu1_charge.push_back(mu1.charge);
+                mu2_charge.push_back(mu2.charge);
+                mu1_trig.push_back(mu1.isHltMatched[2] || mu1.isHltMatched[3]);
+                mu2_trig.push_back(mu2.isHltMatched[2] || mu2.isHltMatched[3]);
+                mu1_mediumID.push_back(mu1.isMediumID);
+                mu2_mediumID.push_back(mu2.isMediumID);
+                pass.push_back(1);
+            }
+        }
+
+        // MuonInfo::iso() divides by mu.pt, which setCalibrationType sets to the calibrated pt before the
+        // per-event cuts, so the relative isolation depends on the calibration too
+        static double getIso(MuonInfo& mu, double pt)
+        {
+            double rawPt = mu.pt;
+            mu.pt = pt;
+            double iso = mu.iso();
+            mu.pt = rawPt;
+            return iso;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        // Cuts that aren't a Cut object ---------------------------------------------
+        //////////////////////////////////////////////////////////////////////////////
+
+        void applyMediumID()
+        {
+            unsigned int n = size();
+            for(unsigned int r=0; r<n; r++)
+                pass[r] &= mu1_mediumID[r] & mu2_mediumID[r];
+        }
+
+        // keep minRun <= run <= maxRun, e.g. to split RunF between two samples
+        void applyRunRange(long long minRun, long long maxRun)
+        {
+            unsigned int n = size();
+            for(unsigned int r=0; r<n; r++)
+                pass[r] &= (run[r] >= minRun) & (run[r] <= maxRun);
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        // Results -------------------------------------------------------------------
+        //////////////////////////////////////////////////////////////////////////////
+
+        // append the entries with at least one passing candidate, in order
+        void getSurvivors(std::vector<Long64_t>& survivors) const
+        {
+            unsigned int n = size();
+            for(unsigned int r=0; r<n; r++)
+            {
+                if(!pass[r]) continue;
+                if(survivors.empty() || survivors.back() != entry[r]) survivors.push_back(entry[r]);
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,348 @@
+///////////////////////////////////////////////////////////////////////////
+// ======================================================================//
+// EventIndex.h                                                          //
+// ======================================================================//
+// Where each event is in a sample's chain. For every ntuple we keep the //
+// run, event, lumi -> entry records sorted so that one event is found   //
+// with a binary search, and the blocks of entries that share a run, so  //
+// a run range becomes a list of entry ranges to read. Building the      //
+// index for a file reads only the event branch, once: it is saved in    //
+// event_index/ next to samples.catalog under the md5 of the file path,  //
+// size, and modification time, and read back from there afterwards.     //
+// Sample::getEventIndex makes one for the sample, EventVeto streams the //
+// saved records of every data file with a RecordReader.                 //
+// ======================================================================//
+///////////////////////////////////////////////////////////////////////////
+
+#ifndef ADD_EVENTINDEX
+#define ADD_EVENTINDEX
+
+#include "TString.h"
+#include "TSystem.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+#include "TMD5.h"
+#include "TDirectory.h"
+#include "EventInfo.h"
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+class EventIndex
+{
+    public:
+        struct Record
+        {
+            Int_t run;
+            Int_t lumi;
+            Long64_t event;
+            Long64_t entry;     // in the file
+        };
+
+        // entries [first, last) of the file all have this run
+        struct RunRange
+        {
+            Int_t run;
+            Long64_t first;
+            Long64_t last;
+        };
+
+        struct FileIndex
+        {
+            Long64_t nentries = 0;
+            std::vector<Record> records;     // sorted by run, event, lumi
+            std::vector<RunRange> runs;      // in entry order
+        };
+
+        static TString& directory()
+        {
+            static TString dir = "event_index";
+            return dir;
+        }
+
+        EventIndex(){};
+        ~EventIndex(){};
+
+        // index the files of a chain in order, false if one of them couldn't be read
+        bool build(const std::vector<TString>& filenames)
+        {
+            files.clear();
+            offsets.clear();
+            nentries = 0;
+            bool ok = true;
+            for(auto& filename: filenames)
+            {
+                files.push_back(FileIndex());
+                offsets.push_back(nentries);
+                ok = getFileIndex(filename, files.back()) && ok;
+                nentries += files.back().nentries;
+            }
+            return ok;
+        }
+
+        Long64_t nentries = 0;
+
+        // the chain entry of the event, -1 if it isn't there. lumi < 0 takes the event from any lumi,
+        // the csv lists of events only have the run and event
+        Long64_t find(int run, long long event, int lumi = -1) const
+        {
+            for(unsigned int f=0; f<files.size(); f++)
+            {
+                const std::vector<Record>& records = files[f].records;
+                Record key;
+                key.run = run;
+                key.event = event;
+                key.lumi = (lumi < 0)?-1:lumi;
+                auto r = std::lower_bound(records.begin(), records.end(), key, less);
+                for(; r != records.end() && r->run == run && r->event == event; r++)
+                    if(lumi < 0 || r->lumi == lumi) return offsets[f] + r->entry;
+            }
+            return -1;
+        }
+
+        // the chain entries in [first, last) with minRun <= run <= maxRun, as ranges in increasing order
+        std::vector< std::pair<Long64_t, Long64_t> > getRunRanges(long long minRun, long long maxRun, Long64_t first = 0, Long64_t last = -1) const
+        {
+            if(last < 0) last = nentries;
+            std::vector< std::pair<Long64_t, Long64_t> > ranges;
+            for(unsigned int f=0; f<files.size(); f++)
+            {
+                for(auto& r: files[f].runs)
+                {
+                    if(r.run < minRun || r.run > maxRun) continue;
+                    Long64_t a = std::max(first, offsets[f] + r.first);
+                    Long64_t b = std::min(last, offsets[f] + r.last);
+                    if(a >= b) continue;
+                    if(!ranges.empty() && ranges.back().second == a) ranges.back().second = b;
+                    else ranges.push_back(std::pair<Long64_t, Long64_t>(a, b));
+                }
+            }
+            return ranges;
+        }
+
+        // the index for one ntuple from the directory, made and saved there if it isn't there yet
+        static bool getFileIndex(TString filename, FileIndex& index)
+        {
+            TString indexfile = getIndexFilename(filename);
+            if(indexfile != "" && readIndex(indexfile, index)) return true;
+            if(!makeIndex(filename, index)) return false;
+            if(indexfile != "") writeIndex(indexfile, index);
+            return true;
+        }
+
+        // where the index of the ntuple is saved, "" if we can't tell when the file changes, e.g. over xrootd
+        static TString getIndexFilename(TString filename)
+        {
+            Long_t id, flags, mtime = -1;
+            Long64_t size = -1;
+            gSystem->GetPathInfo(filename, &id, &size, &flags, &mtime);
+            if(size < 0) return "";
+            return directory()+"/"+getKey(filename, size, mtime)+"_"+gSystem->BaseName(filename)+".idx";
+        }
+
+        // the records of one ntuple in run, event, lumi order, read from the saved index a block at a time
+        // so that EventVeto can merge the indexes of all of the data without holding them in memory
+        class RecordReader
+        {
+            public:
+                RecordReader(){};
+                ~RecordReader() { if(in != 0) fclose(in); };
+
+                // makes and saves the index if it isn't there yet, without a saved index the records stay in memory
+                bool open(TString filename, unsigned int iblockSize = 1<<16)
+                {
+                    blockSize = iblockSize;
+                    TString indexfile = getIndexFilename(filename);
+                    if(openIndex(indexfile)) return true;
+
+                    FileIndex index;
+                    if(!getFileIndex(filename, index)) return false;
+                    if(openIndex(indexfile)) return true;
+                    nentries = index.nentries;
+                    block.swap(index.records);
+                    pos = 0;
+                    return true;
+                }
+
+                // false at the end or if the index can't be read, then ok is false too
+                bool next(Record& r)
+                {
+                    if(pos == block.size())
+                    {
+                        if(in == 0 || remaining == 0) return false;
+                        block.resize(std::min(remaining, (Long64_t)blockSize));
+                        if(fread(block.data(), sizeof(Record), block.size(), in) != block.size())
+                        {
+                            std::cout << "  !!! could not read the records of an event index \n";
+                            ok = false;
+                            remaining = 0;
+                            block.clear();
+                            return false;
+                        }
+                        remaining -= block.size();
+                        pos = 0;
+                    }
+                    r = block[pos++];
+                    return true;
+                }
+
+                Long64_t nentries = 0;      // in the ntuple
+                bool ok = true;
+
+            private:
+                FILE* in = 0;
+                std::vector<Record> block;
+                size_t pos = 0;
+                Long64_t remaining = 0;     // records in the file after the block
+                unsigned int blockSize = 1<<16;
+
+                // the header and the runs, the records are read by next
+                bool openIndex(TString indexfile)
+                {
+                    if(indexfile == "") return false;
+                    in = fopen(indexfile.Data(), "rb");
+                    if(in == 0) return false;
+
+                    char magic[8];
+                    Long64_t nruns = 0;
+                    bool good = fread(magic, 1, 8, in) == 8 && memcmp(magic, "EVTIDX01", 8) == 0 &&
+                                fread(&nentries, sizeof(Long64_t), 1, in) == 1 &&
+                                fread(&nruns, sizeof(Long64_t), 1, in) == 1 && fread(&remaining, sizeof(Long64_t), 1, in) == 1 &&
+                                fseek(in, nruns*sizeof(RunRange), SEEK_CUR) == 0;
+                    if(!good)
+                    {
+                        fclose(in);
+                        in = 0;
+                        remaining = 0;
+                        return false;
+                    }
+                    block.clear();
+                    pos = 0;
+                    return true;
+                }
+        };
+
+        static bool less(const Record& a, const Record& b)
+        {
+            if(a.run != b.run) return a.run < b.run;
+            if(a.event != b.event) return a.event < b.event;
+            return a.lumi < b.lumi;
+        }
+
+    private:
+        std::vector<FileIndex> files;
+        std::vector<Long64_t> offsets;   // the chain entry of the first entry in each file
+
+        static TString getKey(TString filename, Long64_t size, Long_t mtime)
+        {
+            TString id = Form("%s %lld %ld", filename.Data(), size, mtime);
+            TMD5 md5;
+            md5.Update((const UChar_t*) id.Data(), id.Length());
+            md5.Final();
+            return md5.AsString();
+        }
+
+        // reads the event branch of dimuons/tree
+        static bool makeIndex(TString filename, FileIndex& index)
+        {
+            std::cout << Form("  /// Indexing the events in %s \n", filename.Data());
+            TDirectory::TContext context;   // put gDirectory back when we are done
+            TFile* file = TFile::Open(filename);
+            TTree* tree = (file != 0 && !file->IsZombie())?(TTree*) file->Get("dimuons/tree"):0;
+            TBranch* branch = (tree != 0)?tree->GetBranch("event"):0;
+            if(branch == 0)
+            {
+                std::cout << Form("  !!! could not read the events in %s for the index \n", filename.Data());
+                delete file;
+                return false;
+            }
+
+            EventInfo* info = 0;
+            branch->SetAddress(&info);
+            index.nentries = tree->GetEntries();
+            index.records.resize(index.nentries);
+            index.runs.clear();
+            for(Long64_t i=0; i<index.nentries; i++)
+            {
+                branch->GetEntry(i);
+                Record& r = index.records[i];
+                r.run = info->run;
+                r.lumi = info->lumi;
+                r.event = info->event;
+                r.entry = i;
+
+                if(!index.runs.empty() && index.runs.back().run == r.run) index.runs.back().last = i+1;
+                else
+                {
+                    RunRange range;
+                    range.run = r.run;
+                    range.first = i;
+                    range.last = i+1;
+                    index.runs.push_back(range);
+                }
+            }
+            std::stable_sort(index.records.begin(), index.records.end(), less);   // the copies of an event stay in entry order
+
+            branch->ResetAddress();
+            delete info;
+            file->Close();
+            delete file;
+            return true;
+        }
+
+        // magic, nentries, nruns, nrecords, the runs, the records
+        static bool readIndex(TString indexfile, FileIndex& index)
+        {
+            FILE* in = fopen(indexfile.Data(), "rb");
+            if(in == 0) return false;
+
+            char magic[8];
+            Long64_t nruns = 0, nrecords = 0;
+            bool ok = fread(magic, 1, 8, in) == 8 && memcmp(magic, "EVTIDX01", 8) == 0 &&
+                      fread(&index.nentries, sizeof(Long64_t), 1, in) == 1 &&
+                      fread(&nruns, sizeof(Long64_t), 1, in) == 1 && fread(&nrecords, sizeof(Long64_t), 1, in) == 1;
+            if(ok)
+            {
+                index.runs.resize(nruns);
+                index.records.resize(nrecords);
+                ok = fread(index.runs.data(), sizeof(RunRange), nruns, in) == (size_t)nruns &&
+                     fread(index.records.data(), sizeof(Record), nrecords, in) == (size_t)nrecords;
+            }
+            fclose(in);
+            if(!ok) std::cout << Form("  !!! the event index %s is broken, indexing the file again \n", indexfile.Data());
+            return ok;
+        }
+
+        // to a temporary name first so that a partial index is never read
+        static void writeIndex(TString indexfile, const FileIndex& index)
+        {
+            gSystem->mkdir(directory(), true);
+            TString partial = indexfile+Form(".part%d", gSystem->GetPid());
+            FILE* out = fopen(partial.Data(), "wb");
+            if(out == 0)
+            {
+                std::cout << Form("  !!! could not write the event index %s \n", indexfile.Data());
+                return;
+            }
+            Long64_t nruns = index.runs.size();
+            Long64_t nrecords = index.records.size();
+            bool ok = fwrite("EVTIDX01", 1, 8, out) == 8 &&
+                      fwrite(&index.nentries, sizeof(Long64_t), 1, out) == 1 &&
+                      fwrite(&nruns, sizeof(Long64_t), 1, out) == 1 && fwrite(&nrecords, sizeof(Long64_t), 1, out) == 1 &&
+                      fwrite(index.runs.data(), sizeof(RunRange), nruns, out) == (size_t)nruns &&
+                      fwrite(index.records.data(), sizeof(Record), nrecords, out) == (size_t)nrecords;
+            ok = (fclose(out) == 0) && ok;
+            if(!ok || gSystem->Rename(partial, indexfile) != 0)
+            {
+                std::cout << Form("  !!! could not write the event index %s \n", indexfile.Data());
+                gSystem->Unlink(partial);
+            }
+        }
+};
+
+#endif
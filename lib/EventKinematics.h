@@ -0,0 +1,187 @@
+///////////////////////////////////////////////////////////////////////////
+// ======================================================================//
+// EventKinematics.h                                                     //
+// ======================================================================//
+// Structure of arrays copy of the cleaned jets and bjets for one event, //
+// the masses and dEtas of all the jet pairs, and the dijet quantities   //
+// the features use. VarSet fills this once per event after cleaning,    //
+// the jet features read from it instead of summing TLorentzVectors.     //
+// Also caches the dimuon phi*, keyed on the two muons.                  //
+// The pair kernels are plain loops over contiguous arrays so that the   //
+// compiler can vectorize them.                                          //
+// ======================================================================//
+///////////////////////////////////////////////////////////////////////////
+
+#ifndef ADD_EVENTKINEMATICS
+#define ADD_EVENTKINEMATICS
+
+#include "PtEtaPhiM.h"
+#include "TMath.h"
+
+#include <vector>
+#include <cmath>
+
+// one collection as arrays, the vectors keep their memory between events
+struct KinematicsBlock
+{
+    unsigned int n = 0;
+    std::vector<double> pt, eta, phi, m, px, py, pz, e;
+
+    void fill(const std::vector<PtEtaPhiM>& objects)
+    {
+        n = objects.size();
+        pt.resize(n); eta.resize(n); phi.resize(n); m.resize(n);
+        px.resize(n); py.resize(n); pz.resize(n); e.resize(n);
+
+        for(unsigned int i=0; i<n; i++)
+        {
+            pt[i]  = objects[i].pt;
+            eta[i] = objects[i].eta;
+            phi[i] = objects[i].phi;
+            m[i]   = objects[i].m;
+        }
+        for(unsigned int i=0; i<n; i++)
+        {
+            px[i] = pt[i]*std::cos(phi[i]);
+            py[i] = pt[i]*std::sin(phi[i]);
+            pz[i] = pt[i]*std::sinh(eta[i]);
+            double p = pt[i]*std::cosh(eta[i]);
+            e[i]  = std::sqrt(p*p + m[i]*m[i]);
+        }
+    }
+};
+
+// the sum of two objects from a block, -999 if there is no such pair
+struct PairKinematics
+{
+    int i = -1;
+    int j = -1;
+    double pt0  = -999;   // the legs, -999 if the index is out of range
+    double pt1  = -999;
+    double eta0 = -999;
+    double eta1 = -999;
+    double m    = -999;
+    double pt   = -999;
+    double eta  = -999;
+    double phi  = -999;
+    double dEta = -999;   // |eta_i - eta_j|
+    double zep  = -999;   // eta_i - (eta_i + eta_j)/2
+
+    void set(const KinematicsBlock& b, int ii, int jj)
+    {
+        i = ii;
+        j = jj;
+        bool hasi = (i >= 0 && i < (int)b.n);
+        bool hasj = (j >= 0 && j < (int)b.n);
+        pt0  = hasi ? b.pt[i]  : -999;
+        eta0 = hasi ? b.eta[i] : -999;
+        pt1  = hasj ? b.pt[j]  : -999;
+        eta1 = hasj ? b.eta[j] : -999;
+
+        if(!hasi || !hasj)
+        {
+            m = pt = eta = phi = dEta = zep = -999;
+            return;
+        }
+
+        PxPyPzE sum(b.px[i]+b.px[j], b.py[i]+b.py[j], b.pz[i]+b.pz[j], b.e[i]+b.e[j]);
+        m    = sum.M();
+        pt   = sum.Pt();
+        eta  = sum.Eta();
+        phi  = sum.Phi();
+        dEta = TMath::Abs(b.eta[i] - b.eta[j]);
+        zep  = b.eta[i] - (b.eta[i] + b.eta[j])/2;
+    }
+};
+
+class EventKinematics
+{
+    public:
+        EventKinematics(){};
+        ~EventKinematics(){};
+
+        KinematicsBlock jets;
+        KinematicsBlock bjets;
+
+        // the masses and |dEta| of the jet pairs, pair (i, j>i) is at [i*jets.n + j]
+        std::vector<double> mjj;
+        std::vector<double> dEtajj;
+
+        PairKinematics jj;      // j0, j1
+        PairKinematics vbfjj;   // vbf_j0, vbf_j1
+        PairKinematics bb;      // the two leading bjets
+
+        // the cleaners set this to false when they refill the collections
+        bool valid = false;
+
+        // phi* of the dimuon candidate, only recomputed when the muons change
+        double dPhiStar = -999;
+        double dPhiStarMuons[4] = {-999, -999, -999, -999};
+
+        void fill(const std::vector<PtEtaPhiM>& validJets, const std::vector<PtEtaPhiM>& validBJets)
+        {
+            jets.fill(validJets);
+            bjets.fill(validBJets);
+
+            unsigned int n = jets.n;
+            mjj.resize(n*n);
+            dEtajj.resize(n*n);
+            for(unsigned int i=0; i+1<n; i++)
+            {
+                pairMass(jets, i, i+1, &mjj[i*n]);
+                pairAbsDeltaEta(jets, i, i+1, &dEtajj[i*n]);
+            }
+
+            bb.set(bjets, 0, 1);
+            valid = true;
+        }
+
+        double getDPhiStar(double eta1, double phi1, double eta2, double phi2)
+        {
+            if(eta1 == dPhiStarMuons[0] && phi1 == dPhiStarMuons[1] && eta2 == dPhiStarMuons[2] && phi2 == dPhiStarMuons[3])
+                return dPhiStar;
+
+            double mu_dPhi = TMath::Abs(phi1 - phi2);
+            if(mu_dPhi > TMath::Pi()) mu_dPhi = 2*TMath::Pi() - mu_dPhi;
+            double phiACOP = TMath::Pi() - mu_dPhi;
+            double thetaStarEta = TMath::ACos(TMath::TanH((eta1 - eta2)/2));
+            dPhiStar = TMath::Tan(phiACOP/2)*TMath::Sin(thetaStarEta);
+
+            dPhiStarMuons[0] = eta1;
+            dPhiStarMuons[1] = phi1;
+            dPhiStarMuons[2] = eta2;
+            dPhiStarMuons[3] = phi2;
+            return dPhiStar;
+        }
+
+        // out[j] = mass of (i, j) for j in [first, b.n), same sign convention as TLorentzVector::M()
+        static void pairMass(const KinematicsBlock& b, unsigned int i, unsigned int first, double* out)
+        {
+            const double* px = &b.px[0];
+            const double* py = &b.py[0];
+            const double* pz = &b.pz[0];
+            const double* e  = &b.e[0];
+            double pxi = px[i], pyi = py[i], pzi = pz[i], ei = e[i];
+
+            for(unsigned int j=first; j<b.n; j++)
+            {
+                double sx = pxi + px[j];
+                double sy = pyi + py[j];
+                double sz = pzi + pz[j];
+                double se = ei  + e[j];
+                double m2 = se*se - sx*sx - sy*sy - sz*sz;
+                out[j] = std::copysign(std::sqrt(std::fabs(m2)), m2);
+            }
+        }
+
+        // out[j] = |eta_i - eta_j| for j in [first, b.n)
+        static void pairAbsDeltaEta(const KinematicsBlock& b, unsigned int i, unsigned int first, double* out)
+        {
+            const double* eta = &b.eta[0];
+            double etai = eta[i];
+            for(unsigned int j=first; j<b.n; j++)
+                out[j] = std::fabs(etai - eta[j]);
+        }
+};
+
+#endif
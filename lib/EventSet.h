@@ -0,0 +1,140 @@
+///////////////////////////////////////////////////////////////////////////
+// ======================================================================//
+// EventSet.h                                                            //
+// ======================================================================//
+// A set of events with O(1) lookup, for the synchronization lists and   //
+// for reading only the listed events of a sample. The events are kept  //
+// in the order they were added, an open addressing hash table points   //
+// into them. (run, event) identifies an event, the lumi is carried      //
+// along for the output but the csv lists don't have it, so it isn't     //
+// part of the key. Intersection and difference keep the order of the    //
+// set they are called on.                                               //
+// ======================================================================//
+///////////////////////////////////////////////////////////////////////////
+
+#ifndef ADD_EVENTSET
+#define ADD_EVENTSET
+
+#include <vector>
+#include <utility>
+
+struct EventKey
+{
+    int run = 0;
+    int lumi = 0;
+    long long event = 0;
+};
+
+class EventSet
+{
+    public:
+        EventSet(){};
+        EventSet(const std::vector< std::pair<int, long long int> >& v)
+        {
+            reserve(v.size());
+            for(auto& e: v)
+                insert(e.first, e.second);
+        };
+        ~EventSet(){};
+
+        // false if the event was already in the set
+        bool insert(int run, long long event, int lumi = 0)
+        {
+            if(2*(events.size()+1) > slots.size()) rehash(slots.empty()?64:2*slots.size());
+
+            unsigned int s = slot(run, event);
+            if(slots[s] >= 0) return false;
+
+            EventKey e;
+            e.run = run;
+            e.lumi = lumi;
+            e.event = event;
+            slots[s] = events.size();
+            events.push_back(e);
+            return true;
+        }
+        bool insert(const EventKey& e)                             { return insert(e.run, e.event, e.lumi); };
+        bool insert(const std::pair<int, long long int>& e)        { return insert(e.first, e.second); };
+
+        // position of the event in getEvents(), -1 if it isn't in the set
+        int find(int run, long long event) const
+        {
+            if(slots.empty()) return -1;
+            return slots[slot(run, event)];
+        }
+
+        bool contains(int run, long long event) const               { return find(run, event) >= 0; };
+        bool contains(const std::pair<int, long long int>& e) const { return find(e.first, e.second) >= 0; };
+
+        const std::vector<EventKey>& getEvents() const { return events; };
+        unsigned int size() const  { return events.size(); };
+        bool empty() const         { return events.empty(); };
+
+        void clear()
+        {
+            events.clear();
+            slots.clear();
+        }
+
+        // make room for n events without rehashing
+        void reserve(unsigned int n)
+        {
+            unsigned int capacity = 64;
+            while(capacity < 2*n) capacity *= 2;
+            if(capacity > slots.size()) rehash(capacity);
+        }
+
+        // the events in both sets
+        EventSet intersection(const EventSet& other) const
+        {
+            EventSet result;
+            for(auto& e: events)
+                if(other.contains(e.run, e.event)) result.insert(e);
+            return result;
+        }
+
+        // the events in this set that aren't in the other one
+        EventSet difference(const EventSet& other) const
+        {
+            EventSet result;
+            for(auto& e: events)
+                if(!other.contains(e.run, e.event)) result.insert(e);
+            return result;
+        }
+
+    private:
+        std::vector<EventKey> events;
+        std::vector<int> slots;        // index into events, -1 for an empty slot, the size is a power of 2
+
+        static unsigned long long hash(int run, long long event)
+        {
+            unsigned long long h = (unsigned long long)event*0x9E3779B97F4A7C15ULL ^ (unsigned long long)run*0xC2B2AE3D27D4EB4FULL;
+            h ^= h >> 31;
+            h *= 0xBF58476D1CE4E5B9ULL;
+            h ^= h >> 29;
+            return h;
+        }
+
+        // the slot with the event or the empty slot where it would go, linear probing
+        unsigned int slot(int run, long long event) const
+        {
+            unsigned int mask = slots.size()-1;
+            unsigned int s = hash(run, event) & mask;
+            while(slots[s] >= 0)
+            {
+                const EventKey& e = events[slots[s]];
+                if(e.run == run && e.event == event) return s;
+                s = (s+1) & mask;
+            }
+            return s;
+        }
+
+        void rehash(unsigned int capacity)
+        {
+            slots.assign(capacity, -1);
+            for(unsigned int i=0; i<events.size(); i++)
+                slots[slot(events[i].run, events[i].event)] = i;
+        }
+};
+
+#endif
@@ -0,0 +1,298 @@
+///////////////////////////////////////////////////////////////////////////
+// ======================================================================//
+// EventVeto.h                                                           //
+// ======================================================================//
+// Removes the data events we would otherwise count twice. An era only   //
+// keeps the runs in its runs= range from samples.catalog, e.g. RunF_1   //
+// and RunF_2 split RunF at run 278802, and with --location=UF+UF_Double //
+// Mu a sample reads both the SingleMuon and DoubleMuon ntuples, which   //
+// share most of their events. The EventIndex records of each ntuple    //
+// are already sorted by run and event, so a k-way merge over the data   //
+// files in catalog order sees all the copies of an event one after the  //
+// other and keeps the first one in its sample's runs. Only a block of   //
+// records per file is in memory, plus one bit per entry for the result. //
+// The bits are saved in event_index/ so the merge runs once for a set   //
+// of files. GetSamples makes the vetoes, the event loops skip the       //
+// entries where Sample::isVetoed is true.                               //
+// ======================================================================//
+///////////////////////////////////////////////////////////////////////////
+
+#ifndef ADD_EVENTVETO
+#define ADD_EVENTVETO
+
+#include "Sample.h"
+#include "EventIndex.h"
+#include "EventInfo.h"
+#include "TString.h"
+#include "TSystem.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+#include "TDirectory.h"
+#include "TMD5.h"
+
+#include <vector>
+#include <queue>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+class EventVeto
+{
+    public:
+        // false leaves every entry in, e.g. to look at the duplicates
+        static bool& enabled()
+        {
+            static bool on = true;
+            return on;
+        }
+
+        // set the veto of each data sample. The samples earlier in the list, and the files earlier in a sample,
+        // keep the events they share with the later ones. Call it before making the readers, they share the veto
+        static void apply(const std::vector<Sample*>& samples)
+        {
+            if(!enabled() || samples.empty()) return;
+
+            // the saved vetoes depend on the order of the samples, their runs, and every file
+            TString id = "";
+            bool canSave = true;
+            for(auto& s: samples)
+            {
+                id += Form("%s %lld %lld %d\n", s->name.Data(), s->minRun, s->maxRun, s->N);
+                for(auto& f: s->filenames)
+                {
+                    TString indexfile = EventIndex::getIndexFilename(f);
+                    if(indexfile == "") canSave = false;
+                    id += indexfile+"\n";
+                }
+            }
+            TString key = getKey(id);
+
+            std::vector< std::vector<unsigned long long>* > vetoes;
+            bool loaded = canSave;
+            for(auto& s: samples)
+            {
+                vetoes.push_back(new std::vector<unsigned long long>());
+                if(loaded) loaded = readVeto(getFilename(key, s->name), s->N, *vetoes.back());
+            }
+
+            bool saved = loaded;
+            if(!loaded)
+            {
+                std::cout << "  /// Looking for duplicate events in the data \n";
+                saved = merge(samples, vetoes) && canSave;
+                for(unsigned int i=0; saved && i<samples.size(); i++)
+                    saved = writeVeto(getFilename(key, samples[i]->name), samples[i]->N, *vetoes[i]);
+            }
+
+            // the cached preselection lists of the data are named by the key, an unsaved veto has none
+            for(unsigned int i=0; i<samples.size(); i++)
+            {
+                if(samples[i]->veto != 0 && !samples[i]->isReader) delete samples[i]->veto;
+                samples[i]->veto = vetoes[i];
+                samples[i]->vetoKey = saved?key:"";
+            }
+        }
+
+    private:
+        // one per ntuple, in the order the events are kept
+        struct Source
+        {
+            unsigned int sample;
+            Long64_t offset;                        // chain entry of the first entry in the ntuple
+            EventIndex::RecordReader reader;
+            EventIndex::Record r;                   // the next record
+        };
+
+        // false if an ntuple couldn't be read, the samples with such a file keep all of their entries in their runs
+        static bool merge(const std::vector<Sample*>& samples, std::vector< std::vector<unsigned long long>* >& vetoes)
+        {
+            bool ok = true;
+            std::vector<Source*> sources;
+            for(unsigned int i=0; i<samples.size(); i++)
+            {
+                Sample* s = samples[i];
+                vetoes[i]->assign((s->N + 63)/64, 0);
+
+                std::vector<Source*> mine;
+                Long64_t offset = 0;
+                bool good = true;
+                for(auto& f: s->getLocalFilenames())
+                {
+                    mine.push_back(new Source());
+                    mine.back()->sample = i;
+                    mine.back()->offset = offset;
+                    good = mine.back()->reader.open(f) && good;
+                    offset += mine.back()->reader.nentries;
+                }
+                if(!good || offset != s->N)
+                {
+                    std::cout << Form("  !!! the event index for %s has %lld entries, the sample has %d, not vetoing its duplicate events \n",
+                                      s->name.Data(), offset, s->N);
+                    for(auto& src: mine) delete src;
+                    ok = false;
+                    if(s->hasRunRange()) vetoOutsideRuns(s, *vetoes[i]);
+                    continue;
+                }
+                sources.insert(sources.end(), mine.begin(), mine.end());
+            }
+
+            // smallest run, event first, the earlier source first for the copies of an event
+            auto later = [&sources](unsigned int a, unsigned int b)
+            {
+                const EventIndex::Record& ra = sources[a]->r;
+                const EventIndex::Record& rb = sources[b]->r;
+                if(ra.run != rb.run) return ra.run > rb.run;
+                if(ra.event != rb.event) return ra.event > rb.event;
+                return a > b;
+            };
+            std::priority_queue<unsigned int, std::vector<unsigned int>, decltype(later)> heap(later);
+            for(unsigned int k=0; k<sources.size(); k++)
+                if(sources[k]->reader.next(sources[k]->r)) heap.push(k);
+
+            std::vector<Long64_t> duplicates(samples.size(), 0);
+            std::vector<Long64_t> outside(samples.size(), 0);
+            bool kept = false;
+            Int_t keptRun = 0;
+            Long64_t keptEvent = 0;
+
+            while(!heap.empty())
+            {
+                unsigned int k = heap.top();
+                heap.pop();
+                Source& src = *sources[k];
+                Sample* s = samples[src.sample];
+
+                bool veto = true;
+                if(src.r.run < s->minRun || src.r.run > s->maxRun) outside[src.sample]++;
+                else if(kept && src.r.run == keptRun && src.r.event == keptEvent) duplicates[src.sample]++;
+                else
+                {
+                    veto = false;
+                    kept = true;
+                    keptRun = src.r.run;
+                    keptEvent = src.r.event;
+                }
+
+                if(veto)
+                {
+                    Long64_t entry = src.offset + src.r.entry;
+                    (*vetoes[src.sample])[entry >> 6] |= 1ULL << (entry & 63);
+                }
+                if(src.reader.next(src.r)) heap.push(k);
+            }
+
+            for(auto& src: sources)
+            {
+                ok = src->reader.ok && ok;
+                delete src;
+            }
+
+            for(unsigned int i=0; i<samples.size(); i++)
+                std::cout << Form("  /// %s: %lld duplicate events, %lld events outside runs %lld-%lld \n", samples[i]->name.Data(),
+                                  duplicates[i], outside[i], samples[i]->minRun, samples[i]->maxRun);
+            return ok;
+        }
+
+        // the runs= cut without the index, one pass over the event branch of each ntuple. If that fails too
+        // every entry is vetoed, dropping the era is easier to notice than counting its runs twice
+        static void vetoOutsideRuns(Sample* s, std::vector<unsigned long long>& veto)
+        {
+            Long64_t offset = 0;
+            Long64_t outside = 0;
+            bool good = true;
+            for(auto& f: s->getLocalFilenames())
+            {
+                TDirectory::TContext context;   // put gDirectory back when we are done
+                TFile* file = TFile::Open(f);
+                TTree* tree = (file != 0 && !file->IsZombie())?(TTree*) file->Get("dimuons/tree"):0;
+                TBranch* branch = (tree != 0)?tree->GetBranch("event"):0;
+                if(branch == 0)
+                {
+                    delete file;
+                    good = false;
+                    break;
+                }
+
+                EventInfo* info = 0;
+                branch->SetAddress(&info);
+                Long64_t nentries = tree->GetEntries();
+                for(Long64_t i=0; i<nentries && offset+i < s->N; i++)
+                {
+                    branch->GetEntry(i);
+                    if(info->run >= s->minRun && info->run <= s->maxRun) continue;
+                    Long64_t entry = offset + i;
+                    veto[entry >> 6] |= 1ULL << (entry & 63);
+                    outside++;
+                }
+                offset += nentries;
+
+                branch->ResetAddress();
+                delete info;
+                file->Close();
+                delete file;
+            }
+
+            if(!good || offset != s->N)
+            {
+                std::cout << Form("  !!! could not read the runs of %s either, vetoing all of its events \n", s->name.Data());
+                veto.assign(veto.size(), ~0ULL);
+                return;
+            }
+            std::cout << Form("  /// %s: %lld events outside runs %lld-%lld \n", s->name.Data(), outside, s->minRun, s->maxRun);
+        }
+
+        static TString getKey(TString id)
+        {
+            TMD5 md5;
+            md5.Update((const UChar_t*) id.Data(), id.Length());
+            md5.Final();
+            return md5.AsString();
+        }
+
+        static TString getFilename(TString key, TString sampleName)
+        {
+            return EventIndex::directory()+"/veto_"+key+"_"+sampleName+".bits";
+        }
+
+        // magic, nentries, the bits
+        static bool readVeto(TString filename, Long64_t nentries, std::vector<unsigned long long>& veto)
+        {
+            FILE* in = fopen(filename.Data(), "rb");
+            if(in == 0) return false;
+
+            char magic[8];
+            Long64_t n = -1;
+            veto.assign((nentries + 63)/64, 0);
+            bool ok = fread(magic, 1, 8, in) == 8 && memcmp(magic, "EVTVETO1", 8) == 0 &&
+                      fread(&n, sizeof(Long64_t), 1, in) == 1 && n == nentries &&
+                      fread(veto.data(), sizeof(unsigned long long), veto.size(), in) == veto.size();
+            fclose(in);
+            return ok;
+        }
+
+        // to a temporary name first so that a partial veto is never read
+        static bool writeVeto(TString filename, Long64_t nentries, const std::vector<unsigned long long>& veto)
+        {
+            gSystem->mkdir(EventIndex::directory(), true);
+            TString partial = filename+Form(".part%d", gSystem->GetPid());
+            FILE* out = fopen(partial.Data(), "wb");
+            if(out == 0)
+            {
+                std::cout << Form("  !!! could not write the event veto %s \n", filename.Data());
+                return false;
+            }
+            bool ok = fwrite("EVTVETO1", 1, 8, out) == 8 && fwrite(&nentries, sizeof(Long64_t), 1, out) == 1 &&
+                      fwrite(veto.data(), sizeof(unsigned long long), veto.size(), out) == veto.size();
+            ok = (fclose(out) == 0) && ok;
+            if(!ok || gSystem->Rename(partial, filename) != 0)
+            {
+                std::cout << Form("  !!! could not write the event veto %s \n", filename.Data());
+                gSystem->Unlink(partial);
+                return false;
+            }
+            return true;
+        }
+};
+
+#endif
@@ -0,0 +1,143 @@
+///////////////////////////////////////////////////////////////////////////
+// ======================================================================//
+// FastHist.h                                                            //
+// ======================================================================//
+// Fixed binning histogram as flat arrays of sumw and sumw2, with the    //
+// under and overflow at 0 and bins+1 like TH1. No ROOT objects, no      //
+// gDirectory, no global lock, so each worker thread can fill its own.   //
+// Same binning and Scale/Add behavior as a TH1D with Sumw2.             //
+// toTH1D makes the ROOT histogram once all of the filling is done.      //
+// TreeReduction adds the shards from the workers in a fixed pairwise    //
+// order so the result doesn't depend on which thread finished first.    //
+// ======================================================================//
+///////////////////////////////////////////////////////////////////////////
+
+#ifndef ADD_FASTHIST
+#define ADD_FASTHIST
+
+#include "TH1D.h"
+#include "TString.h"
+
+#include <vector>
+#include <utility>
+#include <cmath>
+
+class FastHist
+{
+    public:
+        FastHist(){};
+        FastHist(int ibins, double imin, double imax)
+        {
+            bins = ibins;
+            min = imin;
+            max = imax;
+            sumw.assign(bins+2, 0);
+            sumw2.assign(bins+2, 0);
+        };
+        ~FastHist(){};
+
+        int bins = 0;
+        double min = 0;
+        double max = 0;
+        double entries = 0;
+
+        std::vector<double> sumw;     // [0] underflow, [1, bins] the bins, [bins+1] overflow
+        std::vector<double> sumw2;
+
+        // same as TAxis::FindFixBin, NaN goes to the overflow
+        int findBin(double x) const
+        {
+            if(x < min) return 0;
+            if(!(x < max)) return bins+1;
+            return 1 + int(bins*(x - min)/(max - min));
+        }
+
+        void fill(double x, double w = 1)
+        {
+            int bin = findBin(x);
+            sumw[bin]  += w;
+            sumw2[bin] += w*w;
+            entries++;
+        }
+
+        // the errors scale with c like TH1::Scale with Sumw2
+        void scale(double c)
+        {
+            for(unsigned int b=0; b<sumw.size(); b++)
+            {
+                sumw[b]  *= c;
+                sumw2[b] *= c*c;
+            }
+        }
+
+        // the binning has to match
+        void add(const FastHist& other)
+        {
+            for(unsigned int b=0; b<sumw.size(); b++)
+            {
+                sumw[b]  += other.sumw[b];
+                sumw2[b] += other.sumw2[b];
+            }
+            entries += other.entries;
+        }
+
+        // the caller owns the histogram, it is kept out of gDirectory.
+        // the mean and rms come from the bin centers since the filled values are gone
+        TH1D* toTH1D(TString name, TString title) const
+        {
+            TH1D* h = new TH1D(name, title, bins, min, max);
+            h->SetDirectory(0);
+            if(h->GetSumw2N() == 0) h->Sumw2();
+            for(int b=0; b<bins+2; b++)
+            {
+                h->SetBinContent(b, sumw[b]);
+                h->SetBinError(b, std::sqrt(sumw2[b]));
+            }
+            h->ResetStats();
+            h->SetEntries(entries);
+            return h;
+        }
+};
+
+// Sum of a sequence of T that have add(const T&), paired up as ((0+1)+(2+3))+((4+5)+...).
+// Only keeps one partial sum per level of the tree, push the items in the same order to get the same result.
+template <class T>
+class TreeReduction
+{
+    public:
+        void push(T item)
+        {
+            unsigned int level = 0;
+            while(!partial.empty() && partial.back().first == level)
+            {
+                T left = std::move(partial.back().second);
+                partial.pop_back();
+                left.add(item);
+                item = std::move(left);
+                level++;
+            }
+            partial.push_back(std::make_pair(level, std::move(item)));
+        }
+
+        bool empty() const { return partial.empty(); };
+
+        // add up the levels that are left over, the latest (smallest) ones first
+        T result()
+        {
+            T sum = std::move(partial.back().second);
+            partial.pop_back();
+            while(!partial.empty())
+            {
+                T left = std::move(partial.back().second);
+                partial.pop_back();
+                left.add(sum);
+                sum = std::move(left);
+            }
+            return sum;
+        }
+
+    private:
+        std::vector< std::pair<unsigned int, T> > partial;
+};
+
+#endif
@@ -0,0 +1,295 @@
+///////////////////////////////////////////////////////////////////////////
+// ======================================================================//
+// FileMirror.h                                                          //
+// ======================================================================//
+// Local copies of remote ntuples, e.g. root://eoscms.cern.ch//store/..  //
+// so that only the first run streams them. Sample asks for the local    //
+// path of each file, remote files are copied into the mirror directory  //
+// under the md5 of their path, size, and modification time, so a file   //
+// that changed on the server gets a new copy. The mirror keeps an index //
+// with the last time each copy was used and removes the least recently  //
+// used copies to stay under the size limit, except the ones this job    //
+// already handed out. Jobs can share a mirror, the index is merged with //
+// the one on disk under a lock file before it is saved. Off until       //
+// setup() is given a directory. Which paths count as remote is a list   //
+// of prefixes, add a local directory to try it without a server.        //
+// ======================================================================//
+///////////////////////////////////////////////////////////////////////////
+
+#ifndef ADD_FILEMIRROR
+#define ADD_FILEMIRROR
+
+#include "TString.h"
+#include "TSystem.h"
+#include "TFile.h"
+#include "TMD5.h"
+
+#include <map>
+#include <set>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+
+class FileMirror
+{
+    public:
+        struct CopyInfo
+        {
+            TString remote;            // where the copy came from
+            Long64_t size = 0;         // bytes
+            Long64_t lastUsed = 0;     // microseconds since the epoch
+        };
+
+        // dir = "" turns the mirror off, maxGB is the most the copies may take up together
+        static void setup(TString dir, double maxGB = 100)
+        {
+            std::lock_guard<std::mutex> lock(mutex());
+            mirrordir() = dir;
+            maxBytes() = (Long64_t)(maxGB*1e9);
+            index().clear();
+            pinned().clear();
+            removed().clear();
+            if(dir == "") return;
+
+            gSystem->mkdir(dir, true);
+            IndexLock indexLock;
+            loadIndex();
+        }
+
+        static bool enabled() { return mirrordir() != ""; };
+
+        static std::vector<TString>& remotePrefixes()
+        {
+            static std::vector<TString> prefixes = {"root://", "http://", "https://"};
+            return prefixes;
+        }
+
+        static bool isRemote(TString filename)
+        {
+            for(auto& prefix: remotePrefixes())
+                if(filename.BeginsWith(prefix)) return true;
+            return false;
+        }
+
+        // the local copy of a remote file, the filename itself if it is local, the mirror is off,
+        // or the copy failed
+        static TString get(TString filename)
+        {
+            if(!enabled() || !isRemote(filename)) return filename;
+
+            Long64_t size = -1;
+            Long_t mtime = -1;
+            getStat(filename, size, mtime);
+
+            std::lock_guard<std::mutex> lock(mutex());
+            TString key = getKey(filename, size, mtime);
+            TString local = getLocalPath(key, filename);
+
+            // still there from an earlier run or another job, copies only get their name once they are complete
+            if(!gSystem->AccessPathName(local))
+            {
+                CopyInfo& info = index()[key];
+                info.remote = filename;
+                info.lastUsed = now();
+                if(info.size <= 0) getStat(local, info.size, mtime);
+                pinned().insert(key);
+                saveIndex();
+                return local;
+            }
+
+            if(size > maxBytes())
+            {
+                std::cout << Form("  !!! %s is bigger than the mirror, reading it remotely \n", filename.Data());
+                return filename;
+            }
+            if(size > 0 && !evict(size))
+            {
+                std::cout << Form("  !!! the mirror is full of files this job reads, reading %s remotely \n", filename.Data());
+                return filename;
+            }
+
+            // copy to a temporary name first so that a failed copy never looks like a good one,
+            // the pid keeps the jobs sharing the mirror from writing to the same one
+            std::cout << Form("  /// Mirroring %s to %s \n", filename.Data(), local.Data());
+            TString partial = local+Form(".part%d", gSystem->GetPid());
+            if(!TFile::Cp(filename, partial, false) || gSystem->Rename(partial, local) != 0)
+            {
+                std::cout << Form("  !!! could not mirror %s, reading it remotely \n", filename.Data());
+                gSystem->Unlink(partial);
+                return filename;
+            }
+
+            CopyInfo info;
+            info.remote = filename;
+            info.lastUsed = now();
+            getStat(local, info.size, mtime);
+            index()[key] = info;
+            removed().erase(key);
+            pinned().insert(key);
+            if(size <= 0) evict(0);    // didn't know the size before the copy
+            saveIndex();
+            return local;
+        }
+
+        // bytes used by all of the copies
+        static Long64_t usedBytes()
+        {
+            Long64_t used = 0;
+            for(auto& c: index())
+                used += c.second.size;
+            return used;
+        }
+
+    private:
+        static TString& mirrordir()                  { static TString dir = ""; return dir; }
+        static Long64_t& maxBytes()                  { static Long64_t bytes = 100000000000LL; return bytes; }
+        static std::map<TString, CopyInfo>& index()  { static std::map<TString, CopyInfo> copies; return copies; }
+        static std::mutex& mutex()                   { static std::mutex m; return m; }
+        static std::set<TString>& pinned()           { static std::set<TString> keys; return keys; }    // handed out by this job
+        static std::set<TString>& removed()          { static std::set<TString> keys; return keys; }    // evicted by this job
+        static TString indexfile()                   { return mirrordir()+"/mirror_index.txt"; }
+
+        // held while reading and writing the index, the other jobs using the mirror wait for it
+        class IndexLock
+        {
+            public:
+                IndexLock()
+                {
+                    fd = open((mirrordir()+"/mirror_index.lock").Data(), O_RDWR | O_CREAT, 0644);
+                    if(fd >= 0) flock(fd, LOCK_EX);
+                }
+                ~IndexLock()
+                {
+                    if(fd < 0) return;
+                    flock(fd, LOCK_UN);
+                    close(fd);
+                }
+
+            private:
+                int fd = -1;
+        };
+
+        static Long64_t now()
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
+        static void getStat(TString filename, Long64_t& size, Long_t& mtime)
+        {
+            Long_t id, flags;
+            if(gSystem->GetPathInfo(filename, &id, &size, &flags, &mtime) != 0)
+            {
+                size = -1;
+                mtime = -1;
+            }
+        }
+
+        // if the server can't tell us the size and mtime, the path alone is the key and the copy is trusted
+        static TString getKey(TString filename, Long64_t size, Long_t mtime)
+        {
+            TString id = Form("%s %lld %ld", filename.Data(), size, mtime);
+            TMD5 md5;
+            md5.Update((const UChar_t*) id.Data(), id.Length());
+            md5.Final();
+            return md5.AsString();
+        }
+
+        // keep the name of the file at the end to make the mirror easier to look through
+        static TString getLocalPath(TString key, TString filename)
+        {
+            return mirrordir()+"/"+key+"_"+gSystem->BaseName(filename);
+        }
+
+        // remove the least recently used copies until there is room for bytes more. The copies this job
+        // handed out stay, false if there isn't room without them
+        static bool evict(Long64_t bytes)
+        {
+            IndexLock indexLock;
+            loadIndex();    // count the copies the other jobs made too
+
+            Long64_t used = usedBytes();
+            while(used + bytes > maxBytes())
+            {
+                auto oldest = index().end();
+                for(auto c = index().begin(); c != index().end(); c++)
+                {
+                    if(pinned().count(c->first)) continue;
+                    if(oldest == index().end() || c->second.lastUsed < oldest->second.lastUsed) oldest = c;
+                }
+                if(oldest == index().end()) return false;
+
+                std::cout << Form("  /// Removing %s from the mirror \n", oldest->second.remote.Data());
+                gSystem->Unlink(getLocalPath(oldest->first, oldest->second.remote));
+                used -= oldest->second.size;
+                removed().insert(oldest->first);
+                index().erase(oldest);
+            }
+            return true;
+        }
+
+        // merge the index on disk into the one in memory, call it with the IndexLock held. The copies we
+        // removed stay out, the ones another job removed are dropped once their file is gone
+        static void loadIndex()
+        {
+            std::map<TString, CopyInfo> saved;
+            std::ifstream in(indexfile().Data());
+            std::string line;
+            while(std::getline(in, line))
+            {
+                if(line.empty() || line[0] == '#') continue;
+                std::stringstream ss(line);
+                std::string key, remote;
+                CopyInfo info;
+                if(!(ss >> key >> info.size >> info.lastUsed >> remote)) continue;
+                info.remote = remote.c_str();
+                saved[key.c_str()] = info;
+            }
+
+            for(auto c = index().begin(); c != index().end();)
+            {
+                if(saved.count(c->first) == 0 && gSystem->AccessPathName(getLocalPath(c->first, c->second.remote))) c = index().erase(c);
+                else c++;
+            }
+            for(auto& c: saved)
+            {
+                if(removed().count(c.first)) continue;
+                auto mine = index().find(c.first);
+                if(mine == index().end()) index()[c.first] = c.second;
+                else mine->second.lastUsed = std::max(mine->second.lastUsed, c.second.lastUsed);
+            }
+        }
+
+        // through a temporary file so that the other jobs never read half of an index
+        static void saveIndex()
+        {
+            IndexLock indexLock;
+            loadIndex();
+
+            TString partial = indexfile()+Form(".part%d", gSystem->GetPid());
+            std::ofstream out(partial.Data());
+            if(!out)
+            {
+                std::cout << Form("  !!! could not write the mirror index %s \n", indexfile().Data());
+                return;
+            }
+            out << "# key size lastUsed remote" << std::endl;
+            for(auto& c: index())
+                out << c.first.Data() << " " << c.second.size << " " << c.second.lastUsed << " " << c.second.remote.Data() << std::endl;
+            out.close();
+            if(!out || gSystem->Rename(partial, indexfile()) != 0)
+            {
+                std::cout << Form("  !!! could not write the mirror index %s \n", indexfile().Data());
+                gSystem->Unlink(partial);
+            }
+        }
+};
+
+#endif
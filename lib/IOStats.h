@@ -0,0 +1,52 @@
+///////////////////////////////////////////////////////////////////////////
+// ======================================================================//
+// IOStats.h                                                             //
+// ======================================================================//
+// What reading a sample cost: bytes and read calls to the files, time   //
+// spent unzipping baskets, and how often the TTreeCache had the basket. //
+// Sample::getIOStats fills one from the TTreePerfStats of its chain,    //
+// add() sums the readers of a sample, output() prints one line.         //
+// ======================================================================//
+///////////////////////////////////////////////////////////////////////////
+
+#ifndef ADD_IOSTATS
+#define ADD_IOSTATS
+
+#include "TString.h"
+
+#include <iostream>
+
+struct IOStats
+{
+    TString name;
+    Long64_t bytesRead = 0;       // from the files, after the cache
+    Long64_t readCalls = 0;       // calls to the file system, one per cache fill when the cache works
+    double diskTime = 0;          // seconds waiting for the reads
+    double unzipTime = 0;         // seconds decompressing baskets
+    double cacheHitBytes = 0;     // bytesRead*hit rate, summed so the rate can be weighted over the readers
+
+    double cacheHitRate() const { return (bytesRead > 0) ? cacheHitBytes/bytesRead : 0; };
+
+    void add(const IOStats& other)
+    {
+        if(name == "") name = other.name;
+        bytesRead     += other.bytesRead;
+        readCalls     += other.readCalls;
+        diskTime      += other.diskTime;
+        unzipTime     += other.unzipTime;
+        cacheHitBytes += other.cacheHitBytes;
+    }
+
+    static void outputHeader()
+    {
+        std::cout << Form("  %-24s %10s %10s %9s %9s %9s", "sample", "MB read", "reads", "disk (s)", "unzip (s)", "cache hit") << std::endl;
+    }
+
+    void output() const
+    {
+        std::cout << Form("  %-24s %10.2f %10lld %9.2f %9.2f %8.1f%%", name.Data(), bytesRead/1e6, readCalls, diskTime, unzipTime,
+                          100*cacheHitRate()) << std::endl;
+    }
+};
+
+#endif
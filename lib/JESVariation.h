@@ -0,0 +1,121 @@
+///////////////////////////////////////////////////////////////////////////
+// ======================================================================//
+// JESVariation.h                                                        //
+// ======================================================================//
+// The jet dependent values for a JES_up or JES_down variation.          //
+// Loaded from the *_JES_up/down branches alongside the nominal ones     //
+// so that all of the systematics run in one event loop.                 //
+// swap(vars) exchanges these values with the nominal ones in the VarSet //
+// so the usual cleaning and categorization see the shifted jets.        //
+// Call swap(vars) again to put the nominal values back.                 //
+// ======================================================================//
+///////////////////////////////////////////////////////////////////////////
+
+#ifndef ADD_JESVARIATION
+#define ADD_JESVARIATION
+
+#include "VarSet.h"
+#include "BranchSet.h"
+#include "TChain.h"
+#include "TBranch.h"
+
+#include <utility>
+
+class JESVariation
+{
+    public:
+        JESVariation(){};
+        ~JESVariation(){};
+
+        TString name;   // JES_up or JES_down
+
+        // values loaded from the ttree
+        Int_t nJets;
+        Int_t nJetsCent;
+        Int_t nJetsFwd;
+        Int_t nBLoose;
+        Int_t nBMed;
+        Int_t nBTight;
+        MhtInfo* mht = 0;
+        MetInfo* met = 0;
+        std::vector<SlimJetInfo>* jets = 0;
+        std::vector<JetPairInfo>* jetPairs = 0;
+
+        // the branches for the values above
+        TBranch* b_nJets     = 0;
+        TBranch* b_nJetsCent = 0;
+        TBranch* b_nJetsFwd  = 0;
+        TBranch* b_nBLoose   = 0;
+        TBranch* b_nBMed     = 0;
+        TBranch* b_nBTight   = 0;
+        TBranch* b_mht       = 0;
+        TBranch* b_met       = 0;
+        TBranch* b_jets      = 0;
+        TBranch* b_jetPairs  = 0;
+
+        void setBranchAddresses(TChain* chain, TString iname)
+        {
+            name = iname;
+            b_jets      = chain->GetBranch("jets_"+name);
+            b_jetPairs  = chain->GetBranch("jetPairs_"+name);
+            b_mht       = chain->GetBranch("mht_"+name);
+            b_met       = chain->GetBranch("met_"+name);
+            b_nJets     = chain->GetBranch("nJets_"+name);
+            b_nJetsCent = chain->GetBranch("nJetsCent_"+name);
+            if(name == "JES_down") b_nJetsFwd = chain->GetBranch("nJetsFws_JES_down");  // typo in analyzer collection
+            else                   b_nJetsFwd = chain->GetBranch("nJetsFwd_"+name);
+            b_nBLoose   = chain->GetBranch("nBLoose_"+name);
+            b_nBMed     = chain->GetBranch("nBMed_"+name);
+            b_nBTight   = chain->GetBranch("nBTight_"+name);
+
+            if(b_jets      != 0) b_jets->SetAddress(&jets);
+            if(b_jetPairs  != 0) b_jetPairs->SetAddress(&jetPairs);
+            if(b_mht       != 0) b_mht->SetAddress(&mht);
+            if(b_met       != 0) b_met->SetAddress(&met);
+            if(b_nJets     != 0) b_nJets->SetAddress(&nJets);
+            if(b_nJetsCent != 0) b_nJetsCent->SetAddress(&nJetsCent);
+            if(b_nJetsFwd  != 0) b_nJetsFwd->SetAddress(&nJetsFwd);
+            if(b_nBLoose   != 0) b_nBLoose->SetAddress(&nBLoose);
+            if(b_nBMed     != 0) b_nBMed->SetAddress(&nBMed);
+            if(b_nBTight   != 0) b_nBTight->SetAddress(&nBTight);
+        }
+
+        // only read the variations of the nominal branches that are active,
+        // the bytes count towards the nominal branches
+        void getEntry(int i, BranchSet& nominal)
+        {
+            getEntry(b_jets,      BranchSet::kJets,      i, nominal);
+            getEntry(b_jetPairs,  BranchSet::kJetPairs,  i, nominal);
+            getEntry(b_mht,       BranchSet::kMht,       i, nominal);
+            getEntry(b_met,       BranchSet::kMet,       i, nominal);
+            getEntry(b_nJets,     BranchSet::kNJets,     i, nominal);
+            getEntry(b_nJetsCent, BranchSet::kNJetsCent, i, nominal);
+            getEntry(b_nJetsFwd,  BranchSet::kNJetsFwd,  i, nominal);
+            getEntry(b_nBLoose,   BranchSet::kNBLoose,   i, nominal);
+            getEntry(b_nBMed,     BranchSet::kNBMed,     i, nominal);
+            getEntry(b_nBTight,   BranchSet::kNBTight,   i, nominal);
+        }
+
+        void getEntry(TBranch* b, int id, int i, BranchSet& nominal)
+        {
+            if(b != 0 && (nominal.active & BranchSet::bit(id))) nominal.bytesRead[id] += b->GetEntry(i);
+        }
+
+        // only swaps pointers and ints, no collections are copied
+        // swap back before the next GetEntry so the branches fill the right objects
+        void swap(VarSet& vars)
+        {
+            std::swap(vars.jets, jets);
+            std::swap(vars.jetPairs, jetPairs);
+            std::swap(vars.mht, mht);
+            std::swap(vars.met, met);
+            std::swap(vars.nJets, nJets);
+            std::swap(vars.nJetsCent, nJetsCent);
+            std::swap(vars.nJetsFwd, nJetsFwd);
+            std::swap(vars.nBLoose, nBLoose);
+            std::swap(vars.nBMed, nBMed);
+            std::swap(vars.nBTight, nBTight);
+        }
+};
+
+#endif
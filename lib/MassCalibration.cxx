@@ -16,7 +16,6 @@
 
 #include "MassCalibration.h"
 
-#include "TMinuit.h"
 #include "TGraphAsymmErrors.h"
 #include "TGraphErrors.h"
 #include "TString.h"
@@ -26,8 +25,20 @@
 #include "TStyle.h"
 #include "TF1.h"
 #include "TGraph.h"
+#include "TStopwatch.h"
+#include "TMath.h"
+
+#include "Fit/Fitter.h"
+#include "Fit/BinData.h"
+#include "Fit/DataRange.h"
+#include "HFitInterface.h"
+#include "Math/WrappedMultiTF1.h"
+
+#include "ThreadPool.hxx"
 
 #include <sstream>
+#include <mutex>
+#include <future>
 #include <cmath>
 #include <iostream>
 
@@ -262,7 +273,7 @@ void MassCalibration::fill(Float_t xvalue, Float_t massvalue, double weight)
 // ----------------------------------------------------------------------
 //////////////////////////////////////////////////////////////////////////
 
-VoigtFitInfo MassCalibration::fit(TH1D* inhist, Float_t x, Float_t x_err)
+VoigtFitInfo MassCalibration::fit(TH1D* inhist, Float_t x, Float_t x_err, const VoigtFitInfo* start)
 {
     //std::cout << Form("==== Fitting %s ==== \n", inhist->GetTitle());
     
@@ -276,49 +287,97 @@ VoigtFitInfo MassCalibration::fit(TH1D* inhist, Float_t x, Float_t x_err)
     
     vfi.hrms = inhist->GetRMS();
     vfi.hrms_err = inhist->GetRMSError();
+    vfi.hintegral = inhist->Integral();
     
-    // Display fit info on canvas.
-    gStyle->SetOptFit(0011);
     // Fit things.
     TString fitname = TString("fit_")+massname+"_"+xname+Form("_%5.2f", x);
     fitname.ReplaceAll(" ", "");
     fitname.ReplaceAll(".", "p");
-    TF1* fit = new TF1(fitname, "[0]*TMath::Voigt(x - [1], [2], [3])", massmin, massmax);
+    TF1* fit = 0;
+    {
+        // making a TF1 compiles the formula and adds it to gROOT, one thread at a time
+        static std::mutex tf1Mutex;
+        std::lock_guard<std::mutex> lock(tf1Mutex);
+        fit = new TF1(fitname, "[0]*TMath::Voigt(x - [1], [2], [3])", massmin, massmax);
+    }
     fit->SetParNames("Constant", "Mean", "Sigma", "Gamma");
     
     float initial_sigma = vfi.hrms - voigt_gamma;
     if(initial_sigma < 0) initial_sigma = vfi.hrms/100;
+    float window = fitsig*vfi.hrms;
+
+    // An unchanged histogram with the same fit settings gets the same result
+    TString key = VoigtFitCache::getKey(inhist, Form("%.6g %.6g %.6g %.6g", massmin, massmax, fitsig, voigt_gamma));
+    VoigtFitCache::FitResult result;
+    if(VoigtFitCache::get(key, result))
+    {
+        fit->SetParameters(result.constant, result.mean, result.sigma, result.gamma);
+        fit->SetParError(0, result.constant_err);
+        fit->SetParError(1, result.mean_err);
+        fit->SetParError(2, result.sigma_err);
+        fit->SetParError(3, result.gamma_err);
+        vfi.converged = result.converged;
+        vfi.cached = true;
+    }
+    else
+    {
+        // Reasonable initial guesses for the fit parameters
+        fit->SetParameters(inhist->GetMaximum(), inhist->GetMean(), initial_sigma, voigt_gamma);
+        fit->SetParLimits(2, 0, 10*initial_sigma);
+        fit->SetParLimits(1, massmin, massmax);
 
-    // Reasonable initial guesses for the fit parameters
-    fit->SetParameters(inhist->GetMaximum(), inhist->GetMean(), initial_sigma, voigt_gamma);
-    fit->SetParLimits(2, 0, 10*initial_sigma);
-    fit->SetParLimits(1, massmin, massmax);
+        //std::cout << Form("sigma = %f, in (%f, %f)", initial_sigma, 0, 2*vfi.hrms);
 
-    //std::cout << Form("sigma = %f, in (%f, %f)", initial_sigma, 0, 2*vfi.hrms);
+        // Fix the intrinsic width to the theoretical value
+        fit->FixParameter(3, voigt_gamma);
 
-    // Fix the intrinsic width to the theoretical value
-    fit->FixParameter(3, voigt_gamma);
+        bool converged = false;
 
-    // Sometimes we have to fit the data a few times before the fit converges
-    bool converged = 0;
-    int ntries = 0;
+        // Start from the neighboring bin. Its mean centers the fit window, so we skip the fit to the whole range,
+        // and only fit again if the mean moved enough to shift the window
+        if(start != 0 && start->converged && start->hintegral > 0)
+        {
+            fit->SetParameter(0, start->vconst*vfi.hintegral/start->hintegral);
+            fit->SetParameter(1, start->vmean);
+            if(start->vsigma > 0 && start->vsigma < 10*initial_sigma) fit->SetParameter(2, start->vsigma);
+
+            converged = fitInRange(inhist, fit, start->vmean - window, start->vmean + window);
+            if(converged && TMath::Abs(fit->GetParameter(1) - start->vmean) > 0.1*window)
+                converged = fitInRange(inhist, fit, fit->GetParameter(1) - window, fit->GetParameter(1) + window);
+            if(!converged) fit->SetParameters(inhist->GetMaximum(), inhist->GetMean(), initial_sigma, voigt_gamma);
+        }
+
+        // Sometimes we have to fit the data a few times before the fit converges
+        int ntries = 0;
     
-    // Make sure the fit converges.
-    while(!converged) 
-    {
-      if(ntries >= 50) break;
-      fit->SetParameter(2, initial_sigma);
-      inhist->Fit(fitname, "q");
-
-      // Fit to a width of fitsig sigmas
-      inhist->Fit(fitname,"q","", fit->GetParameter(1) - fitsig*vfi.hrms, fit->GetParameter(1) + fitsig*vfi.hrms);
-      //inhist->Fit(fitname,"q","", massmin, massmax);
-      TString sconverge = gMinuit->fCstatu.Data();
-      converged = sconverge.Contains(TString("CONVERGED"));
-      ntries++; 
+        // Make sure the fit converges.
+        while(!converged) 
+        {
+          if(ntries >= 50) break;
+          fit->SetParameter(2, initial_sigma);
+          fitInRange(inhist, fit, massmin, massmax);
+
+          // Fit to a width of fitsig sigmas
+          converged = fitInRange(inhist, fit, fit->GetParameter(1) - window, fit->GetParameter(1) + window);
+          ntries++; 
+        }
+
+        vfi.converged = converged;
+        result.constant = fit->GetParameter(0);
+        result.constant_err = fit->GetParError(0);
+        result.mean = fit->GetParameter(1);
+        result.mean_err = fit->GetParError(1);
+        result.sigma = fit->GetParameter(2);
+        result.sigma_err = fit->GetParError(2);
+        result.gamma = fit->GetParameter(3);
+        result.gamma_err = fit->GetParError(3);
+        result.converged = converged;
+        VoigtFitCache::put(key, result);
     }
 
     vfi.fit = fit;
+    vfi.vconst = fit->GetParameter(0);
+    vfi.vconst_err = fit->GetParError(0);
     vfi.vmean = fit->GetParameter(1);
     vfi.vmean_err = fit->GetParError(1);
     vfi.vsigma = fit->GetParameter(2);
@@ -333,22 +392,90 @@ VoigtFitInfo MassCalibration::fit(TH1D* inhist, Float_t x, Float_t x_err)
 // ----------------------------------------------------------------------
 //////////////////////////////////////////////////////////////////////////
 
-void MassCalibration::fit()
+bool MassCalibration::fitInRange(TH1D* h, TF1* f, double min, double max)
+{
+// Same chi2 fit as h->Fit(f, "q", "", min, max), but the fitter and its Minuit2 minimizer
+// belong to this call instead of the global gMinuit, so other threads can fit at the same time
+    ROOT::Fit::DataOptions options;
+    ROOT::Fit::DataRange range(min, max);
+    ROOT::Fit::BinData data(options, range);
+    ROOT::Fit::FillData(data, h);
+    if(data.Size() == 0) return false;
+
+    ROOT::Math::WrappedMultiTF1 function(*f, 1);
+    ROOT::Fit::Fitter fitter;
+    fitter.Config().SetMinimizer("Minuit2", "Migrad");
+    fitter.SetFunction(function, false);
+
+    // the limits and fixed parameters from the TF1, the same way TH1::Fit reads them
+    for(int p=0; p<f->GetNpar(); p++)
+    {
+        double low, high;
+        f->GetParLimits(p, low, high);
+        ROOT::Fit::ParameterSettings& par = fitter.Config().ParSettings(p);
+        if(low*high != 0 && low >= high) par.Fix();
+        else if(low < high) par.SetLimits(low, high);
+    }
+
+    bool ok = fitter.Fit(data);
+    if(!fitter.Result().IsEmpty()) f->SetFitResult(fitter.Result());
+    return ok && fitter.Result().IsValid();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ----------------------------------------------------------------------
+//////////////////////////////////////////////////////////////////////////
+
+void MassCalibration::fit(int nthreads)
 {
+// The bins are split into nthreads blocks of neighboring bins. Each thread fits its block in order,
+// starting each fit from the one before it, the first bin of a block starts from the histogram alone
+    TStopwatch watch;
+    watch.Start();
+
+    // Display fit info on canvas.
+    gStyle->SetOptFit(0011);
+    VoigtFitCache::load();
+
+    vfis.assign(histos.size(), VoigtFitInfo());
+    auto fitBlock = [this](unsigned int first, unsigned int last)
+    {
+        for(unsigned int h=first; h<last; h++)
+            vfis[h] = fit(histos[h], (binning[h+1] + binning[h])/2, (binning[h+1] - binning[h])/2, (h > first)?&vfis[h-1]:0);
+        return last - first;
+    };
+
+    unsigned int nblocks = TMath::Min((unsigned int)TMath::Max(nthreads, 1), (unsigned int)histos.size());
+    if(nblocks <= 1) fitBlock(0, histos.size());
+    else
+    {
+        ThreadPool pool(nblocks);
+        std::vector< std::future<unsigned int> > results;
+        for(unsigned int b=0; b<nblocks; b++)
+            results.push_back(pool.enqueue(fitBlock, b*histos.size()/nblocks, (b+1)*histos.size()/nblocks));
+        for(auto& result: results)
+            result.get();
+    }
+
+    // the histograms keep their fit like TH1::Fit did, for the saved plots
+    nCachedFits = 0;
     for(unsigned int h=0; h<histos.size(); h++)
     {
-        VoigtFitInfo vfi = fit(histos[h], (binning[h+1] + binning[h])/2, (binning[h+1] - binning[h])/2);
-        vfis.push_back(vfi);
+        histos[h]->GetListOfFunctions()->Add(vfis[h].fit);
+        if(vfis[h].cached) nCachedFits++;
     }
+
+    VoigtFitCache::save();
+    fitTime = watch.RealTime();
 }
 
 //////////////////////////////////////////////////////////////////////////
 // ----------------------------------------------------------------------
 //////////////////////////////////////////////////////////////////////////
 
-void MassCalibration::plot()
+void MassCalibration::plot(int nthreads)
 {
-    fit();
+    fit(nthreads);
     mean_vs_x = new TGraphErrors();
     resolution_vs_x = new TGraphErrors();
     for(unsigned int i=0; i<vfis.size(); i++)
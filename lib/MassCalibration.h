@@ -5,7 +5,8 @@
 // Plot Z Mass Resolution vs mu+/- eta, mu+/- phi, etc.                  //
 // Creates mass histograms in different bins of some x variable.         //
 // The object can then fit the histograms with a Voigtian and plot       //
-// the voigt fit mean/resolution vs x.                                   //
+// the voigt fit mean/resolution vs x. The x bins are fit in parallel,   //
+// each fit starts from the one before it, results are cached.           //
 // ======================================================================//
 ///////////////////////////////////////////////////////////////////////////
 
@@ -16,6 +17,7 @@
 #include "TGraphErrors.h"
 #include "TCanvas.h"
 #include "TH1D.h"
+#include "TF1.h"
 #include "TGraph.h"
 #include "TGraphAsymmErrors.h"
 #include "TFile.h"
@@ -24,6 +26,7 @@
 #include "TPaveStats.h"
 
 #include "Sample.h"
+#include "VoigtFitCache.h"
 #include <fstream>
 
 ///////////////////////////////////////////////////////////////////////////
@@ -49,6 +52,12 @@ struct VoigtFitInfo
   Float_t vsigma_err = -999;
   Float_t vgamma = -999;
   Float_t vgamma_err = -999;
+  Float_t vconst = -999;
+  Float_t vconst_err = -999;
+
+  Float_t hintegral = -999;   // to scale the constant when the next bin starts from this fit
+  bool converged = false;
+  bool cached = false;        // the result came from the VoigtFitCache
 
   Float_t x = -999;
   Float_t x_err = -999;
@@ -121,15 +130,22 @@ class MassCalibration
         void fill(Float_t xvalue, Float_t massvalue, Double_t weight);
         int whichTH1D(Float_t xvalue);
 
-        // Fit a single histogram with a voigtian
-        VoigtFitInfo fit(TH1D* inhist, Float_t x, Float_t x_err);
+        // Fit a single histogram with a voigtian, starting from the fit of the
+        // neighboring bin if there is one. Doesn't use gMinuit so the bins can be fit in parallel
+        VoigtFitInfo fit(TH1D* inhist, Float_t x, Float_t x_err, const VoigtFitInfo* start = 0);
 
-        // Fit all of the histograms with voigtians
+        // Fit all of the histograms with voigtians on nthreads threads
         // Save fit info (mean/resolution) to vfis
-        void fit();
+        void fit(int nthreads = 1);
+        double fitTime = 0;        // wall time of the last fit() in seconds
+        int nCachedFits = 0;       // how many of its fits came from the VoigtFitCache
        
         // create mean_vs_x and resolution_vs_x TGraphs 
-        void plot();
+        void plot(int nthreads = 1);
+
+    protected:
+        // chi2 fit of f to the bins of h in [min, max] with Minuit2, false if it didn't converge
+        static bool fitInRange(TH1D* h, TF1* f, double min, double max);
 };
 
 #endif
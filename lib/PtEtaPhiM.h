@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////////
+// ======================================================================//
+// PtEtaPhiM.h                                                           //
+// ======================================================================//
+// Light weight kinematics for the cleaned collections in the VarSet.    //
+// Plain structs, no TObject, eta and phi are stored so dR is cheap.     //
+// They have the TLorentzVector accessors the analysis code uses and     //
+// convert to a TLorentzVector for the callers that still want one.      //
+// ======================================================================//
+///////////////////////////////////////////////////////////////////////////
+
+#ifndef ADD_PTETAPHIM
+#define ADD_PTETAPHIM
+
+#include "TLorentzVector.h"
+#include "TMath.h"
+
+#include <cmath>
+
+// the sum of two or more objects, e.g. a dijet
+struct PxPyPzE
+{
+    double px = 0;
+    double py = 0;
+    double pz = 0;
+    double e  = 0;
+
+    PxPyPzE(){};
+    PxPyPzE(double ipx, double ipy, double ipz, double ie) : px(ipx), py(ipy), pz(ipz), e(ie) {};
+
+    double Px() const { return px; };
+    double Py() const { return py; };
+    double Pz() const { return pz; };
+    double E()  const { return e; };
+    double Pt() const { return std::sqrt(px*px + py*py); };
+    double Phi() const { return (px == 0 && py == 0) ? 0 : std::atan2(py, px); };
+
+    // same conventions as TLorentzVector, negative mass squared gives -sqrt(-m2)
+    double M() const
+    {
+        double m2 = e*e - px*px - py*py - pz*pz;
+        return (m2 < 0) ? -std::sqrt(-m2) : std::sqrt(m2);
+    };
+
+    double Eta() const
+    {
+        double pt = Pt();
+        if(pt == 0) return (pz == 0) ? 0 : ((pz > 0) ? 10e10 : -10e10);
+        return std::asinh(pz/pt);
+    };
+
+    TLorentzVector get4vec() const { return TLorentzVector(px, py, pz, e); };
+    operator TLorentzVector() const { return get4vec(); };
+
+    PxPyPzE operator+(const PxPyPzE& o) const { return PxPyPzE(px+o.px, py+o.py, pz+o.pz, e+o.e); };
+};
+
+// one cleaned muon, electron, or jet
+struct PtEtaPhiM
+{
+    float pt  = 0;
+    float eta = 0;
+    float phi = 0;
+    float m   = 0;
+
+    PtEtaPhiM(){};
+    PtEtaPhiM(float ipt, float ieta, float iphi, float im) : pt(ipt), eta(ieta), phi(iphi), m(im) {};
+
+    double Pt()  const { return pt; };
+    double Eta() const { return eta; };
+    double Phi() const { return phi; };
+    double M()   const { return m; };
+    // in double precision, the same as the EventKinematics arrays
+    double Px()  const { return Pt()*std::cos(Phi()); };
+    double Py()  const { return Pt()*std::sin(Phi()); };
+    double Pz()  const { return Pt()*std::sinh(Eta()); };
+    double E()   const { double p = Pt()*std::cosh(Eta()); return std::sqrt(p*p + M()*M()); };
+    double Et()  const { return E()/std::cosh(Eta()); };
+
+    PxPyPzE getPxPyPzE() const { return PxPyPzE(Px(), Py(), Pz(), E()); };
+
+    // the TLorentzVector view for the legacy callers
+    TLorentzVector get4vec() const
+    {
+        TLorentzVector v;
+        v.SetPtEtaPhiM(pt, eta, phi, m);
+        return v;
+    };
+    operator TLorentzVector() const { return get4vec(); };
+
+    static double deltaPhi(double phi1, double phi2)
+    {
+        double dphi = phi1 - phi2;
+        while(dphi >= TMath::Pi())  dphi -= 2*TMath::Pi();
+        while(dphi < -TMath::Pi())  dphi += 2*TMath::Pi();
+        return dphi;
+    };
+
+    double DeltaR2(const PtEtaPhiM& o) const
+    {
+        double deta = eta - o.eta;
+        double dphi = deltaPhi(phi, o.phi);
+        return deta*deta + dphi*dphi;
+    };
+
+    double DeltaR(const PtEtaPhiM& o) const { return std::sqrt(DeltaR2(o)); };
+};
+
+inline PxPyPzE operator+(const PtEtaPhiM& a, const PtEtaPhiM& b) { return a.getPxPyPzE() + b.getPxPyPzE(); };
+inline PxPyPzE operator+(const PxPyPzE& a, const PtEtaPhiM& b) { return a + b.getPxPyPzE(); };
+
+#endif
@@ -17,6 +17,13 @@
 
 #include "Sample.h"
 #include "TCanvas.h"
+#include "TSystem.h"
+#include "TEnv.h"
+#include "TTreeCache.h"
+#include "TTreeCacheUnzip.h"
+#include "TTreePerfStats.h"
+
+#include <algorithm>
 
 ///////////////////////////////////////////////////////////////////////////
 // _______________________Constructor/Destructor_________________________//
@@ -24,6 +31,10 @@
 
 Sample::Sample() 
 {
+    chain = 0;
+    nOriginal = 0;
+    nOriginalWeighted = 0;
+    N = 0;
     lumiWeights = 0;
     xsec = -999; 
     lumi = -999;
@@ -39,20 +50,24 @@ Sample::Sample(std::vector<TString> ifilenames, TString iname, TString isampleTy
     name = iname;
     if (isampleType != "NONE")
       sampleType = isampleType;
+    isData = (sampleType == "data");
 
     treename = TString("dimuons/tree");
-    chain = new TChain(treename);
+    chain = 0;
+
+    // the entries per file come from the metadata index, the chain and the
+    // FileMirror copies wait for open() so that unused samples cost nothing
+    N = 0;
     for (int i = 0; i < filenames.size(); i++) {
-      chain->Add(filenames.at(i));
-      //std::cout << i+1 << ", ";
+      SampleMetadataCache::FileInfo info = SampleMetadataCache::get(filenames.at(i));
+      fileEntries.push_back(info.N);
+      N += info.N;
     }
-    N = chain->GetEntries();
 
     lumiWeights = 0;
     xsec = -999; 
     lumi = -999;
 
-    setBranchAddresses();
     calculateNoriginal();
 }
 
@@ -65,8 +80,13 @@ Sample::Sample(TString iname, TString isampleType)
     name = iname;
     if (isampleType != "NONE")
       sampleType = isampleType;
+    isData = (sampleType == "data");
 
     treename = TString("dimuons/tree");
+    chain = 0;
+    nOriginal = 0;
+    nOriginalWeighted = 0;
+    N = 0;
 
     lumiWeights = 0;
     xsec = -999; 
@@ -79,23 +99,70 @@ Sample::Sample(TString iname, TString isampleType)
 
 Sample::~Sample() {
   // free pointed to memory!
+  if (perfStats != 0) {
+    delete perfStats;
+  }
   if (chain != 0) {
     delete chain;
   }
   if (files.size() !=0) {
     files.clear();
   }
-  if (lumiWeights !=0) {
+  if (lumiWeights !=0 && !isReader) {
     delete lumiWeights;
   }
+  if (eventIndex !=0 && !isReader) {
+    delete eventIndex;
+  }
+  if (veto !=0 && !isReader) {
+    delete veto;
+  }
+  for(auto& jes: jesVariations)
+    delete jes;
 }
 
 ///////////////////////////////////////////////////////////////////////////
 // _______________________Other Functions________________________________//
 ///////////////////////////////////////////////////////////////////////////
 
+void Sample::open()
+{
+// giving the chain the entries means it doesn't open every file up front
+    if(chain != 0) return;
+
+    std::vector<TString> local = getLocalFilenames();
+    chain = new TChain(treename);
+    for(unsigned int i=0; i<local.size(); i++)
+    {
+        if(i < fileEntries.size() && fileEntries[i] > 0) chain->Add(local[i], fileEntries[i]);
+        else chain->Add(local[i]);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+std::vector<TString> Sample::getLocalFilenames()
+{
+// remote files are read from their local copy if the FileMirror is set up
+    if(localFilenames.size() != filenames.size())
+    {
+        localFilenames.clear();
+        for(auto& f: filenames)
+            localFilenames.push_back(FileMirror::get(f));
+    }
+    return localFilenames;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
 void Sample::setBranchAddresses(TString options)
 {
+      open();
+
       // Link only to the branches we need to save a lot of time
       // run 1 category info 
       branches.muons      = chain->GetBranch("muons");
@@ -213,25 +280,19 @@ void Sample::setBranchAddresses(TString options)
 
 void Sample::calculateNoriginal()
 {
-  gROOT->SetBatch(1); // Don't draw TCanvas
-  TCanvas c;
   // Calculate the number of original events using the meta data tree
-  // Calculate the weighted number of original events as well
-  TChain* metadata = new TChain("dimuons/metadata");
+  // Calculate the weighted number of original events as well.
+  // The sums for each file are in the metadata index, so the files are only 
+  // read the first time we see them or after they change
+  double sumOriginal = 0;
+  double sumOriginalWeighted = 0;
   for (auto f_name : filenames) {
-    metadata->Add(f_name);
+    SampleMetadataCache::FileInfo info = SampleMetadataCache::get(f_name);
+    sumOriginal += info.nOriginal;
+    sumOriginalWeighted += info.nOriginalWeighted;
   }
-  metadata->Draw("sumEventWeights>>eweights_"+name);
-  TH1F* sumEventWeightsHist = (TH1F*) gDirectory->Get("eweights_"+name); 
-  
-  // There are many ttrees combined so the histogram has a numEvents entry for each
-  // file. The total number is equal to the average number times the total number of entries.
-  nOriginalWeighted = sumEventWeightsHist->GetEntries()*sumEventWeightsHist->GetMean();
-  
-  metadata->Draw("originalNumEvents>>nevents_"+name);
-  TH1F* nEventsHist = (TH1F*) gDirectory->Get("nevents_"+name); 
-  nOriginal = nEventsHist->GetEntries()*nEventsHist->GetMean();
-  if(metadata !=0) delete metadata;
+  nOriginal = sumOriginal;
+  nOriginalWeighted = sumOriginalWeighted;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -263,10 +324,372 @@ double Sample::getWeight()
 {
 // Assumes getEntry has already been called to load the appropriate values.
 // Gets the weight for the histogram depending on the sample type 
-    if(sampleType == "data") return 1.0;
-    else if(lumiWeights == 0) return 1.0*vars.gen_wgt*vars.pu_wgt*vars.sf();
-    else return 1.0*vars.gen_wgt*lumiWeights->weight(vars.nPU)*vars.sf();
-    //else return 1.0*vars.gen_wgt;
+    return getWeight(kWeightNominal);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+double Sample::getWeight(int weightId)
+{
+// the weights are only recomputed when a weight branch was loaded since the last call,
+// so calling this for every category and variable costs a comparison
+    if(isData) return 1.0;
+    if(weightLoads != branches.weightLoads) computeWeights();
+    return weights[weightId];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+double Sample::getWeight(TString systematic)
+{
+    return getWeight(getWeightId(systematic));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void Sample::computeWeights()
+{
+// gen weight x pileup weight x scale factors for the nominal and each variation,
+// the common factors are computed once
+    weightLoads = branches.weightLoads;
+    if(isData)
+    {
+        for(int w=0; w<kNWeightIds; w++) weights[w] = 1.0;
+        return;
+    }
+
+    double gen_wgt = 1.0*vars.gen_wgt;
+    double pu_wgt = (lumiWeights == 0)?vars.pu_wgt:getLumiWeight(vars.nPU);
+    float sf = vars.sf();
+    float sf_3 = vars.isoMu_SF_3*vars.muID_SF_3*vars.muIso_SF_3;
+    float sf_4 = vars.isoMu_SF_4*vars.muID_SF_4*vars.muIso_SF_4;
+
+    weights[kWeightNominal] = gen_wgt*pu_wgt*sf;
+    weights[kWeightPUUp]    = gen_wgt*vars.pu_wgt_up*sf;
+    weights[kWeightPUDown]  = gen_wgt*vars.pu_wgt_down*sf;
+    weights[kWeightSFEra3]  = gen_wgt*pu_wgt*sf_3;
+    weights[kWeightSFEra4]  = gen_wgt*pu_wgt*sf_4;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+int Sample::getWeightId(TString systematic)
+{
+    if(systematic == "PU_up")   return kWeightPUUp;
+    if(systematic == "PU_down") return kWeightPUDown;
+    if(systematic == "SF_era3") return kWeightSFEra3;
+    if(systematic == "SF_era4") return kWeightSFEra4;
+    return kWeightNominal;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+double Sample::getLumiWeight(int nPU)
+{
+// the same as lumiWeights->weight(nPU), the bins are looked up once per lumiWeights
+    if(puTableSource != lumiWeights)
+    {
+        puTable.resize(kMaxPUTable);
+        for(int n=0; n<kMaxPUTable; n++)
+            puTable[n] = lumiWeights->weight(n);
+        puTableSource = lumiWeights;
+    }
+    if(nPU >= 0 && nPU < kMaxPUTable) return puTable[nPU];
+    return lumiWeights->weight(nPU);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void Sample::setSystematicBranchAddresses(std::vector<TString> systematics)
+{
+// the nominal branches are set by setBranchAddresses(""), data has no systematic variations
+    if(sampleType.EqualTo("data")) return;
+    open();
+
+    for(auto& systematic: systematics)
+    {
+        if(systematic != "" && systematicsAvailable.size() > 0 &&
+           std::find(systematicsAvailable.begin(), systematicsAvailable.end(), systematic) == systematicsAvailable.end())
+        {
+            std::cout << Form("  !!! %s has no %s variation in the ntuples, using the nominal \n", name.Data(), systematic.Data());
+            continue;
+        }
+
+        if(systematic == "PU_up")
+        {
+            branches.pu_wgt_up = chain->GetBranch("PU_wgt_up");
+            branches.pu_wgt_up->SetAddress(&vars.pu_wgt_up);
+        }
+        if(systematic == "PU_down")
+        {
+            branches.pu_wgt_down = chain->GetBranch("PU_wgt_down");
+            branches.pu_wgt_down->SetAddress(&vars.pu_wgt_down);
+        }
+        if(systematic == "JES_up" || systematic == "JES_down")
+        {
+            JESVariation* jes = new JESVariation();
+            jes->setBranchAddresses(chain, systematic);
+            jesVariations.push_back(jes);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void Sample::getEntrySystematics(int i)
+{
+// the pu weights for the variations are loaded with the rest of the branches
+    for(auto& jes: jesVariations)
+        jes->getEntry(i, branches);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void Sample::getBatch(std::vector<DimuonBatch*>& batches, Long64_t first, Long64_t last, float maxLheHt)
+{
+// only the branches the preselection needs, the event loop loads the rest for the survivors
+    for(auto& batch: batches)
+        batch->clear();
+
+    for(Long64_t i=first; i<last; i++)
+        addToBatches(batches, i, maxLheHt);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void Sample::addToBatches(std::vector<DimuonBatch*>& batches, Long64_t i, float maxLheHt)
+{
+    if(isVetoed(i)) return;
+
+    if(maxLheHt >= 0 && !isData)
+    {
+        branches.getEntry(BranchSet::kLheHt, i);
+        if(vars.lhe_ht >= maxLheHt) return;
+    }
+
+    branches.getEntry(BranchSet::kMuPairs, i);
+    branches.getEntry(BranchSet::kMuons, i);
+    branches.getEntry(BranchSet::kEventInfo, i);
+
+    for(auto& batch: batches)
+        batch->add(vars, i);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+bool Sample::loadEntryList(TString filename, std::vector<Long64_t>& entries)
+{
+    if(gSystem->AccessPathName(filename)) return false;   // true means the file is not there
+
+    TFile* file = TFile::Open(filename);
+    if(file == 0 || file->IsZombie())
+    {
+        delete file;
+        return false;
+    }
+
+    // the list belongs to the file, copy the entries out before closing it
+    TEntryList* list = (TEntryList*) file->Get("preselection");
+    bool found = (list != 0);
+    if(found)
+    {
+        entries.clear();
+        entries.reserve(list->GetN());
+        for(Long64_t n=0; n<list->GetN(); n++)
+            entries.push_back(list->GetEntry(n));
+    }
+
+    file->Close();
+    delete file;
+    return found;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void Sample::saveEntryList(const std::vector<Long64_t>& entries, TString filename)
+{
+    TFile* file = TFile::Open(filename, "RECREATE");
+    if(file == 0 || file->IsZombie())
+    {
+        std::cout << Form("  !!! could not save the entry list to %s \n", filename.Data());
+        delete file;
+        return;
+    }
+
+    // made in the file's directory, closing the file deletes it
+    file->cd();
+    TEntryList* list = new TEntryList("preselection", "entries passing the preselection");
+    for(auto& i: entries)
+        list->Enter(i);
+    list->Write("preselection");
+
+    file->Close();
+    delete file;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void Sample::setCache(BranchSet::Mask mask, Long64_t first, Long64_t last)
+{
+// we know which branches we read, so skip the learning phase and only cache those.
+// Calling it again replaces the branches, e.g. the muons for the preselection then the jets
+    if(chain == 0 || cacheSize <= 0) return;
+
+    chain->SetCacheSize(cacheSize);
+    if(last > first) chain->SetCacheEntryRange(first, last);
+    chain->DropBranchFromCache("*", true);
+
+    for(int id=0; id<BranchSet::kNBranches; id++)
+    {
+        TBranch* b = branches.branch(id);
+        if(b == 0 || !(mask & BranchSet::bit(id)) || !(branches.active & BranchSet::bit(id))) continue;
+        chain->AddBranchToCache(b->GetName(), true);
+    }
+
+    // the JES_up/JES_down versions are read along with the nominal branches
+    for(auto& jes: jesVariations)
+    {
+        std::pair<TBranch*, int> jesBranches[] = { {jes->b_jets, BranchSet::kJets}, {jes->b_jetPairs, BranchSet::kJetPairs},
+                                                   {jes->b_mht, BranchSet::kMht}, {jes->b_met, BranchSet::kMet},
+                                                   {jes->b_nJets, BranchSet::kNJets}, {jes->b_nJetsCent, BranchSet::kNJetsCent},
+                                                   {jes->b_nJetsFwd, BranchSet::kNJetsFwd}, {jes->b_nBLoose, BranchSet::kNBLoose},
+                                                   {jes->b_nBMed, BranchSet::kNBMed}, {jes->b_nBTight, BranchSet::kNBTight} };
+        for(auto& b: jesBranches)
+        {
+            if(b.first == 0 || !(mask & BranchSet::bit(b.second)) || !(branches.active & BranchSet::bit(b.second))) continue;
+            chain->AddBranchToCache(b.first->GetName(), true);
+        }
+    }
+
+    chain->StopCacheLearningPhase();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void Sample::enableCache()
+{
+    setCache(BranchSet::kAllBranches, 0, -1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void Sample::setGlobalIOOptions(bool asyncPrefetch, bool parallelUnzip)
+{
+    gEnv->SetValue("TFile.AsyncPrefetching", asyncPrefetch ? 1 : 0);
+    TTreeCacheUnzip::SetParallelUnzip(parallelUnzip ? TTreeCacheUnzip::kEnable : TTreeCacheUnzip::kDisable);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void Sample::enableIOStats()
+{
+    if(chain == 0 || perfStats != 0) return;
+    perfStats = new TTreePerfStats(Form("ioperf_%s", name.Data()), chain);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+IOStats Sample::getIOStats()
+{
+    IOStats stats;
+    stats.name = name;
+    if(perfStats == 0) return stats;
+
+    stats.bytesRead = perfStats->GetBytesRead();
+    stats.readCalls = perfStats->GetReadCalls();
+    stats.diskTime  = perfStats->GetDiskTime();
+    stats.unzipTime = perfStats->GetUnzipTime();
+
+    // fraction of the basket reads the cache had, for the file we are on
+    TFile* file = chain->GetCurrentFile();
+    TTreeCache* cache = (file != 0) ? dynamic_cast<TTreeCache*>(file->GetCacheRead(chain->GetTree())) : 0;
+    if(cache != 0) stats.cacheHitBytes = cache->GetEfficiencyRel()*stats.bytesRead;
+
+    return stats;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+EventIndex* Sample::getEventIndex()
+{
+    if(eventIndex != 0) return eventIndex;
+    eventIndex = new EventIndex();
+    if(!eventIndex->build(getLocalFilenames()) || eventIndex->nentries != N)
+        std::cout << Form("  !!! the event index for %s has %lld entries, the sample has %d \n", name.Data(), eventIndex->nentries, N);
+    return eventIndex;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+std::vector<Long64_t> Sample::getEntries(const EventSet& events)
+{
+// one binary search per event, events that appear twice in the chain give their first entry
+    std::vector<Long64_t> entries;
+    EventIndex* index = getEventIndex();
+    for(auto& e: events.getEvents())
+    {
+        Long64_t entry = index->find(e.run, e.event);
+        if(entry >= 0) entries.push_back(entry);
+    }
+    std::sort(entries.begin(), entries.end());
+    return entries;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+Long64_t Sample::findEntry(int run, long long event, int lumi)
+{
+    return getEventIndex()->find(run, event, lumi);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+std::vector< std::pair<Long64_t, Long64_t> > Sample::getRunRanges(long long minRun, long long maxRun, Long64_t first, Long64_t last)
+{
+// without an index we read the whole range and leave the run cut to the caller
+    if(eventIndex == 0 || eventIndex->nentries != N)
+        return std::vector< std::pair<Long64_t, Long64_t> >(1, std::pair<Long64_t, Long64_t>(first, last));
+    return eventIndex->getRunRanges(minRun, maxRun, first, last);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -277,6 +700,107 @@ float Sample::getLumiScaleFactor(float luminosity)
 {
 // Scale the MC histograms based upon the data luminosity, the number of events
 // that the CMSSW analyzer looked at, and the xsec for the process
-    if(sampleType.EqualTo("data")) return 1.0;
+    if(isData) return 1.0;
     else return luminosity*xsec/nOriginalWeighted;
 }
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+std::vector< std::pair<Long64_t, Long64_t> > Sample::getEntryRanges(Long64_t maxEntries, Long64_t nentries)
+{
+// Split the chain into [first, last) entry ranges. Ranges stay inside one file when possible
+// so that each reader only opens the files it needs. Large files are split into equal pieces.
+    std::vector< std::pair<Long64_t, Long64_t> > ranges;
+    if(nentries < 0 || nentries > N) nentries = N;
+    if(maxEntries <= 0) maxEntries = nentries;
+    if(nentries <= 0) return ranges;
+
+    // the chain knows where each file starts, from the metadata index or after opening the files
+    open();
+    std::vector<Long64_t> boundaries;
+    boundaries.push_back(0);
+    if(chain != 0)
+    {
+        Long64_t* offsets = chain->GetTreeOffset();
+        for(int t=1; offsets != 0 && t<chain->GetNtrees(); t++)
+            if(offsets[t] > 0 && offsets[t] < nentries) boundaries.push_back(offsets[t]);
+    }
+    boundaries.push_back(nentries);
+
+    for(unsigned int b=0; b+1<boundaries.size(); b++)
+    {
+        Long64_t first = boundaries[b];
+        Long64_t last  = boundaries[b+1];
+        if(last <= first) continue;
+
+        Long64_t npieces = (last - first + maxEntries - 1)/maxEntries;
+        Long64_t step = (last - first + npieces - 1)/npieces;
+        for(Long64_t start=first; start<last; start+=step)
+            ranges.push_back(std::pair<Long64_t, Long64_t>(start, TMath::Min(start+step, last)));
+    }
+    return ranges;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+Sample* Sample::makeReader(TString options)
+{
+// Copy the sample info into a new Sample with its own TChain, branches, and vars.
+// We give the chain the number of entries in each file so it only opens the files
+// for the entries we actually read.
+    Sample* reader = new Sample(name, sampleType);
+    reader->isReader = true;
+    reader->filename = filename;
+    reader->filenames = filenames;
+    reader->treename = treename;
+    reader->lumiWeights = lumiWeights;
+    reader->eventIndex = eventIndex;
+    reader->veto = veto;
+    reader->vetoKey = vetoKey;
+    reader->minRun = minRun;
+    reader->maxRun = maxRun;
+    reader->dir = dir;
+    reader->pileupfile = pileupfile;
+    reader->plotColor = plotColor;
+    reader->nOriginal = nOriginal;
+    reader->nOriginalWeighted = nOriginalWeighted;
+    reader->N = N;
+    reader->xsec = xsec;
+    reader->lumi = lumi;
+    reader->systematicsAvailable = systematicsAvailable;
+
+    open();
+    reader->localFilenames = localFilenames;
+    reader->fileEntries = fileEntries;
+    reader->chain = new TChain(treename);
+    Long64_t* offsets = chain->GetTreeOffset();
+    bool knowEntries = (offsets != 0 && chain->GetNtrees() == (int)localFilenames.size());
+    for(unsigned int f=0; f<localFilenames.size(); f++)
+    {
+        Long64_t nentries = knowEntries?(offsets[f+1] - offsets[f]):0;
+        if(nentries > 0) reader->chain->Add(localFilenames[f], nentries);
+        else reader->chain->Add(localFilenames[f]);
+    }
+
+    reader->cacheSize = cacheSize;
+    reader->ioStats = ioStats;
+
+    reader->setBranchAddresses(options);
+    reader->setActiveBranches(branches.active);
+    if(ioStats) reader->enableIOStats();
+    return reader;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void Sample::setActiveBranches(BranchSet::Mask mask)
+{
+// getEntry only reads the branches in the mask, the other values in vars are left as they were
+    branches.active = mask;
+}
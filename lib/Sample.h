@@ -14,6 +14,15 @@
 #include "LumiReweightingStandAlone.h"
 #include "VarSet.h"
 #include "BranchSet.h"
+#include "JESVariation.h"
+#include "DimuonBatch.h"
+#include "IOStats.h"
+#include "SampleMetadataCache.h"
+#include "FileMirror.h"
+#include "EventSet.h"
+#include "EventIndex.h"
+
+class TTreePerfStats;
 
 class Sample
 {
@@ -25,14 +34,15 @@ class Sample
 
         TString name;
         TString filename;
-	std::vector<TString> filenames;
+	std::vector<TString> filenames;        // the ntuples from the catalog, remote ones are read from their FileMirror copy
         TString treename;
-	TChain* chain;
+	TChain* chain;                         // 0 until open(), the samples we never read don't copy or open any files
         reweight::LumiReWeighting* lumiWeights;  // Information for pileup reweighting 
 
         TString dir;           // DAS directory
         TString pileupfile;    // used for pile up reweighting through lumiWeights
         TString sampleType;    // "data", "signal", "background"
+        bool isData = false;   // sampleType == "data", so the event loop doesn't compare strings
 
         int plotColor;         // the color used when plotting the sample
         int nOriginal;         // the number of events run over to get this sample
@@ -49,16 +59,112 @@ class Sample
         int getEntry(int i, TEntryList* list);  // load ith event from the list into vars
                                                 // the ith event in the list maps to the jth tree entry
 
-        void calculateNoriginal();                      // calculate nOriginal and nOriginalWeighted
-        void setBranchAddresses(TString options = "");  // link the values in the tree to vars
+        void calculateNoriginal();                      // calculate nOriginal and nOriginalWeighted, see SampleMetadataCache
+        void setBranchAddresses(TString options = "");  // link the values in the tree to vars, opens the sample first
+
+        // make the chain over the local copies of the files, setBranchAddresses, makeReader, and getEntryRanges
+        // call it so the constructor only looks up N and nOriginal in the metadata index
+        void open();
+        std::vector<TString> getLocalFilenames();       // filenames with the remote ones copied to the FileMirror
         double getWeight();                             // get the weight for the histogram based upon the pileup weight and the MC gen weight
 
+        // the weights for one event, computed together the first time getWeight asks after the weight branches are loaded.
+        // The SF eras use the scale factors for one era instead of the average of the two
+        enum WeightId { kWeightNominal, kWeightPUUp, kWeightPUDown, kWeightSFEra3, kWeightSFEra4, kNWeightIds };
+        static int getWeightId(TString systematic);     // PU_up, PU_down, SF_era3, SF_era4, anything else is the nominal weight
+        double getWeight(int weightId);
+        double getWeight(TString systematic);           // same as getWeight(getWeightId(systematic))
+        void computeWeights();
+        double weights[kNWeightIds] = {1, 1, 1, 1, 1};
+
+        // only read the branches in the mask, see VarSet::getBranchMask for the features
+        void setActiveBranches(BranchSet::Mask mask);
+
+        // process several systematics in one event loop: link PU_up/PU_down weights 
+        // and JES_up/JES_down jets in addition to the nominal branches
+        void setSystematicBranchAddresses(std::vector<TString> systematics);
+        std::vector<TString> systematicsAvailable;     // the variations in the ntuples, empty means all of them, see SampleCatalog
+        std::vector<JESVariation*> jesVariations;       // loaded by getEntrySystematics
+        void getEntrySystematics(int i);                // load the variation branches for the ith event
+
+        // load muPairs, muons, and eventInfo for entries [first, last) into each batch, one batch per calibration.
+        // maxLheHt >= 0 skips the MC events with lhe_ht >= maxLheHt, used to stitch ZJets_MG to the HT binned samples
+        void getBatch(std::vector<DimuonBatch*>& batches, Long64_t first, Long64_t last, float maxLheHt = -1);
+
+        // two pass read: stage 1 finds the entries that pass the preselection using the muon branches,
+        // stage 2 loads the rest of the branches for those entries only. The selected entries are saved as a
+        // TEntryList so that reruns, e.g. with other systematics, can skip stage 1
+        static bool loadEntryList(TString filename, std::vector<Long64_t>& entries);   // false if there is no saved list
+        static void saveEntryList(const std::vector<Long64_t>& entries, TString filename);
+
+        // where the events are in the chain, built or read from event_index/ the first time it's asked for.
+        // Readers share the index of the sample that made them, get it before making the readers
+        EventIndex* getEventIndex();
+        EventIndex* eventIndex = 0;
+
+        // the entries of the listed events in increasing order, e.g. to look at the events from a synchronization list
+        std::vector<Long64_t> getEntries(const EventSet& events);
+        Long64_t findEntry(int run, long long event, int lumi = -1);   // -1 if the event isn't in the sample
+
+        // the entries in [first, last) with minRun <= run <= maxRun as entry ranges, {first, last} without an index
+        std::vector< std::pair<Long64_t, Long64_t> > getRunRanges(long long minRun, long long maxRun, Long64_t first, Long64_t last);
+
+        // the runs the sample keeps, from runs= in samples.catalog, e.g. RunF_1 and RunF_2 split RunF
+        long long minRun = 0;
+        long long maxRun = 999999999;
+        bool hasRunRange() { return minRun > 0 || maxRun < 999999999; };
+
+        // one bit per entry, set for the events another data sample or an earlier file already has and for the
+        // events outside minRun, maxRun. Made by EventVeto in GetSamples, 0 keeps every entry
+        std::vector<unsigned long long>* veto = 0;
+        bool isVetoed(Long64_t i) { return veto != 0 && (((*veto)[i >> 6] >> (i & 63)) & 1); };
+        TString vetoKey = "";   // names the saved veto for the files made with it, "" if the veto couldn't be saved
+
+        // for stage 2: a TTreeCache over entries [first, last) holding only the branches in the mask
+        void setCache(BranchSet::Mask mask, Long64_t first, Long64_t last);
+
+        // I/O options, makeReader copies them to the readers
+        Long64_t cacheSize = 30000000;  // bytes for the TTreeCache, 0 turns the cache off
+        bool ioStats = true;            // keep a TTreePerfStats for the chain so getIOStats has something to say
+
+        // for the whole job, call before opening the files. asyncPrefetch reads the next baskets in the background,
+        // parallelUnzip unzips the cached baskets on the implicit MT pool, see ROOT::EnableImplicitMT
+        static void setGlobalIOOptions(bool asyncPrefetch, bool parallelUnzip);
+
+        void enableCache();       // TTreeCache over all of the entries and every active branch from setBranchAddresses
+        void enableIOStats();     // start counting, makeReader does this when ioStats is set
+        IOStats getIOStats();     // bytes, read calls, unzip time, cache hit rate so far
+
         // scale by xsec*lumi/N_weighted for MC and 1.0 for data
         float getLumiScaleFactor(float luminosity); 
 
+        // split entries [0, nentries) into ranges of at most maxEntries that don't cross file boundaries
+        std::vector< std::pair<Long64_t, Long64_t> > getEntryRanges(Long64_t maxEntries, Long64_t nentries=-1);
+
+        // open an independent reader over the same files so that several threads 
+        // can process different entry ranges of the sample at the same time
+        Sample* makeReader(TString options = "");
+        bool isReader = false;  // readers share lumiWeights, the eventIndex, and the veto with the sample that made them
+
     protected:
 	std::vector<TFile*> files; // files with the ttree
 
+        std::vector<TString> localFilenames;   // filled by getLocalFilenames
+        std::vector<Long64_t> fileEntries;      // the entries in each file from the metadata index, 0 if it doesn't know
+
+        void addToBatches(std::vector<DimuonBatch*>& batches, Long64_t i, float maxLheHt);
+
+        TTreePerfStats* perfStats = 0;
+
+        unsigned long long weightLoads = ~0ULL;      // branches.weightLoads when the weights were computed
+
+        // lumiWeights->weight(nPU) for nPU in [0, kMaxPUTable), the lumiWeights histogram doesn't change
+        // so we look the bins up once instead of every event
+        static const int kMaxPUTable = 200;
+        std::vector<double> puTable;
+        reweight::LumiReWeighting* puTableSource = 0;
+        double getLumiWeight(int nPU);
+
 };
 
 #endif
@@ -0,0 +1,303 @@
+///////////////////////////////////////////////////////////////////////////
+// ======================================================================//
+// SampleCatalog.h                                                       //
+// ======================================================================//
+// The samples we know about, read from a text catalog instead of being  //
+// compiled in: type, xsec, lumi, pileup file, which systematics the     //
+// ntuples have, the groups that select the sample, and its files for    //
+// each location. Reading the catalog doesn't touch the ntuples, a       //
+// Sample is only made when makeSample asks for it. Wildcards in a file  //
+// name are expanded then, so a new file or sample needs no recompile.   //
+// See ../bin/samples.catalog for the format, GetSamples in              //
+// ../bin/SampleDatabase.cxx uses this.                                  //
+// ======================================================================//
+///////////////////////////////////////////////////////////////////////////
+
+#ifndef ADD_SAMPLECATALOG
+#define ADD_SAMPLECATALOG
+
+#include "Sample.h"
+#include "TString.h"
+#include "TSystem.h"
+#include "TRegexp.h"
+
+#include <map>
+#include <vector>
+#include <utility>
+#include <mutex>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+
+class SampleCatalog
+{
+    public:
+        struct Entry
+        {
+            TString name;
+            TString type;                          // data, signal, or background
+            float xsec = -999;                     // pb
+            float lumi = -999;                     // pb-1, for the data
+            long long minRun = 0;                  // the data sample only keeps minRun <= run <= maxRun, see EventVeto
+            long long maxRun = 999999999;
+            TString pileupfile;
+            std::vector<TString> systematics;      // the systematics the ntuples have, empty means all of them
+            std::vector<TString> groups;           // the selections that include the sample besides its name, e.g. MC, ALL*
+
+            // (location pattern, file pattern) pairs, relative to the location's directory
+            std::vector< std::pair<TString, TString> > files;
+
+            bool isSelectedBy(TString select) const
+            {
+                if(select == name) return true;
+                for(auto& g: groups)
+                    if(matches(g, select)) return true;
+                return false;
+            }
+        };
+
+        static TString& catalogfile()
+        {
+            static TString filename = "samples.catalog";
+            return filename;
+        }
+
+        // read the catalog, only the first call does anything unless we ask for another file
+        static void load(TString filename = "")
+        {
+            std::lock_guard<std::mutex> lock(mutex());
+            if(filename == "" && loaded() != "") return;
+            if(filename == "") filename = catalogfile();
+            if(loaded() == filename) return;
+
+            entries().clear();
+            directories().clear();
+
+            std::ifstream in(filename.Data());
+            if(!in) std::cout << Form("  !!! could not read the sample catalog %s \n", filename.Data());
+
+            std::string line;
+            int nline = 0;
+            while(std::getline(in, line))
+            {
+                nline++;
+                size_t comment = line.find('#');
+                if(comment != std::string::npos) line = line.substr(0, comment);
+
+                std::stringstream ss(line);
+                std::string first;
+                if(!(ss >> first)) continue;
+
+                if(first == "location")
+                {
+                    std::string location, dir;
+                    if(ss >> location >> dir) directories()[location.c_str()] = dir.c_str();
+                    else std::cout << Form("  !!! %s:%d location needs a name and a directory \n", filename.Data(), nline);
+                }
+                else if(first == "sample")
+                {
+                    Entry e;
+                    std::string name, type, option;
+                    if(!(ss >> name >> type))
+                    {
+                        std::cout << Form("  !!! %s:%d sample needs a name and a type \n", filename.Data(), nline);
+                        continue;
+                    }
+                    e.name = name.c_str();
+                    e.type = type.c_str();
+                    while(ss >> option) setOption(e, option.c_str());
+                    entries().push_back(e);
+                }
+                else
+                {
+                    // the files of the last sample: location pattern, file pattern
+                    std::string file;
+                    if(entries().empty() || !(ss >> file))
+                    {
+                        std::cout << Form("  !!! %s:%d expected 'location', 'sample', or files for a sample \n", filename.Data(), nline);
+                        continue;
+                    }
+                    TString locations = first.c_str();
+                    TString tok;
+                    Ssiz_t from = 0;
+                    while(locations.Tokenize(tok, from, ","))
+                        entries().back().files.push_back(std::make_pair(tok, TString(file.c_str())));
+                }
+            }
+            loaded() = filename;
+        }
+
+        // the names of the samples the selection picks, in catalog order
+        static std::vector<TString> select(TString select)
+        {
+            load();
+            std::vector<TString> names;
+            for(auto& e: entries())
+                if(e.isSelectedBy(select)) names.push_back(e.name);
+            return names;
+        }
+
+        // every sample name in catalog order, the data samples keep the events they share in this order
+        static std::vector<TString> getNames()
+        {
+            load();
+            std::vector<TString> names;
+            for(auto& e: entries())
+                names.push_back(e.name);
+            return names;
+        }
+
+        static const Entry* find(TString name)
+        {
+            load();
+            for(auto& e: entries())
+                if(e.name == name) return &e;
+            return 0;
+        }
+
+        // the files of the sample at the location with the wildcards expanded.
+        // a+b gives the files of both locations, e.g. UF+UF_DoubleMu for the SingleMuon and DoubleMuon data,
+        // a file that both of them have is only added once
+        static std::vector<TString> getFiles(const Entry& e, TString location)
+        {
+            std::vector<TString> files;
+            if(location.Contains("+"))
+            {
+                for(auto& l: split(location, "+"))
+                    for(auto& f: getFiles(e, l))
+                        if(std::find(files.begin(), files.end(), f) == files.end()) files.push_back(f);
+                return files;
+            }
+
+            if(directories().count(location) == 0)
+            {
+                std::cout << Form("  !!! location %s is not in the sample catalog \n", location.Data());
+                return files;
+            }
+
+            for(auto& f: e.files)
+            {
+                if(!matches(f.first, location)) continue;
+                TString path = f.second;
+                if(!path.BeginsWith("/") && !path.Contains("://")) path = directories()[location]+"/"+path;
+
+                std::vector<TString> expanded = expand(path);
+                files.insert(files.end(), expanded.begin(), expanded.end());
+            }
+            return files;
+        }
+
+        // a new Sample for the catalog entry, the caller owns it.
+        // info_only gives the name, type, xsec, and lumi without opening any files
+        static Sample* makeSample(TString name, TString location, bool info_only = false)
+        {
+            const Entry* e = find(name);
+            if(e == 0)
+            {
+                std::cout << Form("  !!! %s is not in the sample catalog \n", name.Data());
+                return 0;
+            }
+
+            Sample* s = 0;
+            if(info_only) s = new Sample(e->name, e->type);
+            else
+            {
+                std::vector<TString> files = getFiles(*e, location);
+                if(!location.Contains("UF")) std::cout << ".... " << files.size() << " files added." << std::endl;
+                s = new Sample(files, e->name, e->type);
+            }
+
+            s->xsec = e->xsec;
+            s->lumi = e->lumi;
+            s->minRun = e->minRun;
+            s->maxRun = e->maxRun;
+            s->pileupfile = e->pileupfile;
+            s->systematicsAvailable = e->systematics;
+            return s;
+        }
+
+        // a trailing * matches anything that starts with the rest of the pattern
+        static bool matches(TString pattern, TString s)
+        {
+            if(pattern.EndsWith("*")) return s.BeginsWith(pattern(0, pattern.Length()-1));
+            return s == pattern;
+        }
+
+    private:
+        static std::vector<Entry>& entries()                  { static std::vector<Entry> e; return e; }
+        static std::map<TString, TString>& directories()      { static std::map<TString, TString> d; return d; }
+        static TString& loaded()                              { static TString filename = ""; return filename; }
+        static std::mutex& mutex()                            { static std::mutex m; return m; }
+
+        // xsec=<pb>, lumi=<pb-1>, runs=<min>-<max>, pileup=<file>, systematics=<a,b>, groups=<a,b>.
+        // the numbers may be products like 0.96*181.302, either end of runs may be left out
+        static void setOption(Entry& e, TString option)
+        {
+            TString key = option(0, option.First('='));
+            TString value = option(option.First('=')+1, option.Length());
+            if(key == "xsec")             e.xsec = product(value);
+            else if(key == "lumi")        e.lumi = product(value);
+            else if(key == "runs")
+            {
+                TString min = value(0, value.First('-'));
+                TString max = value(value.First('-')+1, value.Length());
+                if(value.First('-') < 0) min = max = value;
+                if(min != "") e.minRun = min.Atoll();
+                if(max != "") e.maxRun = max.Atoll();
+            }
+            else if(key == "pileup")      e.pileupfile = value;
+            else if(key == "systematics") e.systematics = split(value);
+            else if(key == "groups")      e.groups = split(value);
+            else std::cout << Form("  !!! unknown option %s for %s in the sample catalog \n", option.Data(), e.name.Data());
+        }
+
+        static double product(TString value)
+        {
+            double result = 1;
+            for(auto& factor: split(value, "*"))
+                result *= factor.Atof();
+            return result;
+        }
+
+        static std::vector<TString> split(TString value, TString delim = ",")
+        {
+            std::vector<TString> tokens;
+            TString tok;
+            Ssiz_t from = 0;
+            while(value.Tokenize(tok, from, delim))
+                tokens.push_back(tok);
+            return tokens;
+        }
+
+        // * and ? are only expanded in the file name, sorted so the order of the files is the same every time
+        static std::vector<TString> expand(TString path)
+        {
+            if(!path.Contains("*") && !path.Contains("?")) return std::vector<TString>{path};
+
+            std::vector<TString> files;
+            TString dir = gSystem->DirName(path);
+            TRegexp wildcard(gSystem->BaseName(path), true);
+
+            void* dirp = gSystem->OpenDirectory(dir);
+            if(dirp == 0)
+            {
+                std::cout << Form("  !!! could not list %s for %s \n", dir.Data(), path.Data());
+                return files;
+            }
+            const char* entry;
+            while((entry = gSystem->GetDirEntry(dirp)) != 0)
+            {
+                TString file = entry;
+                Ssiz_t length = 0;
+                if(file.Index(wildcard, &length) == 0 && length == file.Length()) files.push_back(dir+"/"+file);
+            }
+            gSystem->FreeDirectory(dirp);
+
+            if(files.empty()) std::cout << Form("  !!! no files match %s \n", path.Data());
+            std::sort(files.begin(), files.end());
+            return files;
+        }
+};
+
+#endif
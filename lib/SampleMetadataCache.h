@@ -0,0 +1,167 @@
+///////////////////////////////////////////////////////////////////////////
+// ======================================================================//
+// SampleMetadataCache.h                                                 //
+// ======================================================================//
+// The number of entries, original events, and weighted original events  //
+// for each ntuple, saved in a small text index keyed on the file path,  //
+// size, and modification time. Sample looks the files up here instead   //
+// of drawing the metadata tree for every sample at every start up.      //
+// A file that changed or isn't in the index is read once and added.     //
+// GetSamples loads the index before making the samples and saves it     //
+// after.                                                                //
+// ======================================================================//
+///////////////////////////////////////////////////////////////////////////
+
+#ifndef ADD_SAMPLEMETADATACACHE
+#define ADD_SAMPLEMETADATACACHE
+
+#include "TString.h"
+#include "TSystem.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TLeaf.h"
+#include "TDirectory.h"
+
+#include <map>
+#include <mutex>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+class SampleMetadataCache
+{
+    public:
+        struct FileInfo
+        {
+            Long64_t size = -1;              // bytes, -1 if we could not stat the file e.g. xrootd
+            Long_t mtime = -1;
+            Long64_t N = 0;                  // entries in dimuons/tree
+            double nOriginal = 0;            // sum of originalNumEvents in dimuons/metadata
+            double nOriginalWeighted = 0;    // sum of sumEventWeights in dimuons/metadata
+        };
+
+        static TString& indexfile()
+        {
+            static TString filename = "sample_metadata_index.txt";
+            return filename;
+        }
+
+        // read the index into memory, the entries already in memory win
+        static void load(TString filename = "")
+        {
+            if(filename == "") filename = indexfile();
+            std::lock_guard<std::mutex> lock(mutex());
+
+            std::ifstream in(filename.Data());
+            std::string line;
+            while(std::getline(in, line))
+            {
+                if(line.empty() || line[0] == '#') continue;
+                std::stringstream ss(line);
+                std::string path;
+                FileInfo info;
+                if(!(ss >> path >> info.size >> info.mtime >> info.N >> info.nOriginal >> info.nOriginalWeighted)) continue;
+                index().insert(std::make_pair(TString(path.c_str()), info));
+            }
+        }
+
+        // write the index if some files were added since the last save
+        static void save(TString filename = "")
+        {
+            if(filename == "") filename = indexfile();
+            std::lock_guard<std::mutex> lock(mutex());
+            if(!modified()) return;
+
+            std::ofstream out(filename.Data());
+            if(!out)
+            {
+                std::cout << Form("  !!! could not write the sample metadata index %s \n", filename.Data());
+                return;
+            }
+            out << "# path size mtime N nOriginal nOriginalWeighted" << std::endl;
+            for(auto& f: index())
+            {
+                const FileInfo& info = f.second;
+                out << f.first.Data() << " " << info.size << " " << info.mtime << " " << info.N << " "
+                    << Form("%.17g %.17g", info.nOriginal, info.nOriginalWeighted) << std::endl;
+            }
+            modified() = false;
+        }
+
+        // the info for the file from the index if the size and mtime still match, otherwise read it from the file.
+        // Files we can't stat are read every time
+        static FileInfo get(TString filename)
+        {
+            FileInfo stat;
+            getStat(filename, stat);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex());
+                auto f = index().find(filename);
+                if(stat.size >= 0 && f != index().end() && f->second.size == stat.size && f->second.mtime == stat.mtime)
+                    return f->second;
+            }
+
+            FileInfo info = readFile(filename);
+            info.size = stat.size;
+            info.mtime = stat.mtime;
+
+            if(stat.size >= 0)
+            {
+                std::lock_guard<std::mutex> lock(mutex());
+                index()[filename] = info;
+                modified() = true;
+            }
+            return info;
+        }
+
+    private:
+        static std::map<TString, FileInfo>& index() { static std::map<TString, FileInfo> files; return files; }
+        static std::mutex& mutex()                  { static std::mutex m; return m; }
+        static bool& modified()                     { static bool m = false; return m; }
+
+        static void getStat(TString filename, FileInfo& info)
+        {
+            Long_t id, flags, mtime;
+            Long64_t size;
+            if(gSystem->GetPathInfo(filename, &id, &size, &flags, &mtime) != 0) return;
+            info.size = size;
+            info.mtime = mtime;
+        }
+
+        // sum over the metadata tree, one entry per ntuple job that went into the file
+        static FileInfo readFile(TString filename)
+        {
+            FileInfo info;
+            TDirectory::TContext context;   // put gDirectory back when we are done
+            TFile* file = TFile::Open(filename);
+            if(file == 0 || file->IsZombie())
+            {
+                std::cout << Form("  !!! could not open %s for the sample metadata \n", filename.Data());
+                delete file;
+                return info;
+            }
+
+            TTree* tree = (TTree*) file->Get("dimuons/tree");
+            if(tree != 0) info.N = tree->GetEntries();
+
+            TTree* metadata = (TTree*) file->Get("dimuons/metadata");
+            if(metadata != 0)
+            {
+                TLeaf* nevents = metadata->GetLeaf("originalNumEvents");
+                TLeaf* weights = metadata->GetLeaf("sumEventWeights");
+                for(Long64_t i=0; i<metadata->GetEntries(); i++)
+                {
+                    metadata->GetEntry(i);
+                    if(nevents != 0) info.nOriginal += nevents->GetValue();
+                    if(weights != 0) info.nOriginalWeighted += weights->GetValue();
+                }
+            }
+
+            file->Close();
+            delete file;
+            return info;
+        }
+};
+
+#endif
@@ -149,5 +149,45 @@ VarSet::VarSet()
   varMap["electron1_eta"] = &VarSet::electron1_eta; 
   
   varMap["mT_b_MET"] = &VarSet::mT_b_MET;
-  
+
+  // Branches each feature reads --------------------------------------
+  // so that Sample only loads what the job needs. The features from the
+  // cleaned collections need everything that goes into the cleaning.
+  // The bdt scores need the classifier inputs, see TMVATools::getBranchMask.
+  BranchSet::Mask dimu     = BranchSet::bit(BranchSet::kMuPairs) | BranchSet::bit(BranchSet::kMuons);
+  BranchSet::Mask cleaned  = BranchSet::kCleaningBranches;
+  BranchSet::Mask dijets   = BranchSet::bit(BranchSet::kJetPairs) | BranchSet::bit(BranchSet::kJets);
+
+  varDeps["nVertices"] = BranchSet::bit(BranchSet::kNVertices);
+  for(auto& name: {"bdt_score", "bdt_vbf_score", "bdt_ggh_score", "bdt_vh_score", "bdt_ewk_score", "bdt_top_score"})
+      varDeps[name] = 0;
+
+  varDeps["nJets"]     = BranchSet::bit(BranchSet::kNJets);
+  varDeps["nJetsCent"] = BranchSet::bit(BranchSet::kNJetsCent);
+  varDeps["nJetsFwd"]  = BranchSet::bit(BranchSet::kNJetsFwd);
+  varDeps["nBLoose"]   = BranchSet::bit(BranchSet::kNBLoose);
+  varDeps["nBMed"]     = BranchSet::bit(BranchSet::kNBMed);
+  varDeps["nBTight"]   = BranchSet::bit(BranchSet::kNBTight);
+
+  for(auto& name: {"dimu_mass", "dimu_mass_Roch", "dimu_mass_KaMu", "massErr_PF", "massErr_Roch", "massErr_KaMu",
+                   "dimu_pt", "dimu_eta", "dimu_abs_eta", "dimu_rapid", "dimu_dR", "dimu_dEta", "dimu_abs_dEta",
+                   "dimu_dPhi", "dimu_abs_dPhi", "dimu_dPhiStar", "dimu_avg_abs_eta", "dimu_min_abs_eta", "dimu_max_abs_eta",
+                   "mu1_pt", "mu2_pt", "mu1_eta", "mu2_eta", "mu1_abs_eta", "mu2_abs_eta"})
+      varDeps[name] = dimu;
+
+  for(auto& v: varMapI)
+  {
+      if(v.first.find("dijet") == 0) varDeps[v.first] = dijets;
+      else                           varDeps[v.first] = cleaned;
+  }
+
+  varDeps["MET"]      = BranchSet::bit(BranchSet::kMet);
+  varDeps["MHT"]      = BranchSet::bit(BranchSet::kMht);
+  varDeps["MT_had"]   = BranchSet::bit(BranchSet::kMht);
+  varDeps["mass_had"] = BranchSet::bit(BranchSet::kMht);
+  varDeps["mT_b_MET"] = cleaned | BranchSet::bit(BranchSet::kMet);
+
+  // everything else is computed from the cleaned collections and the dimuon candidate
+  for(auto& v: varMap)
+      if(varDeps.count(v.first) == 0) varDeps[v.first] = cleaned;
 }
@@ -26,6 +26,9 @@
 #include "GenMuonInfo.h"
 #include "GenMuPairInfo.h"
 #include "TLorentzVector.h"
+#include "PtEtaPhiM.h"
+#include "EventKinematics.h"
+#include "BranchSet.h"
 
 #include <iostream>
 #include <string>
@@ -36,6 +39,19 @@
 const int N_JETS      = 4;
 const int N_JET_PAIRS = 4;
 
+class VarSet;
+
+// A feature resolved by name once at setup time, see VarSet::getFeature.
+// get(vars) is one call through a member function pointer, no hashing or parsing.
+struct FeatureHandle
+{
+    double (VarSet::*func)() = 0;       // plain features, e.g. dimu_pt
+    double (VarSet::*funcI)(int) = 0;   // indexed features, e.g. jet2_pt -> jet_pt(1)
+    int index = -1;
+
+    inline double get(VarSet& vars) const;
+};
+
 class VarSet
 {
     public:
@@ -76,6 +92,8 @@ class VarSet
         }
 
         float pu_wgt;      // weight mc based upon PU to match data PU distribution
+        float pu_wgt_up = 1;     // PU systematic variations, only loaded when the systematics
+        float pu_wgt_down = 1;   // are processed in the same event loop as the nominal
         
 
         // reco info
@@ -114,11 +132,28 @@ class VarSet
         // Cleaned Collections ------------------------------------------------------
         //////////////////////////////////////////////////////////////////////////////
 
-        std::vector<TLorentzVector> validMuons;
-        std::vector<TLorentzVector> validExtraMuons;
-        std::vector<TLorentzVector> validElectrons;
-        std::vector<TLorentzVector> validJets;
-        std::vector<TLorentzVector> validBJets;
+        // plain pt/eta/phi/m structs, the vectors are cleared every event but keep their memory.
+        // validJets[i].get4vec() or assigning to a TLorentzVector gives the old TLorentzVector
+        std::vector<PtEtaPhiM> validMuons;
+        std::vector<PtEtaPhiM> validExtraMuons;
+        std::vector<PtEtaPhiM> validElectrons;
+        std::vector<PtEtaPhiM> validJets;
+        std::vector<PtEtaPhiM> validBJets;
+
+        // arrays of the valid jets and bjets plus the dijet quantities, filled once per event.
+        // The jet cleaner marks it invalid, use kin() to get it up to date
+        EventKinematics kinematics;
+
+        EventKinematics& kin()
+        {
+            if(!kinematics.valid)
+            {
+                kinematics.fill(validJets, validBJets);
+                kinematics.jj.set(kinematics.jets, j0, j1);
+                kinematics.vbfjj.set(kinematics.jets, vbf_j0, vbf_j1);
+            }
+            return kinematics;
+        }
 
         //////////////////////////////////////////////////////////////////////////////
         // Map String to Feature value (double) -------------------------------------
@@ -129,29 +164,82 @@ class VarSet
         std::unordered_map<std::string, double(VarSet::*)()> varMap;
         std::unordered_map<std::string, double(VarSet::*)(int)> varMapI;
 
-        // get the the value for some variable in one of the structs above
-        // by name (string). Use the varMap to get the appropriate function
-        // of those below.
-        // Now we can easily output the values for training TString->Value
-        // And evaluate the XML categories via getValue(varTString) > cut
-        double getValue(const std::string& name) 
+        // look up the function for some variable in one of the structs above
+        // by name (string) once, then use the handle for every event.
+        // Unknown features return -999. Only reads the maps, so it is safe
+        // to call from several threads.
+        FeatureHandle getFeature(const std::string& name) const
         {
-	  // std::cout << "\n  * Getting value for variable with name " << name << std::endl;
-          // Must call the function for this particular instance
-          if (varMap[name])
-            return (this->*varMap[name])();
-	  else if (varMapI[name]) {
-	    std::string iStr = &(name.substr(0, name.find("_")).back());
-	    int iObj = -99;
-	    std::stringstream convert(iStr);
-	    convert >> iObj;
-            return (this->*varMapI[name])(iObj - 1); // Vector indices are 1 lower
-	  }
-	  else return -999;
+          FeatureHandle feature;
+          auto f = varMap.find(name);
+          if(f != varMap.end() && f->second != 0)
+          {
+              feature.func = f->second;
+              return feature;
+          }
+
+          auto fi = varMapI.find(name);
+          if(fi != varMapI.end() && fi->second != 0)
+          {
+	      // jet2_pt -> jet_pt(1), vector indices are 1 lower
+	      std::string iStr = &(name.substr(0, name.find("_")).back());
+	      int iObj = -99;
+	      std::stringstream convert(iStr);
+	      convert >> iObj;
+              feature.funcI = fi->second;
+              feature.index = iObj - 1;
+              return feature;
+          }
+
+          feature.func = &VarSet::unknownFeature;
+          return feature;
         }
+
+        // same as getFeature for code that has no VarSet at hand, e.g. the XML categories
+        static FeatureHandle findFeature(const std::string& name)
+        {
+            static const VarSet features;
+            return features.getFeature(name);
+        }
+
+        std::vector<FeatureHandle> getFeatures(const std::vector<TString>& names) const
+        {
+            std::vector<FeatureHandle> features;
+            for(auto& name: names)
+                features.push_back(getFeature(name.Data()));
+            return features;
+        }
+
+        // get the the value for some variable in one of the structs above
+        // by name (string). Resolves the name every call, use getFeature 
+        // in event loops.
+        // Now we can easily output the values for training TString->Value
+        double getValue(const std::string& name) { return getFeature(name).get(*this); }
 	
         // see if the var string is in the map
-        bool checkForVar(const std::string& name){return (varMap[name] || varMapI[name]); }
+        bool checkForVar(const std::string& name) const
+        {
+            return (varMap.count(name) > 0 && varMap.at(name) != 0) || (varMapI.count(name) > 0 && varMapI.at(name) != 0);
+        }
+
+        // the branches each feature needs, filled in the constructor next to the varMap
+        std::unordered_map<std::string, BranchSet::Mask> varDeps;
+
+        // the branches needed to compute the features, unknown features need everything
+        BranchSet::Mask getBranchMask(const std::string& name)
+        {
+            auto dep = varDeps.find(name);
+            if(dep == varDeps.end()) return BranchSet::kAllBranches;
+            return dep->second;
+        }
+
+        BranchSet::Mask getBranchMask(const std::vector<TString>& names)
+        {
+            BranchSet::Mask mask = 0;
+            for(auto& name: names)
+                mask |= getBranchMask(name.Data());
+            return mask;
+        }
 
         //////////////////////////////////////////////////////////////////////////////
         // Set systematic to vary ---------------------------------------------------
@@ -238,27 +326,33 @@ class VarSet
             vbf_j0 = 0;
             vbf_j1 = 1;
             double mjj_max = -999;
+            bool found = false;
 
-            for(unsigned int i=0; i<validJets.size(); i++) 
+            // the pair masses and dEtas were already computed for the event
+            EventKinematics& k = kin();
+            unsigned int n = k.jets.n;
+            for(unsigned int i=0; i<n && !found; i++) 
             {
-                if(!(validJets[i].Pt() > cLeadPtMin)) break;
-                for(unsigned int j=i+1; j<validJets.size(); j++) 
+                if(!(k.jets.pt[i] > cLeadPtMin)) break;
+                const double* mjj = &k.mjj[i*n];
+                const double* dEtajj = &k.dEtajj[i*n];
+                for(unsigned int j=i+1; j<n; j++) 
                 {
-                    double dEtajj = TMath::Abs(validJets[i].Eta() - validJets[j].Eta());
-                    double mjj = (validJets[i] + validJets[j]).M();
-                    if(mjj > mjj_max)
+                    if(mjj[j] > mjj_max)
                     {
                         vbf_j0 = i;
                         vbf_j1 = j;
                     }
-                    if(mjj > cDijetMassMinVBFT && dEtajj > cDijetDeltaEtaMinVBFT)
+                    if(mjj[j] > cDijetMassMinVBFT && dEtajj[j] > cDijetDeltaEtaMinVBFT)
                     {
                         vbf_j0 = i;
                         vbf_j1 = j;
-                        return; 
+                        found = true;
+                        break; 
                     }
                 }
             }
+            k.vbfjj.set(k.jets, vbf_j0, vbf_j1);
         }
 
         //////////////////////////////////////////////////////////////////////////////
@@ -276,19 +370,21 @@ class VarSet
             j0 = 0;
             j1 = 1;
 
-            for(unsigned int i=0; i<validJets.size(); i++) 
+            EventKinematics& k = kin();
+            unsigned int n = k.jets.n;
+            for(unsigned int i=0; i<n; i++) 
             {
-                for(unsigned int j=i+1; j<validJets.size(); j++) 
+                const double* mjj = &k.mjj[i*n];
+                for(unsigned int j=i+1; j<n; j++) 
                 {
-                    double dEtajj = TMath::Abs(validJets[i].Eta() - validJets[j].Eta());
-                    double mjj = (validJets[i] + validJets[j]).M();
-                    if(mjj > mjj_max)
+                    if(mjj[j] > mjj_max)
                     {
                         j0 = i;
                         j1 = j;
                     }
                 }
             }
+            k.jj.set(k.jets, j0, j1);
         }
 
         //////////////////////////////////////////////////////////////////////////////
@@ -296,6 +392,7 @@ class VarSet
         //////////////////////////////////////////////////////////////////////////////
 
         // Map initialized in cxx file -----------------------------------------------
+        double unknownFeature(){ return -999;             };
         double _nVertices(){ return nVertices;            };
 
         // load the bdt score manually beforehand
@@ -340,13 +437,9 @@ class VarSet
         double dimu_dPhi()        { return dimuCand->dPhi;             };
         double dimu_abs_dPhi()    { return TMath::Abs(dimuCand->dPhi); };
         double dimu_dPhiStar() {  // Phi separation in the parent's rest frame
-	  double phi_star = 0;
-	  double mu_dPhi = TMath::Abs(muons->at(dimuCand->iMu1).phi - muons->at(dimuCand->iMu2).phi);
-	  if(mu_dPhi > TMath::Pi()) mu_dPhi = 2*TMath::Pi() - mu_dPhi;
-	  double phiACOP = TMath::Pi() - mu_dPhi;
-	  double thetaStarEta = TMath::ACos(TMath::TanH((muons->at(dimuCand->iMu1).eta - muons->at(dimuCand->iMu2).eta)/2));
-	  phi_star = TMath::Tan(phiACOP/2)*TMath::Sin(thetaStarEta);
-	  return phi_star;
+	  const MuonInfo& mu1 = muons->at(dimuCand->iMu1);
+	  const MuonInfo& mu2 = muons->at(dimuCand->iMu2);
+	  return kinematics.getDPhiStar(mu1.eta, mu1.phi, mu2.eta, mu2.phi);
 	}
         double dimu_avg_abs_eta() { return ( TMath::Abs(muons->at(dimuCand->iMu1).eta) +
 					     TMath::Abs(muons->at(dimuCand->iMu2).eta) ) / 2.; };
@@ -392,34 +485,35 @@ class VarSet
 
 
 	// AMC variables
-	double jj_jet0_pt()  { return (validJets.size()>=1)?validJets[j0].Pt():-999;  };
-        double jj_jet1_pt()  { return (validJets.size()>=2)?validJets[j1].Pt():-999;  };
-	double jj_jet0_eta() { return (validJets.size()>=1)?validJets[j0].Eta():-999; };
-        double jj_jet1_eta() { return (validJets.size()>=2)?validJets[j1].Eta():-999; };
-
-	double m_jj()         { return (validJets.size()>=2)?(validJets[j0]+validJets[j1]).M():-999; };
-        double dEta_jj()      { return (validJets.size()>=2)?TMath::Abs(validJets[j0].Eta()-validJets[j1].Eta()):-999; };
-        double dEta_jj_mumu() { return (validJets.size()>=2)?TMath::Abs((validJets[j0]+validJets[j1]).Eta()-dimuCand->eta):-999; };
+	// the dijet values come from kin(), computed once per event
+	double jj_jet0_pt()  { return (validJets.size()>=1)?kin().jj.pt0:-999;  };
+        double jj_jet1_pt()  { return (validJets.size()>=2)?kin().jj.pt1:-999;  };
+	double jj_jet0_eta() { return (validJets.size()>=1)?kin().jj.eta0:-999; };
+        double jj_jet1_eta() { return (validJets.size()>=2)?kin().jj.eta1:-999; };
+
+	double m_jj()         { return (validJets.size()>=2)?kin().jj.m:-999; };
+        double dEta_jj()      { return (validJets.size()>=2)?kin().jj.dEta:-999; };
+        double dEta_jj_mumu() { return (validJets.size()>=2)?TMath::Abs(kin().jj.eta-dimuCand->eta):-999; };
         double dPhi_jj_mumu() { 
 	  if (validJets.size() < 2) return -999;
-	  double dphi = TMath::Abs((validJets[j0] + validJets[j1]).Phi() - dimuCand->phi);
+	  double dphi = TMath::Abs(kin().jj.phi - dimuCand->phi);
 	  if (dphi > TMath::Pi()) dphi = 2*TMath::Pi() - dphi;
+	  return dphi;
         };
         double zep() { 
 	  if (validJets.size() < 2) return -999; 
-	  double meanEta = (validJets[j0].Eta() +validJets[j1].Eta())/2;
-	  return validJets[j0].Eta() - meanEta;
+	  return kin().jj.zep;
         };
 
         // vbf jet variables
-        double vbf_jet0_pt()  { return (validJets.size()>=1)?validJets[vbf_j0].Pt():-999;  };
-        double vbf_jet1_pt()  { return (validJets.size()>=2)?validJets[vbf_j1].Pt():-999;  };
-        double vbf_jet0_eta() { return (validJets.size()>=1)?validJets[vbf_j0].Eta():-999; };
-        double vbf_jet1_eta() { return (validJets.size()>=2)?validJets[vbf_j1].Eta():-999; };
+        double vbf_jet0_pt()  { return (validJets.size()>=1)?kin().vbfjj.pt0:-999;  };
+        double vbf_jet1_pt()  { return (validJets.size()>=2)?kin().vbfjj.pt1:-999;  };
+        double vbf_jet0_eta() { return (validJets.size()>=1)?kin().vbfjj.eta0:-999; };
+        double vbf_jet1_eta() { return (validJets.size()>=2)?kin().vbfjj.eta1:-999; };
 
-        double vbf_m_jj()         { return (validJets.size()>=2)?(validJets[vbf_j0]+validJets[vbf_j1]).M():-999; };
-        double vbf_dEta_jj()      { return (validJets.size()>=2)?TMath::Abs(validJets[vbf_j0].Eta()-validJets[vbf_j1].Eta()):-999; };
-        double vbf_dEta_jj_mumu() { return (validJets.size()>=2)?TMath::Abs((validJets[vbf_j0]+validJets[vbf_j1]).Eta()-dimuCand->eta):-999; };
+        double vbf_m_jj()         { return (validJets.size()>=2)?kin().vbfjj.m:-999; };
+        double vbf_dEta_jj()      { return (validJets.size()>=2)?kin().vbfjj.dEta:-999; };
+        double vbf_dEta_jj_mumu() { return (validJets.size()>=2)?TMath::Abs(kin().vbfjj.eta-dimuCand->eta):-999; };
 
         // bjet variables
         double bjet0_pt() { return (validBJets.size()>=1)?validBJets[0].Pt():-999;  };
@@ -427,20 +521,20 @@ class VarSet
         double bjet0_eta(){ return (validBJets.size()>=1)?validBJets[0].Eta():-999; };
         double bjet1_eta(){ return (validBJets.size()>=2)?validBJets[1].Eta():-999; };
 
-        double m_bb()   { return (validBJets.size()>=2)?(validBJets[0]+validBJets[1]).M():-999; };
-        double dEta_bb(){ return (validBJets.size()>=2)?TMath::Abs(validBJets[0].Eta()-validBJets[1].Eta()):-999; };
+        double m_bb()   { return (validBJets.size()>=2)?kin().bb.m:-999; };
+        double dEta_bb(){ return (validBJets.size()>=2)?kin().bb.dEta:-999; };
 
         double vbf_dPhi_jj_mumu()    
         { 
             if(validJets.size() < 2) return -999;
-            double dphi = TMath::Abs((validJets[vbf_j0] + validJets[vbf_j1]).Phi() - dimuCand->phi);
+            double dphi = TMath::Abs(kin().vbfjj.phi - dimuCand->phi);
             if(dphi > TMath::Pi()) dphi = 2*TMath::Pi() - dphi;
+            return dphi;
         };
 
         double vbf_zep() { 
 	  if (validJets.size() < 2) return -999; 
-	  double meanEta = (validJets[vbf_j0].Eta() +validJets[vbf_j1].Eta())/2;
-	  return validJets[vbf_j0].Eta() - meanEta;
+	  return kin().vbfjj.zep;
         };
 
         double extra_muon0_pt() { return (validExtraMuons.size()>=1)?validExtraMuons[0].Pt():-999; };
@@ -456,13 +550,19 @@ class VarSet
         double mT_b_MET()
         { 
             if(validBJets.size() < 1) return -999;
-            TLorentzVector metv(met->pt*TMath::Cos(met->phi), met->pt*TMath::Cos(met->phi), 0, met->pt);                  
-            TLorentzVector bjet = validBJets[0];
-            TLorentzVector bjet_t(bjet.Px(), bjet.Py(), 0, bjet.Et());
-            TLorentzVector bmet_t = metv + bjet_t;
+            const KinematicsBlock& b = kin().bjets;
+            PxPyPzE metv(met->pt*TMath::Cos(met->phi), met->pt*TMath::Cos(met->phi), 0, met->pt);                  
+            PxPyPzE bjet_t(b.px[0], b.py[0], 0, b.e[0]/TMath::CosH(b.eta[0]));
+            PxPyPzE bmet_t = metv + bjet_t;
             return bmet_t.M();
         };
 
 };
 
+inline double FeatureHandle::get(VarSet& vars) const
+{
+    if(func != 0) return (vars.*func)();
+    return (vars.*funcI)(index);
+}
+
 #endif
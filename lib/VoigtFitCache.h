@@ -0,0 +1,129 @@
+///////////////////////////////////////////////////////////////////////////
+// ======================================================================//
+// VoigtFitCache.h                                                       //
+// ======================================================================//
+// The Voigtian fit results of MassCalibration, saved in a small text    //
+// file keyed on the md5 of the histogram contents, errors, and axis     //
+// plus the fit settings. Refitting a histogram that didn't change, e.g. //
+// rerunning masscalibration with the same binning, reads the result     //
+// from here instead of running Minuit again. MassCalibration::fit       //
+// loads the file before the fits and saves it after.                    //
+// ======================================================================//
+///////////////////////////////////////////////////////////////////////////
+
+#ifndef ADD_VOIGTFITCACHE
+#define ADD_VOIGTFITCACHE
+
+#include "TString.h"
+#include "TH1D.h"
+#include "TMD5.h"
+
+#include <map>
+#include <mutex>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+class VoigtFitCache
+{
+    public:
+        struct FitResult
+        {
+            double constant = 0;
+            double constant_err = 0;
+            double mean = 0;
+            double mean_err = 0;
+            double sigma = 0;
+            double sigma_err = 0;
+            double gamma = 0;
+            double gamma_err = 0;
+            int converged = 0;
+        };
+
+        static TString& cachefile()
+        {
+            static TString filename = "voigt_fit_cache.txt";
+            return filename;
+        }
+
+        // read the file into memory once, the results already in memory win
+        static void load(TString filename = "")
+        {
+            if(filename == "") filename = cachefile();
+            std::lock_guard<std::mutex> lock(mutex());
+            if(loaded() == filename) return;
+
+            std::ifstream in(filename.Data());
+            std::string line;
+            while(std::getline(in, line))
+            {
+                if(line.empty() || line[0] == '#') continue;
+                std::stringstream ss(line);
+                std::string key;
+                FitResult r;
+                if(!(ss >> key >> r.constant >> r.constant_err >> r.mean >> r.mean_err >> r.sigma >> r.sigma_err
+                        >> r.gamma >> r.gamma_err >> r.converged)) continue;
+                results().insert(std::make_pair(TString(key.c_str()), r));
+            }
+            loaded() = filename;
+        }
+
+        // write the file if some fits were added since the last save
+        static void save(TString filename = "")
+        {
+            if(filename == "") filename = cachefile();
+            std::lock_guard<std::mutex> lock(mutex());
+            if(!modified()) return;
+
+            std::ofstream out(filename.Data());
+            if(!out)
+            {
+                std::cout << Form("  !!! could not write the voigt fit cache %s \n", filename.Data());
+                return;
+            }
+            out << "# key constant constant_err mean mean_err sigma sigma_err gamma gamma_err converged" << std::endl;
+            for(auto& f: results())
+            {
+                const FitResult& r = f.second;
+                out << f.first.Data() << " " << Form("%.17g %.17g %.17g %.17g %.17g %.17g %.17g %.17g %d", r.constant, r.constant_err,
+                                                     r.mean, r.mean_err, r.sigma, r.sigma_err, r.gamma, r.gamma_err, r.converged) << std::endl;
+            }
+            modified() = false;
+        }
+
+        // the key for a histogram and the settings of its fit, settings are e.g. the fit window and gamma
+        static TString getKey(TH1D* h, TString settings)
+        {
+            TMD5 md5;
+            TString axis = Form("%d %.10g %.10g %s", h->GetNbinsX(), h->GetXaxis()->GetXmin(), h->GetXaxis()->GetXmax(), settings.Data());
+            md5.Update((const UChar_t*) axis.Data(), axis.Length());
+            md5.Update((const UChar_t*) h->GetArray(), h->GetSize()*sizeof(Double_t));
+            if(h->GetSumw2N() > 0) md5.Update((const UChar_t*) h->GetSumw2()->GetArray(), h->GetSumw2N()*sizeof(Double_t));
+            md5.Final();
+            return md5.AsString();
+        }
+
+        static bool get(TString key, FitResult& result)
+        {
+            std::lock_guard<std::mutex> lock(mutex());
+            auto f = results().find(key);
+            if(f == results().end()) return false;
+            result = f->second;
+            return true;
+        }
+
+        static void put(TString key, const FitResult& result)
+        {
+            std::lock_guard<std::mutex> lock(mutex());
+            results()[key] = result;
+            modified() = true;
+        }
+
+    private:
+        static std::map<TString, FitResult>& results() { static std::map<TString, FitResult> r; return r; }
+        static std::mutex& mutex()                     { static std::mutex m; return m; }
+        static bool& modified()                        { static bool m = false; return m; }
+        static TString& loaded()                       { static TString filename = ""; return filename; }
+};
+
+#endif
@@ -42,7 +42,97 @@ void XMLCategorizer::initCategoryMap()
 
 void XMLCategorizer::evaluate(VarSet& vars)
 {
-    evaluateRecursive(vars, rootNode); 
+    if(nodes.size() == 0) evaluateRecursive(vars, rootNode); 
+    else setInCategoryFromLeaf(filterToLeaf(vars));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void XMLCategorizer::compile()
+{
+    nodes.clear();
+    compileRecursive(rootNode, -1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+int XMLCategorizer::compileRecursive(CategoryNode* cnode, int mother)
+{
+    int inode = nodes.size();
+    nodes.push_back(FlatCategoryNode());
+
+    FlatCategoryNode& node = nodes[inode];
+    node.feature = cnode->splitFeature;
+    node.splitVal = cnode->splitVal;
+    node.left = -1;
+    node.right = -1;
+    node.mother = mother;
+    node.category = registerCategory(cnode->key);
+
+    // terminal node
+    if(cnode->left == 0 || cnode->right == 0)
+        return inode;
+
+    // nodes may move when the vector grows, don't hold on to the reference
+    int left = compileRecursive(cnode->left, inode);
+    int right = compileRecursive(cnode->right, inode);
+    nodes[inode].left = left;
+    nodes[inode].right = right;
+    return inode;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+int XMLCategorizer::filterToLeaf(VarSet& vars)
+{
+    int inode = 0;
+    while(nodes[inode].left >= 0)
+    {
+        const FlatCategoryNode& node = nodes[inode];
+        inode = (node.feature.get(vars) <= node.splitVal) ? node.left : node.right;
+    }
+    return inode;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void XMLCategorizer::setInCategoryFromLeaf(int leaf)
+{
+    // if it was filtered into this node then it's in this category and all of the ones above
+    for(int inode = leaf; inode >= 0; inode = nodes[inode].mother)
+        setInCategory(nodes[inode].category);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void XMLCategorizer::evaluate(VarSet** events, int nevents, int* leaves)
+{
+    for(int i=0; i<nevents; i++)
+        leaves[i] = 0;
+
+    // move every event that isn't at a terminal node down one level, until they are all done
+    bool moved = true;
+    while(moved)
+    {
+        moved = false;
+        for(int i=0; i<nevents; i++)
+        {
+            const FlatCategoryNode& node = nodes[leaves[i]];
+            if(node.left < 0) continue;
+            leaves[i] = (node.feature.get(*events[i]) <= node.splitVal) ? node.left : node.right;
+            moved = true;
+        }
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -52,7 +142,7 @@ void XMLCategorizer::evaluate(VarSet& vars)
 void XMLCategorizer::evaluateRecursive(VarSet& vars, CategoryNode* cnode)
 {
     // if it was filtered into this node then it's in this category
-    categoryMap[cnode->key].inCategory = true;
+    setInCategory(registerCategory(cnode->key));
 
     // return if terminal node
     if(cnode->left == 0 || cnode->right == 0)
@@ -61,9 +151,8 @@ void XMLCategorizer::evaluateRecursive(VarSet& vars, CategoryNode* cnode)
     }
 
     // if not terminal node, filter to correct daughter node
-    const char* splitVarName = cnode->splitVarName.Data();
     double splitValue   = cnode->splitVal;
-    double xvalue = vars.getValue(splitVarName); 
+    double xvalue = cnode->splitFeature.get(vars); 
     
     if(xvalue <= splitValue) 
         evaluateRecursive(vars, cnode->left);
@@ -75,6 +164,32 @@ void XMLCategorizer::evaluateRecursive(VarSet& vars, CategoryNode* cnode)
 //-----------------------------------------------------------------------------
 ///////////////////////////////////////////////////////////////////////////////
 
+BranchSet::Mask XMLCategorizer::getBranchMask(VarSet& vars)
+{
+    std::vector<TString> names;
+    getSplitVarNamesRecursive(rootNode, names);
+    return vars.getBranchMask(names);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void XMLCategorizer::getSplitVarNamesRecursive(CategoryNode* cnode, std::vector<TString>& names)
+{
+    // terminal nodes don't split on anything
+    if(cnode == 0 || cnode->left == 0 || cnode->right == 0)
+        return;
+
+    names.push_back(cnode->splitVarName);
+    getSplitVarNamesRecursive(cnode->left, names);
+    getSplitVarNamesRecursive(cnode->right, names);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
 XMLCategorizer::XMLCategorizer()
 {
     rootNode = new CategoryNode(0, 0, 0, "", -999, "", -999, -999);
@@ -119,6 +234,9 @@ void XMLCategorizer::loadFromXML(TString filename)
 
     delete xml;
 
+    // flat array version of the tree for evaluate
+    compile();
+
     int i=0;
     for(auto& c: categoryMap)
     {
@@ -185,6 +303,7 @@ void XMLCategorizer::loadFromXMLRecursive(TXMLEngine* xml, XMLNodePointer_t xnod
     //std::cout << "svar: " << splitVar << ", svar_name: " << splitVarName << ", split_val: " << splitVal << ", sig2: " << significanceSquared << std::endl;
     cnode->splitVar = splitVar;
     cnode->splitVarName = splitVarName;
+    cnode->splitFeature = VarSet::findFeature(splitVarName.Data());
     cnode->splitVal = splitVal;
     cnode->significanceSquared = significanceSquared;
 
@@ -250,22 +369,22 @@ void CategorySelectionBDT::initCategoryMap()
     // Category(name), Category(name, hide?), Category(name, hide?, isTerminal?)
     // defaults are hide = false, isTerminal = false
 
-    categoryMap["cAll"] = Category("cAll", false, false);
-    categoryMap["c0"] = Category("c0", false, true);
-    categoryMap["c1"] = Category("c1", false, true);
-    categoryMap["c2"] = Category("c2", false, true);
-    categoryMap["c3"] = Category("c3", false, true);
-    categoryMap["c4"] = Category("c4", false, true);
-    categoryMap["c5"] = Category("c5", false, true);
-    categoryMap["c6"] = Category("c6", false, true);
-    categoryMap["c7"] = Category("c7", false, true);
-    categoryMap["c8"] = Category("c8", false, true);
-    categoryMap["c9"] = Category("c9", false, true);
-    categoryMap["c10"] = Category("c10", false, true);
-    categoryMap["c11"] = Category("c11", false, true);
-    categoryMap["c12"] = Category("c12", false, true);
-    categoryMap["c13"] = Category("c13", false, true);
-    categoryMap["c14"] = Category("c14", false, true);
+    addCategory(kAll, Category("cAll", false, false));
+    addCategory(k0, Category("c0", false, true));
+    addCategory(k1, Category("c1", false, true));
+    addCategory(k2, Category("c2", false, true));
+    addCategory(k3, Category("c3", false, true));
+    addCategory(k4, Category("c4", false, true));
+    addCategory(k5, Category("c5", false, true));
+    addCategory(k6, Category("c6", false, true));
+    addCategory(k7, Category("c7", false, true));
+    addCategory(k8, Category("c8", false, true));
+    addCategory(k9, Category("c9", false, true));
+    addCategory(k10, Category("c10", false, true));
+    addCategory(k11, Category("c11", false, true));
+    addCategory(k12, Category("c12", false, true));
+    addCategory(k13, Category("c13", false, true));
+    addCategory(k14, Category("c14", false, true));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -285,56 +404,56 @@ void CategorySelectionBDT::evaluate(VarSet& vars)
 {
 // Determine which category the event belongs to
 
-    double bdt_score = vars.getValue("bdt_score");
-    double max_eta = vars.getValue("dimu_max_abs_eta");
+    double bdt_score = vars.bdt_score();
+    double max_eta = vars.dimu_max_abs_eta();
 
     // Inclusive set of events
-    categoryMap["cAll"].inCategory = true;
+    setInCategory(kAll);
 
     if( bdt_score < -0.400 ) 
-        categoryMap["c0"].inCategory = true;
+        setInCategory(k0);
 
     else if( bdt_score >= -0.400 && bdt_score < 0.050 && max_eta >= 1.900 )
-        categoryMap["c1"].inCategory = true;
+        setInCategory(k1);
 
     else if( bdt_score >= -0.400 && bdt_score < 0.050 && max_eta < 1.900  && max_eta >=0.9) 
-        categoryMap["c2"].inCategory = true;
+        setInCategory(k2);
 
     else if( bdt_score >= -0.400 && bdt_score < 0.050 && max_eta < 0.9 ) 
-        categoryMap["c3"].inCategory = true;
+        setInCategory(k3);
 
     else if( bdt_score >= 0.050 && bdt_score < 0.250 && max_eta >= 1.9) 
-        categoryMap["c4"].inCategory = true;
+        setInCategory(k4);
 
     else if( bdt_score >= 0.050 && bdt_score < 0.250 && max_eta >= 0.900 && max_eta < 1.9) 
-        categoryMap["c5"].inCategory = true;
+        setInCategory(k5);
 
     else if( bdt_score >= 0.050 && bdt_score < 0.250 && max_eta < 0.900 ) 
-        categoryMap["c6"].inCategory = true;
+        setInCategory(k6);
 
     else if( bdt_score >= 0.250 && bdt_score < 0.400 && max_eta >= 1.900 )
-        categoryMap["c7"].inCategory = true;
+        setInCategory(k7);
 
     else if( bdt_score >= 0.250 && bdt_score < 0.400 && max_eta < 1.900 && max_eta >= 0.900 ) 
-        categoryMap["c8"].inCategory = true;
+        setInCategory(k8);
 
     else if( bdt_score >= 0.250 && bdt_score < 0.400 && max_eta < 0.900 ) 
-        categoryMap["c9"].inCategory = true;
+        setInCategory(k9);
 
     else if( bdt_score < 0.650 && bdt_score >= 0.400 && max_eta >= 1.900 ) 
-        categoryMap["c10"].inCategory = true;
+        setInCategory(k10);
 
     else if( bdt_score < 0.650 && bdt_score >= 0.400 && max_eta < 1.900 && max_eta >= 0.900 ) 
-        categoryMap["c11"].inCategory = true;
+        setInCategory(k11);
 
     else if( bdt_score < 0.650 && bdt_score >= 0.400 && max_eta < 0.900 ) 
-        categoryMap["c12"].inCategory = true;
+        setInCategory(k12);
 
     else if( bdt_score < 0.730 && bdt_score >= 0.650 ) 
-        categoryMap["c13"].inCategory = true;
+        setInCategory(k13);
 
     else if( bdt_score >= 0.730 )
-        categoryMap["c14"].inCategory = true;
+        setInCategory(k14);
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -350,39 +469,39 @@ void CategorySelectionRun1::initCategoryMap()
     // Category(name), Category(name, hide?), Category(name, hide?, isTerminal?)
     // defaults are hide = false, isTerminal = false
 
-    categoryMap["c_ALL"] = Category("c_ALL");
+    addCategory(kALL, Category("c_ALL"));
 
     // intermediate categories to make things easier
-    categoryMap["c_2_Jet"] = Category("c_2_Jet");
-    categoryMap["c_01_Jet"] = Category("c_01_Jet");
+    addCategory(k2_Jet, Category("c_2_Jet"));
+    addCategory(k01_Jet, Category("c_01_Jet"));
 
-    categoryMap["c_2_Jet_VBF_Tight"] = Category("c_2_Jet_VBF_Tight", false, true);
-    categoryMap["c_2_Jet_VBF_Loose"] = Category("c_2_Jet_VBF_Loose", false, true);
-    categoryMap["c_2_Jet_GGF_Tight"] = Category("c_2_Jet_GGF_Tight", false, true);
-    categoryMap["c_01_Jet_Tight"] = Category("c_01_Jet_Tight");
-    categoryMap["c_01_Jet_Loose"] = Category("c_01_Jet_Loose");
+    addCategory(k2_Jet_VBF_Tight, Category("c_2_Jet_VBF_Tight", false, true));
+    addCategory(k2_Jet_VBF_Loose, Category("c_2_Jet_VBF_Loose", false, true));
+    addCategory(k2_Jet_GGF_Tight, Category("c_2_Jet_GGF_Tight", false, true));
+    addCategory(k01_Jet_Tight, Category("c_01_Jet_Tight"));
+    addCategory(k01_Jet_Loose, Category("c_01_Jet_Loose"));
 
     // intermediate categories to make things easier, don't plot these, hence the hide=true
-    categoryMap["c_BB"] = Category("c_BB", true);
-    categoryMap["c_BO"] = Category("c_BO", true);
-    categoryMap["c_BE"] = Category("c_BE", true);
-    categoryMap["c_OO"] = Category("c_OO", true);
-    categoryMap["c_OE"] = Category("c_OE", true);
-    categoryMap["c_EE"] = Category("c_EE", true);
-
-    categoryMap["c_01_Jet_Tight_BB"] = Category("c_01_Jet_Tight_BB", false, true);
-    categoryMap["c_01_Jet_Tight_BO"] = Category("c_01_Jet_Tight_BO", false, true);
-    categoryMap["c_01_Jet_Tight_BE"] = Category("c_01_Jet_Tight_BE", false, true);
-    categoryMap["c_01_Jet_Tight_OO"] = Category("c_01_Jet_Tight_OO", false, true);
-    categoryMap["c_01_Jet_Tight_OE"] = Category("c_01_Jet_Tight_OE", false, true);
-    categoryMap["c_01_Jet_Tight_EE"] = Category("c_01_Jet_Tight_EE", false, true);
-
-    categoryMap["c_01_Jet_Loose_BB"] = Category("c_01_Jet_Loose_BB", false, true);
-    categoryMap["c_01_Jet_Loose_BO"] = Category("c_01_Jet_Loose_BO", false, true);
-    categoryMap["c_01_Jet_Loose_BE"] = Category("c_01_Jet_Loose_BE", false, true);
-    categoryMap["c_01_Jet_Loose_OO"] = Category("c_01_Jet_Loose_OO", false, true);
-    categoryMap["c_01_Jet_Loose_OE"] = Category("c_01_Jet_Loose_OE", false, true);
-    categoryMap["c_01_Jet_Loose_EE"] = Category("c_01_Jet_Loose_EE", false, true);
+    addCategory(kBB, Category("c_BB", true));
+    addCategory(kBO, Category("c_BO", true));
+    addCategory(kBE, Category("c_BE", true));
+    addCategory(kOO, Category("c_OO", true));
+    addCategory(kOE, Category("c_OE", true));
+    addCategory(kEE, Category("c_EE", true));
+
+    addCategory(k01_Jet_Tight_BB, Category("c_01_Jet_Tight_BB", false, true));
+    addCategory(k01_Jet_Tight_BO, Category("c_01_Jet_Tight_BO", false, true));
+    addCategory(k01_Jet_Tight_BE, Category("c_01_Jet_Tight_BE", false, true));
+    addCategory(k01_Jet_Tight_OO, Category("c_01_Jet_Tight_OO", false, true));
+    addCategory(k01_Jet_Tight_OE, Category("c_01_Jet_Tight_OE", false, true));
+    addCategory(k01_Jet_Tight_EE, Category("c_01_Jet_Tight_EE", false, true));
+
+    addCategory(k01_Jet_Loose_BB, Category("c_01_Jet_Loose_BB", false, true));
+    addCategory(k01_Jet_Loose_BO, Category("c_01_Jet_Loose_BO", false, true));
+    addCategory(k01_Jet_Loose_BE, Category("c_01_Jet_Loose_BE", false, true));
+    addCategory(k01_Jet_Loose_OO, Category("c_01_Jet_Loose_OO", false, true));
+    addCategory(k01_Jet_Loose_OE, Category("c_01_Jet_Loose_OE", false, true));
+    addCategory(k01_Jet_Loose_EE, Category("c_01_Jet_Loose_EE", false, true));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -459,56 +578,56 @@ void CategorySelectionRun1::evaluate(VarSet& vars)
 // Determine which category the event belongs to
 
     // Inclusive category, all events that passed the selection cuts
-    categoryMap["c_ALL"].inCategory = true;
+    setInCategory(kALL);
 
     // Geometric Categories
     // Barrel Barrel
     if(TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta) < 0.8 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta) < 0.8) 
-        categoryMap["c_BB"].inCategory = true;
+        setInCategory(kBB);
 
     // Overlap Overlap
     if(TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta)>=0.8 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta)<1.6 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta)>=0.8 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta)<1.6) 
-        categoryMap["c_OO"].inCategory = true;
+        setInCategory(kOO);
 
     // Endcap Endcap
     if(TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta) >= 1.6 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta) >= 1.6) 
-        categoryMap["c_EE"].inCategory = true;
+        setInCategory(kEE);
 
     // Barrel Overlap
     if(TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta) < 0.8 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta) >= 0.8 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta) < 1.6) 
-        categoryMap["c_BO"].inCategory = true;
+        setInCategory(kBO);
 
     if(TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta) < 0.8 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta) >= 0.8 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta) < 1.6) 
-        categoryMap["c_BO"].inCategory = true;
+        setInCategory(kBO);
 
     // Barrel Endcap
     if(TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta) < 0.8 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta) >= 1.6) 
-        categoryMap["c_BE"].inCategory = true;
+        setInCategory(kBE);
 
     if(TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta) < 0.8 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta) >= 1.6) 
-        categoryMap["c_BE"].inCategory = true;
+        setInCategory(kBE);
 
     // Overlap Endcap
     if(TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta) >= 0.8 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta) < 1.6 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta) >= 1.6) 
-        categoryMap["c_OE"].inCategory = true;
+        setInCategory(kOE);
 
     if(TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta) >= 0.8 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta) < 1.6 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta) >= 1.6) 
-        categoryMap["c_OE"].inCategory = true;
+        setInCategory(kOE);
 
     // jet category selection
     if(vars.validJets.size() >= 2)
@@ -516,7 +635,7 @@ void CategorySelectionRun1::evaluate(VarSet& vars)
         //if(vars.validJets[0].Pt() > cLeadPtMin && vars.validJets[1].Pt() > cSubleadPtMin) // No MET for now
         if(vars.validJets[0].Pt() > cLeadPtMin && vars.validJets[1].Pt() > cSubleadPtMin && vars.met->pt < cMETMax)
         {
-            categoryMap["c_2_Jet"].inCategory = true;
+            setInCategory(k2_Jet);
             double mjj_max = -1;
 
             for(unsigned int i=0; i<vars.validJets.size(); i++)
@@ -529,7 +648,7 @@ void CategorySelectionRun1::evaluate(VarSet& vars)
                     if(mjj > mjj_max) mjj_max = mjj;
                     if(mjj > cDijetMassMinVBFT && TMath::Abs(dEtajj) > cDijetDeltaEtaMinVBFT)
                     { 
-                        categoryMap["c_2_Jet_VBF_Tight"].inCategory = true; 
+                        setInCategory(k2_Jet_VBF_Tight); 
                         return; 
                     }
                 }
@@ -537,38 +656,38 @@ void CategorySelectionRun1::evaluate(VarSet& vars)
 
             if(mjj_max > cDijetMassMinGGFT && vars.dimuCand->pt > cDimuPtMinGGFT)
             { 
-                categoryMap["c_2_Jet_GGF_Tight"].inCategory = true; 
+                setInCategory(k2_Jet_GGF_Tight); 
                 return; 
             }
             else
             { 
-                categoryMap["c_2_Jet_VBF_Loose"].inCategory = true; 
+                setInCategory(k2_Jet_VBF_Loose); 
                 return; 
             }
         }
     }
-    if(!categoryMap["c_2_Jet"].inCategory) // fails 2jet preselection enters 01 categories
+    if(!isInCategory(k2_Jet)) // fails 2jet preselection enters 01 categories
     {
-        categoryMap["c_01_Jet"].inCategory = true;
-        if(vars.dimuCand->pt > cDimuPtMin01T){ categoryMap["c_01_Jet_Tight"].inCategory = true;}
-        else{ categoryMap["c_01_Jet_Loose"].inCategory = true; }
+        setInCategory(k01_Jet);
+        if(vars.dimuCand->pt > cDimuPtMin01T){ setInCategory(k01_Jet_Tight);}
+        else{ setInCategory(k01_Jet_Loose); }
 
         // Geometric categories for 01_Jet categories
         // tight
-        if(categoryMap["c_01_Jet_Tight"].inCategory && categoryMap["c_BB"].inCategory) categoryMap["c_01_Jet_Tight_BB"].inCategory = true;
-        if(categoryMap["c_01_Jet_Tight"].inCategory && categoryMap["c_BO"].inCategory) categoryMap["c_01_Jet_Tight_BO"].inCategory = true;
-        if(categoryMap["c_01_Jet_Tight"].inCategory && categoryMap["c_BE"].inCategory) categoryMap["c_01_Jet_Tight_BE"].inCategory = true;
-        if(categoryMap["c_01_Jet_Tight"].inCategory && categoryMap["c_OO"].inCategory) categoryMap["c_01_Jet_Tight_OO"].inCategory = true;
-        if(categoryMap["c_01_Jet_Tight"].inCategory && categoryMap["c_OE"].inCategory) categoryMap["c_01_Jet_Tight_OE"].inCategory = true;
-        if(categoryMap["c_01_Jet_Tight"].inCategory && categoryMap["c_EE"].inCategory) categoryMap["c_01_Jet_Tight_EE"].inCategory = true;
+        if(isInCategory(k01_Jet_Tight) && isInCategory(kBB)) setInCategory(k01_Jet_Tight_BB);
+        if(isInCategory(k01_Jet_Tight) && isInCategory(kBO)) setInCategory(k01_Jet_Tight_BO);
+        if(isInCategory(k01_Jet_Tight) && isInCategory(kBE)) setInCategory(k01_Jet_Tight_BE);
+        if(isInCategory(k01_Jet_Tight) && isInCategory(kOO)) setInCategory(k01_Jet_Tight_OO);
+        if(isInCategory(k01_Jet_Tight) && isInCategory(kOE)) setInCategory(k01_Jet_Tight_OE);
+        if(isInCategory(k01_Jet_Tight) && isInCategory(kEE)) setInCategory(k01_Jet_Tight_EE);
 
         // loose
-        if(categoryMap["c_01_Jet_Loose"].inCategory && categoryMap["c_BB"].inCategory) categoryMap["c_01_Jet_Loose_BB"].inCategory = true;
-        if(categoryMap["c_01_Jet_Loose"].inCategory && categoryMap["c_BO"].inCategory) categoryMap["c_01_Jet_Loose_BO"].inCategory = true;
-        if(categoryMap["c_01_Jet_Loose"].inCategory && categoryMap["c_BE"].inCategory) categoryMap["c_01_Jet_Loose_BE"].inCategory = true;
-        if(categoryMap["c_01_Jet_Loose"].inCategory && categoryMap["c_OO"].inCategory) categoryMap["c_01_Jet_Loose_OO"].inCategory = true;
-        if(categoryMap["c_01_Jet_Loose"].inCategory && categoryMap["c_OE"].inCategory) categoryMap["c_01_Jet_Loose_OE"].inCategory = true;
-        if(categoryMap["c_01_Jet_Loose"].inCategory && categoryMap["c_EE"].inCategory) categoryMap["c_01_Jet_Loose_EE"].inCategory = true;
+        if(isInCategory(k01_Jet_Loose) && isInCategory(kBB)) setInCategory(k01_Jet_Loose_BB);
+        if(isInCategory(k01_Jet_Loose) && isInCategory(kBO)) setInCategory(k01_Jet_Loose_BO);
+        if(isInCategory(k01_Jet_Loose) && isInCategory(kBE)) setInCategory(k01_Jet_Loose_BE);
+        if(isInCategory(k01_Jet_Loose) && isInCategory(kOO)) setInCategory(k01_Jet_Loose_OO);
+        if(isInCategory(k01_Jet_Loose) && isInCategory(kOE)) setInCategory(k01_Jet_Loose_OE);
+        if(isInCategory(k01_Jet_Loose) && isInCategory(kEE)) setInCategory(k01_Jet_Loose_EE);
     }
 
 }
@@ -582,17 +701,17 @@ void CategorySelectionRun1::evaluate(VarSet& vars)
 void CategorySelectionSynch::initCategoryMap()
 {
 // Initialize the categories
-    categoryMap["c_ALL"] = Category("c_ALL");
+    addCategory(kALL, Category("c_ALL"));
 
     // intermediate categories to make things easier
-    categoryMap["c_2_Jet"] = Category("c_2_Jet", true);
-    categoryMap["c_01_Jet"] = Category("c_01_Jet", true);
-
-    categoryMap["c_2_Jet_VBF_Tight"] = Category("c_2_Jet_VBF_Tight");
-    categoryMap["c_2_Jet_VBF_Loose"] = Category("c_2_Jet_VBF_Loose");
-    categoryMap["c_2_Jet_GGF_Tight"] = Category("c_2_Jet_GGF_Tight");
-    categoryMap["c_01_Jet_Tight"] = Category("c_01_Jet_Tight");
-    categoryMap["c_01_Jet_Loose"] = Category("c_01_Jet_Loose");
+    addCategory(k2_Jet, Category("c_2_Jet", true));
+    addCategory(k01_Jet, Category("c_01_Jet", true));
+
+    addCategory(k2_Jet_VBF_Tight, Category("c_2_Jet_VBF_Tight"));
+    addCategory(k2_Jet_VBF_Loose, Category("c_2_Jet_VBF_Loose"));
+    addCategory(k2_Jet_GGF_Tight, Category("c_2_Jet_GGF_Tight"));
+    addCategory(k01_Jet_Tight, Category("c_01_Jet_Tight"));
+    addCategory(k01_Jet_Loose, Category("c_01_Jet_Loose"));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -669,7 +788,7 @@ void CategorySelectionSynch::evaluate(VarSet& vars)
 // Determine which category the event belongs to
 
     // Inclusive category, all events that passed the selection cuts
-    categoryMap["c_ALL"].inCategory = true;
+    setInCategory(kALL);
 
     // jet category selection
     if(vars.validJets.size() >= 2)
@@ -677,7 +796,7 @@ void CategorySelectionSynch::evaluate(VarSet& vars)
         //if(leadJet.Pt() > cLeadPtMin && subleadJet.Pt() > cSubleadPtMin && vars.met->pt < cMETMax && vars.validBJets.size() == 0)
         if(vars.validJets[0].Pt() > cLeadPtMin && vars.validJets[1].Pt() > cSubleadPtMin && vars.validBJets.size() == 0) // No MET for now
         {
-            categoryMap["c_2_Jet"].inCategory = true;
+            setInCategory(k2_Jet);
             double mjj_max = -1;
 
             for(unsigned int i=0; i<vars.validJets.size(); i++)
@@ -690,7 +809,7 @@ void CategorySelectionSynch::evaluate(VarSet& vars)
                     if(mjj > mjj_max) mjj_max = mjj;
                     if(mjj > cDijetMassMinVBFT && TMath::Abs(dEtajj) > cDijetDeltaEtaMinVBFT)
                     { 
-                        categoryMap["c_2_Jet_VBF_Tight"].inCategory = true; 
+                        setInCategory(k2_Jet_VBF_Tight); 
                         return; 
                     }
                 }
@@ -698,21 +817,21 @@ void CategorySelectionSynch::evaluate(VarSet& vars)
 
             if(mjj_max > cDijetMassMinGGFT && vars.dimuCand->pt > cDimuPtMinGGFT)
             { 
-                categoryMap["c_2_Jet_GGF_Tight"].inCategory = true; 
+                setInCategory(k2_Jet_GGF_Tight); 
                 return; 
             }
             else
             { 
-                categoryMap["c_2_Jet_VBF_Loose"].inCategory = true; 
+                setInCategory(k2_Jet_VBF_Loose); 
                 return; 
             }
         }
     }
-    if(!categoryMap["c_2_Jet"].inCategory) // fails 2jet preselection enters 01 categories
+    if(!isInCategory(k2_Jet)) // fails 2jet preselection enters 01 categories
     {
-        categoryMap["c_01_Jet"].inCategory = true;
-        if(vars.dimuCand->pt > cDimuPtMin01T){ categoryMap["c_01_Jet_Tight"].inCategory = true;}
-        else{ categoryMap["c_01_Jet_Loose"].inCategory = true; }
+        setInCategory(k01_Jet);
+        if(vars.dimuCand->pt > cDimuPtMin01T){ setInCategory(k01_Jet_Tight);}
+        else{ setInCategory(k01_Jet_Loose); }
     }
 
 }
@@ -726,20 +845,20 @@ void CategorySelectionSynch::evaluate(VarSet& vars)
 void CategorySelectionFEWZ::initCategoryMap()
 {
 // Initialize the categories
-    categoryMap["c_Wide"] = Category("c_Wide");
-    categoryMap["c_Narrow"] = Category("c_Narrow");
+    addCategory(kWide, Category("c_Wide"));
+    addCategory(kNarrow, Category("c_Narrow"));
 
     // intermediate categories to make things easier, don't plot these, hence the true
-    categoryMap["c_Central_Central"] = Category("c_Central_Central", true);
-    categoryMap["c_Central_Not_Central"] = Category("c_Central_Not_Central", true);
-
-    categoryMap["c_1Jet"] = Category("c_1Jet");
-    categoryMap["c_Central_Central_Wide"] = Category("c_Central_Central_Wide");
-    categoryMap["c_Central_Not_Central_Wide"] = Category("c_Central_Not_Central_Wide");
-    categoryMap["c_1Jet_Wide"] = Category("c_1Jet_Wide");
-    categoryMap["c_Central_Central_Narrow"] = Category("c_Central_Central_Narrow");
-    categoryMap["c_Central_Not_Central_Narrow"] = Category("c_Central_Not_Central_Narrow");
-    categoryMap["c_1Jet_Narrow"] = Category("c_1Jet_Narrow");
+    addCategory(kCentral_Central, Category("c_Central_Central", true));
+    addCategory(kCentral_Not_Central, Category("c_Central_Not_Central", true));
+
+    addCategory(k1Jet, Category("c_1Jet"));
+    addCategory(kCentral_Central_Wide, Category("c_Central_Central_Wide"));
+    addCategory(kCentral_Not_Central_Wide, Category("c_Central_Not_Central_Wide"));
+    addCategory(k1Jet_Wide, Category("c_1Jet_Wide"));
+    addCategory(kCentral_Central_Narrow, Category("c_Central_Central_Narrow"));
+    addCategory(kCentral_Not_Central_Narrow, Category("c_Central_Not_Central_Narrow"));
+    addCategory(k1Jet_Narrow, Category("c_1Jet_Narrow"));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -815,29 +934,29 @@ void CategorySelectionFEWZ::evaluate(VarSet& vars)
 
     // Should cut out all events that don't fall into the wide mass window in earlier selection stage
     // All events that pass are in window of min to max
-    categoryMap["c_Wide"].inCategory = true;
+    setInCategory(kWide);
 
     // Narrow goes from min to cMassSplit
-    if(dimu_mass < cMassSplit) categoryMap["c_Narrow"].inCategory = true;
+    if(dimu_mass < cMassSplit) setInCategory(kNarrow);
 
     // Both central
-    if(TMath::Abs(eta0) < 0.8 && TMath::Abs(eta1) < 0.8) categoryMap["c_Central_Central"].inCategory = true;
+    if(TMath::Abs(eta0) < 0.8 && TMath::Abs(eta1) < 0.8) setInCategory(kCentral_Central);
 
     // Not both, but at least one is central
-    else if(TMath::Abs(eta0) < 0.8 || TMath::Abs(eta1) < 0.8) categoryMap["c_Central_Not_Central"].inCategory = true;
+    else if(TMath::Abs(eta0) < 0.8 || TMath::Abs(eta1) < 0.8) setInCategory(kCentral_Not_Central);
 
     // One category that passes basic selections and has exactly one jet
-    if(njets == 1) categoryMap["c_1Jet"].inCategory = true; 
+    if(njets == 1) setInCategory(k1Jet); 
 
     // Final Categories ///////////////////////////////////////////////////////
-    if(categoryMap["c_Wide"].inCategory && categoryMap["c_Central_Central"].inCategory) categoryMap["c_Central_Central_Wide"].inCategory = true;
-    if(categoryMap["c_Narrow"].inCategory && categoryMap["c_Central_Central"].inCategory) categoryMap["c_Central_Central_Narrow"].inCategory = true;
+    if(isInCategory(kWide) && isInCategory(kCentral_Central)) setInCategory(kCentral_Central_Wide);
+    if(isInCategory(kNarrow) && isInCategory(kCentral_Central)) setInCategory(kCentral_Central_Narrow);
 
-    if(categoryMap["c_Wide"].inCategory && categoryMap["c_Central_Not_Central"].inCategory) categoryMap["c_Central_Not_Central_Wide"].inCategory = true;
-    if(categoryMap["c_Narrow"].inCategory && categoryMap["c_Central_Not_Central"].inCategory) categoryMap["c_Central_Not_Central_Narrow"].inCategory = true;
+    if(isInCategory(kWide) && isInCategory(kCentral_Not_Central)) setInCategory(kCentral_Not_Central_Wide);
+    if(isInCategory(kNarrow) && isInCategory(kCentral_Not_Central)) setInCategory(kCentral_Not_Central_Narrow);
 
-    if(categoryMap["c_Wide"].inCategory && categoryMap["c_1Jet"].inCategory) categoryMap["c_1Jet_Wide"].inCategory = true;
-    if(categoryMap["c_Narrow"].inCategory && categoryMap["c_1Jet"].inCategory) categoryMap["c_1Jet_Narrow"].inCategory = true;
+    if(isInCategory(kWide) && isInCategory(k1Jet)) setInCategory(k1Jet_Wide);
+    if(isInCategory(kNarrow) && isInCategory(k1Jet)) setInCategory(k1Jet_Narrow);
 
     return;
 }
@@ -852,93 +971,94 @@ void LotsOfCategoriesRun2::initCategoryMap()
 {
 // Initialize the categories
 
-    geometricNames = {TString("BB"), TString("OO"), TString("EE"), TString("BO"), TString("BE"), TString("OE")};
+    // same order as kBB ... kEE and the geometrized gF ids
+    geometricNames = {TString("BB"), TString("BO"), TString("BE"), TString("OO"), TString("OE"), TString("EE")};
 
     ///////////////// INCLUSIVE //////////////////////////////
-    categoryMap["c_ALL"] = Category("c_ALL");
+    addCategory(kALL, Category("c_ALL"));
 
     ///////////////// GEOMETRY //////////////////////////////
-    categoryMap["c_BB"] = Category("c_BB", true);
-    categoryMap["c_BO"] = Category("c_BO", true);
-    categoryMap["c_BE"] = Category("c_BE", true);
-    categoryMap["c_OO"] = Category("c_OO", true);
-    categoryMap["c_OE"] = Category("c_OE", true);
-    categoryMap["c_EE"] = Category("c_EE", true);
+    addCategory(kBB, Category("c_BB", true));
+    addCategory(kBO, Category("c_BO", true));
+    addCategory(kBE, Category("c_BE", true));
+    addCategory(kOO, Category("c_OO", true));
+    addCategory(kOE, Category("c_OE", true));
+    addCategory(kEE, Category("c_EE", true));
 
     ///////////////// PRESELECTION //////////////////////////////
-    categoryMap["c_Preselection_Pass"] = Category("c_Preselection_Pass");
+    addCategory(kPreselection_Pass, Category("c_Preselection_Pass"));
 
       ///////////////// AT LEAST ONE B-JET //////////////////////////////
-      categoryMap["c_1b"] = Category("c_1b");
+      addCategory(k1b, Category("c_1b"));
 
         ///////////////// TTH 2 EXTRA LEPTONS //////////////////////////////
-        categoryMap["c_1b_TTH"]        = Category("c_1b_TTH");
-        categoryMap["c_1b_TTH_2e"]     = Category("c_1b_TTH_2e",     true);
-        categoryMap["c_1b_TTH_1e_1mu"] = Category("c_1b_TTH_1e_1mu", true);
-        categoryMap["c_1b_TTH_2mu"]    = Category("c_1b_TTH_2mu",    true);
+        addCategory(k1b_TTH, Category("c_1b_TTH"));
+        addCategory(k1b_TTH_2e, Category("c_1b_TTH_2e",     true));
+        addCategory(k1b_TTH_1e_1mu, Category("c_1b_TTH_1e_1mu", true));
+        addCategory(k1b_TTH_2mu, Category("c_1b_TTH_2mu",    true));
   
         ///////////////// TTH/BBH 0 EXTRA LEPTONS (HADRONS)///////////////////
-        categoryMap["c_1b_TTH_BBH"]              = Category("c_1b_TTH_BBH");
-        categoryMap["c_1b_TTH_BBH_Tight"]        = Category("c_1b_TTH_BBH_Tight",        true);
-        categoryMap["c_1b_TTH_BBH_V_Hadronic_H"] = Category("c_1b_TTH_BBH_V_Hadronic_H", true);
+        addCategory(k1b_TTH_BBH, Category("c_1b_TTH_BBH"));
+        addCategory(k1b_TTH_BBH_Tight, Category("c_1b_TTH_BBH_Tight",        true));
+        addCategory(k1b_TTH_BBH_V_Hadronic_H, Category("c_1b_TTH_BBH_V_Hadronic_H", true));
   
         ///////////////// 1 B-JET EVENTS THAT DONT FIT ELSEWHERE////////////////
-        categoryMap["c_1b_Leftovers"] = Category("c_1b_Leftovers");
+        addCategory(k1b_Leftovers, Category("c_1b_Leftovers"));
   
       ///////////////// NO B-JETS //////////////////////////////
-      categoryMap["c_0b"] = Category("c_0b");
+      addCategory(k0b, Category("c_0b"));
   
         ///////////////// NOT V(lept)H (VBF, gF, V(had)H, ZvvH) /////////////////////
-        categoryMap["c_0b_nonVlH"] = Category("c_0b_nonVlH");
+        addCategory(k0b_nonVlH, Category("c_0b_nonVlH"));
 
         ///////////////// 2-jet (VBF, V(had)H, gF) //////////////////////////////
-        categoryMap["c_0b_nonVlH_2j"]              = Category("c_0b_nonVlH_2j");
-        categoryMap["c_0b_nonVlH_2j_VBF_Tight"]    = Category("c_0b_nonVlH_2j_VBF_Tight");
-        categoryMap["c_0b_nonVlH_2j_VBF_Loose"]    = Category("c_0b_nonVlH_2j_VBF_Loose");
-        categoryMap["c_0b_nonVlH_2j_V_Hadronic_H"] = Category("c_0b_nonVlH_2j_V_Hadronic_H");
-        categoryMap["c_0b_nonVlH_2j_gF"]           = Category("c_0b_nonVlH_2j_gF");
+        addCategory(k0b_nonVlH_2j, Category("c_0b_nonVlH_2j"));
+        addCategory(k0b_nonVlH_2j_VBF_Tight, Category("c_0b_nonVlH_2j_VBF_Tight"));
+        addCategory(k0b_nonVlH_2j_VBF_Loose, Category("c_0b_nonVlH_2j_VBF_Loose"));
+        addCategory(k0b_nonVlH_2j_V_Hadronic_H, Category("c_0b_nonVlH_2j_V_Hadronic_H"));
+        addCategory(k0b_nonVlH_2j_gF, Category("c_0b_nonVlH_2j_gF"));
 
         ///////////////// 01-jet (gF Tight, gF Loose, ZvvH) //////////////////////////////
-        categoryMap["c_0b_nonVlH_01j"]          = Category("c_0b_nonVlH_01j");
+        addCategory(k0b_nonVlH_01j, Category("c_0b_nonVlH_01j"));
 
           // ZvvH
-          categoryMap["c_0b_nonVlH_01j_ZvvH"]     = Category("c_0b_nonVlH_01j_ZvvH");
+          addCategory(k0b_nonVlH_01j_ZvvH, Category("c_0b_nonVlH_01j_ZvvH"));
 
           // gF Tight
-          categoryMap["c_0b_nonVlH_01j_gF_Tight"] = Category("c_0b_nonVlH_01j_gF_Tight");
+          addCategory(k0b_nonVlH_01j_gF_Tight, Category("c_0b_nonVlH_01j_gF_Tight"));
 
             // gF Tight Geometrized
-            categoryMap["c_0b_nonVlH_01j_gF_Tight_BB"] = Category("c_0b_nonVlH_01j_gF_Tight_BB");
-            categoryMap["c_0b_nonVlH_01j_gF_Tight_BO"] = Category("c_0b_nonVlH_01j_gF_Tight_BO");
-            categoryMap["c_0b_nonVlH_01j_gF_Tight_BE"] = Category("c_0b_nonVlH_01j_gF_Tight_BE");
-            categoryMap["c_0b_nonVlH_01j_gF_Tight_OO"] = Category("c_0b_nonVlH_01j_gF_Tight_OO");
-            categoryMap["c_0b_nonVlH_01j_gF_Tight_OE"] = Category("c_0b_nonVlH_01j_gF_Tight_OE");
-            categoryMap["c_0b_nonVlH_01j_gF_Tight_EE"] = Category("c_0b_nonVlH_01j_gF_Tight_EE");
+            addCategory(k0b_nonVlH_01j_gF_Tight_BB, Category("c_0b_nonVlH_01j_gF_Tight_BB"));
+            addCategory(k0b_nonVlH_01j_gF_Tight_BO, Category("c_0b_nonVlH_01j_gF_Tight_BO"));
+            addCategory(k0b_nonVlH_01j_gF_Tight_BE, Category("c_0b_nonVlH_01j_gF_Tight_BE"));
+            addCategory(k0b_nonVlH_01j_gF_Tight_OO, Category("c_0b_nonVlH_01j_gF_Tight_OO"));
+            addCategory(k0b_nonVlH_01j_gF_Tight_OE, Category("c_0b_nonVlH_01j_gF_Tight_OE"));
+            addCategory(k0b_nonVlH_01j_gF_Tight_EE, Category("c_0b_nonVlH_01j_gF_Tight_EE"));
 
           // gF Loose
-          categoryMap["c_0b_nonVlH_01j_gF_Loose"] = Category("c_0b_nonVlH_01j_gF_Loose");
+          addCategory(k0b_nonVlH_01j_gF_Loose, Category("c_0b_nonVlH_01j_gF_Loose"));
 
             // gF Loose Geometrized
-            categoryMap["c_0b_nonVlH_01j_gF_Loose_BB"] = Category("c_0b_nonVlH_01j_gF_Loose_BB");
-            categoryMap["c_0b_nonVlH_01j_gF_Loose_BO"] = Category("c_0b_nonVlH_01j_gF_Loose_BO");
-            categoryMap["c_0b_nonVlH_01j_gF_Loose_BE"] = Category("c_0b_nonVlH_01j_gF_Loose_BE");
-            categoryMap["c_0b_nonVlH_01j_gF_Loose_OO"] = Category("c_0b_nonVlH_01j_gF_Loose_OO");
-            categoryMap["c_0b_nonVlH_01j_gF_Loose_OE"] = Category("c_0b_nonVlH_01j_gF_Loose_OE");
-            categoryMap["c_0b_nonVlH_01j_gF_Loose_EE"] = Category("c_0b_nonVlH_01j_gF_Loose_EE");
+            addCategory(k0b_nonVlH_01j_gF_Loose_BB, Category("c_0b_nonVlH_01j_gF_Loose_BB"));
+            addCategory(k0b_nonVlH_01j_gF_Loose_BO, Category("c_0b_nonVlH_01j_gF_Loose_BO"));
+            addCategory(k0b_nonVlH_01j_gF_Loose_BE, Category("c_0b_nonVlH_01j_gF_Loose_BE"));
+            addCategory(k0b_nonVlH_01j_gF_Loose_OO, Category("c_0b_nonVlH_01j_gF_Loose_OO"));
+            addCategory(k0b_nonVlH_01j_gF_Loose_OE, Category("c_0b_nonVlH_01j_gF_Loose_OE"));
+            addCategory(k0b_nonVlH_01j_gF_Loose_EE, Category("c_0b_nonVlH_01j_gF_Loose_EE"));
 
         ///////////////// V(lept)H (...) /////////////////////
-        categoryMap["c_0b_VlH"]    = Category("c_0b_VlH");
+        addCategory(k0b_VlH, Category("c_0b_VlH"));
 
             // VlH according to the V decays
-            categoryMap["c_0b_VlH_We"]         = Category("c_0b_VlH_We");
-            categoryMap["c_0b_VlH_Wmu"]        = Category("c_0b_VlH_Wmu");
-            categoryMap["c_0b_VlH_Ztautau"]        = Category("c_0b_VlH_Ztautau");
-            categoryMap["c_0b_VlH_Zmumu"]      = Category("c_0b_VlH_Zmumu");
-            categoryMap["c_0b_VlH_Zee"]        = Category("c_0b_VlH_Zee");
-            categoryMap["c_0b_VlH_Leftovers"]  = Category("c_0b_VlH_Leftovers");
+            addCategory(k0b_VlH_We, Category("c_0b_VlH_We"));
+            addCategory(k0b_VlH_Wmu, Category("c_0b_VlH_Wmu"));
+            addCategory(k0b_VlH_Ztautau, Category("c_0b_VlH_Ztautau"));
+            addCategory(k0b_VlH_Zmumu, Category("c_0b_VlH_Zmumu"));
+            addCategory(k0b_VlH_Zee, Category("c_0b_VlH_Zee"));
+            addCategory(k0b_VlH_Leftovers, Category("c_0b_VlH_Leftovers"));
 
     ///////////////// FAIL PRESELECTION //////////////////////////////
-    categoryMap["c_Preselection_Fail"] = Category("c_Preselection_Fail");
+    addCategory(kPreselection_Fail, Category("c_Preselection_Fail"));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1027,49 +1147,49 @@ void LotsOfCategoriesRun2::evaluateMuonGeometry(VarSet& vars)
     // Geometric Categories
     // Barrel Barrel
     if(TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta) < c_geo_bmax && TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta) < c_geo_bmax) 
-        categoryMap["c_BB"].inCategory = true;
+        setInCategory(kBB);
 
     // Overlap Overlap
     if(TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta)>=c_geo_bmax 
       && TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta)<c_geo_omax 
       && TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta)>=c_geo_bmax 
       && TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta)<c_geo_omax) 
-        categoryMap["c_OO"].inCategory = true;
+        setInCategory(kOO);
 
     // Endcap Endcap
     if(TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta) >= c_geo_omax 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta) >= c_geo_omax) 
-        categoryMap["c_EE"].inCategory = true;
+        setInCategory(kEE);
 
     // Barrel Overlap
     if(TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta) < c_geo_bmax 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta) >= c_geo_bmax 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta) < c_geo_omax) 
-        categoryMap["c_BO"].inCategory = true;
+        setInCategory(kBO);
 
     if(TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta) < c_geo_bmax 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta) >= c_geo_bmax 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta) < c_geo_omax) 
-        categoryMap["c_BO"].inCategory = true;
+        setInCategory(kBO);
 
     // Barrel Endcap
     if(TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta) < c_geo_bmax 
       && TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta) >= c_geo_omax) 
-        categoryMap["c_BE"].inCategory = true;
+        setInCategory(kBE);
 
     if(TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta) < c_geo_bmax && TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta) >= c_geo_omax) 
-        categoryMap["c_BE"].inCategory = true;
+        setInCategory(kBE);
 
     // Overlap Endcap
     if(TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta) >= c_geo_bmax 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta) < c_geo_omax 
       && TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta) >= c_geo_omax) 
-        categoryMap["c_OE"].inCategory = true;
+        setInCategory(kOE);
 
     if(TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta) >= c_geo_bmax 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu2).eta) < c_geo_omax 
        && TMath::Abs(vars.muons->at(vars.dimuCand->iMu1).eta) >= c_geo_omax) 
-        categoryMap["c_OE"].inCategory = true;
+        setInCategory(kOE);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1079,7 +1199,7 @@ void LotsOfCategoriesRun2::evaluateMuonGeometry(VarSet& vars)
 void LotsOfCategoriesRun2::evaluate(VarSet& vars)
 {
     ///////////////// INCLUSIVE //////////////////////////////
-    categoryMap["c_ALL"].inCategory = true;
+    setInCategory(kALL);
 
     // figure out bb,oo,ee,bo,be,oe
     ///////////////// MUON GEOMETRY //////////////////////////////
@@ -1087,94 +1207,94 @@ void LotsOfCategoriesRun2::evaluate(VarSet& vars)
 
     ///////////////// PRESELECTION //////////////////////////////
     if(vars.validExtraMuons.size() + vars.validElectrons.size() <= c_pre_numExtraLeptonsMax) 
-        categoryMap["c_Preselection_Pass"].inCategory = true;
+        setInCategory(kPreselection_Pass);
     else
-        categoryMap["c_Preselection_Fail"].inCategory = true;
+        setInCategory(kPreselection_Fail);
 
    // Determine whether we are in the at least 1b-jet categories or 0b-jet categories
-   if(categoryMap["c_Preselection_Pass"].inCategory)
+   if(isInCategory(kPreselection_Pass))
    {
        //std::cout << "    pass preselection..." << std::endl;
        if(vars.validBJets.size() >= c_pre_numBJetsMin) 
-           categoryMap["c_1b"].inCategory = true;
+           setInCategory(k1b);
        else
-           categoryMap["c_0b"].inCategory = true;
+           setInCategory(k0b);
    }
 
        ///////////////// 1b CATEGORIES //////////////////////////////
-       if(categoryMap["c_1b"].inCategory)
+       if(isInCategory(k1b))
        {
            //std::cout << "    pass 1b..." << std::endl;
            if(vars.validExtraMuons.size() + vars.validElectrons.size() == c_1b_numExtraLeptons_tth)
-               categoryMap["c_1b_TTH"].inCategory = true;
+               setInCategory(k1b_TTH);
            else if(vars.validExtraMuons.size() + vars.validElectrons.size() == c_1b_numExtraLeptons_tth_bbh)
-               categoryMap["c_1b_TTH_BBH"].inCategory = true;
+               setInCategory(k1b_TTH_BBH);
            else 
-               categoryMap["c_1b_Leftovers"].inCategory = true;
+               setInCategory(k1b_Leftovers);
        }
            ///////////////// 1b-TTH (2 extra lept) CATEGORIES //////////////////////////////
-           if(categoryMap["c_1b_TTH"].inCategory)
+           if(isInCategory(k1b_TTH))
            {
                //std::cout << "    pass 1b TTH..." << std::endl;
            }
            ///////////////// 1b_TTH_BBH (0 extra lept) CATEGORIES //////////////////////////////
-           if(categoryMap["c_1b_TTH_BBH"].inCategory)
+           if(isInCategory(k1b_TTH_BBH))
            {
                //std::cout << "    pass 1b TTH_BBH..." << std::endl;
            }
 
        ///////////////// 0b CATEGORIES //////////////////////////////
-       if(categoryMap["c_0b"].inCategory)
+       if(isInCategory(k0b))
        {
            //std::cout << "    pass 0b..." << std::endl;
            // output event information  here to debug... we have 70% in this category for N_valid_whatevers in data
            if(vars.validExtraMuons.size() + vars.validElectrons.size() >= c_0b_numExtraLeptonsMin)
-               categoryMap["c_0b_VlH"].inCategory = true;
+               setInCategory(k0b_VlH);
            else
-               categoryMap["c_0b_nonVlH"].inCategory = true;
+               setInCategory(k0b_nonVlH);
        }
            ///////////////// 0b-VlH    (1,2 extra lept) CATEGORIES //////////////////////////////
-           if(categoryMap["c_0b_VlH"].inCategory)
+           if(isInCategory(k0b_VlH))
            {
                //std::cout << "    pass 0b_VlH..." << std::endl;
                if(vars.met->pt >= c_0b_VlH_MET_min)
                {
                     if(vars.validElectrons.size() == c_0b_VlH_We_num_e && vars.validExtraMuons.size() == c_0b_VlH_We_num_mu)    
-                        categoryMap["c_0b_VlH_We"].inCategory = true;
+                        setInCategory(k0b_VlH_We);
 
                     else if(vars.validElectrons.size() == c_0b_VlH_Wmu_num_e && vars.validExtraMuons.size() == c_0b_VlH_Wmu_num_mu)    
-                        categoryMap["c_0b_VlH_Wmu"].inCategory = true;
+                        setInCategory(k0b_VlH_Wmu);
 
                     else if(vars.validElectrons.size() == c_0b_VlH_Ztautau_num_e && vars.validExtraMuons.size() == c_0b_VlH_Ztautau_num_mu)    
-                        categoryMap["c_0b_VlH_Ztautau"].inCategory = true;
+                        setInCategory(k0b_VlH_Ztautau);
 
                     else    
-                        categoryMap["c_0b_VlH_Leftovers"].inCategory = true;
+                        setInCategory(k0b_VlH_Leftovers);
                }
                else
                {
                     if(vars.validElectrons.size() == c_0b_VlH_Zmumu_num_e && vars.validExtraMuons.size() == c_0b_VlH_Zmumu_num_mu)    
-                        categoryMap["c_0b_VlH_Zmumu"].inCategory = true;
+                        setInCategory(k0b_VlH_Zmumu);
 
                     else if(vars.validElectrons.size() == c_0b_VlH_Zee_num_e && vars.validExtraMuons.size() == c_0b_VlH_Zee_num_mu)    
-                        categoryMap["c_0b_VlH_Zee"].inCategory = true;
+                        setInCategory(k0b_VlH_Zee);
 
                     else    
-                        categoryMap["c_0b_VlH_Leftovers"].inCategory = true;
+                        setInCategory(k0b_VlH_Leftovers);
                }
            }
 
            ///////////////// 0b-nonVlH (0 extra lept) CATEGORIES //////////////////////////////
-           if(categoryMap["c_0b_nonVlH"].inCategory)
+           if(isInCategory(k0b_nonVlH))
            {
                //std::cout << "    pass 0b_non_VlH..." << std::endl;
                if(vars.validJets.size() >= c_0b_nonVlH_njetsMin)
-                   categoryMap["c_0b_nonVlH_2j"].inCategory = true;
+                   setInCategory(k0b_nonVlH_2j);
                else
-                   categoryMap["c_0b_nonVlH_01j"].inCategory = true;
+                   setInCategory(k0b_nonVlH_01j);
            }
                ///////////////// 0b-nonVlH_2j (0 extra lept) CATEGORIES //////////////////////////////
-               if(categoryMap["c_0b_nonVlH_2j"].inCategory)
+               if(isInCategory(k0b_nonVlH_2j))
                {
                    //std::cout << "    pass 0b_non_VlHi_2j..." << std::endl;
                    TLorentzVector leadJet    = vars.validJets[0];
@@ -1186,40 +1306,41 @@ void LotsOfCategoriesRun2::evaluate(VarSet& vars)
                    float dEtajjMuMu = TMath::Abs(dijet.Eta() - vars.dimuCand->eta); 
 
                    if(dijetMass > c_0b_nonVlH_2j_mjj_min_vbfTight && dEta > c_0b_nonVlH_2j_dEtajj_min_vbfTight)
-                       categoryMap["c_0b_nonVlH_2j_VBF_Tight"].inCategory = true; 
+                       setInCategory(k0b_nonVlH_2j_VBF_Tight); 
 
                    else if(dijetMass > c_0b_nonVlH_2j_mjj_min_vbfLoose && dEta > c_0b_nonVlH_2j_dEtajj_min_vbfLoose)
-                       categoryMap["c_0b_nonVlH_2j_VBF_Loose"].inCategory = true; 
+                       setInCategory(k0b_nonVlH_2j_VBF_Loose); 
 
                    else if(dijetMass > c_0b_nonVlH_2j_mjj_min_VhH && dijetMass < c_0b_nonVlH_2j_mjj_max_VhH && dEtajjMuMu < c_0b_nonVlH_2j_dEtajjMuMu_max_VhH)
-                       categoryMap["c_0b_nonVlH_2j_V_Hadronic_H"].inCategory = true; 
+                       setInCategory(k0b_nonVlH_2j_V_Hadronic_H); 
 
                    else
-                       categoryMap["c_0b_nonVlH_2j_gF"].inCategory = true; 
+                       setInCategory(k0b_nonVlH_2j_gF); 
                }
 
                ///////////////// 0b-nonVlH_01j (0 extra lept) CATEGORIES //////////////////////////////
-               if(categoryMap["c_0b_nonVlH_01j"].inCategory)
+               if(isInCategory(k0b_nonVlH_01j))
                {
                    //std::cout << "    pass 0b_nonVlH_01j..." << std::endl;
                    if(vars.met->pt > c_0b_nonVlH_01j_MET_min_ZvvH)
-                       categoryMap["c_0b_nonVlH_01j_ZvvH"].inCategory = true; 
+                       setInCategory(k0b_nonVlH_01j_ZvvH); 
 
                    else if(vars.dimuCand->pt >= c_0b_nonVlH_01j_dimuPt_min_gfTight)
-                       categoryMap["c_0b_nonVlH_01j_gF_Tight"].inCategory = true; 
+                       setInCategory(k0b_nonVlH_01j_gF_Tight); 
 
                    else
-                       categoryMap["c_0b_nonVlH_01j_gF_Loose"].inCategory = true; 
+                       setInCategory(k0b_nonVlH_01j_gF_Loose); 
                }
                    ///////////////// Geometrized 0b-nonVlH_01j_gF CATEGORIES //////////////////////////////
-                   if(categoryMap["c_0b_nonVlH_01j_gF_Tight"].inCategory)
+                   // the geometrized ids are in the same order as kBB ... kEE
+                   if(isInCategory(k0b_nonVlH_01j_gF_Tight))
                    {
-                       for(auto& geoName: geometricNames)
-                           if(categoryMap["c_"+geoName].inCategory) categoryMap["c_0b_nonVlH_01j_gF_Tight_"+geoName].inCategory = true;
+                       for(int g=0; g<geometricNames.size(); g++)
+                           if(isInCategory(kBB+g)) setInCategory(k0b_nonVlH_01j_gF_Tight_BB+g);
                    }
-                   if(categoryMap["c_0b_nonVlH_01j_gF_Loose"].inCategory)
+                   if(isInCategory(k0b_nonVlH_01j_gF_Loose))
                    {
-                       for(auto& geoName: geometricNames)
-                           if(categoryMap["c_"+geoName].inCategory) categoryMap["c_0b_nonVlH_01j_gF_Loose_"+geoName].inCategory = true;
+                       for(int g=0; g<geometricNames.size(); g++)
+                           if(isInCategory(kBB+g)) setInCategory(k0b_nonVlH_01j_gF_Loose_BB+g);
                    }
 }
@@ -14,10 +14,12 @@
 #define ADD_CATEGORYSELECTION
 
 #include "VarSet.h"
+#include "EventSet.h"
 #include "TH1D.h"
 #include "TList.h"
 #include "TXMLEngine.h"
 #include <map>
+#include <vector>
 #include <utility>
 #include <iostream>
 
@@ -53,8 +55,8 @@ class Category
            this->isTerminal = isTerminal;
        }
     
-       // map sample name to vector of events in the category
-       std::map<TString, std::vector< std::pair<int, long long int> > > eventsMap;
+       // map sample name to the events in the category
+       std::map<TString, EventSet> eventsMap;
 
        // Categorizer.evaluate will determine whether an event falls into this category
        // if an event falls into this category the boolean value will be set to true
@@ -76,6 +78,7 @@ class Category
        // Book-keeping
        TString key;
        TString name = "";
+       int id = -1;   // index into Categorizer::categories, set when the category is added
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -87,20 +90,76 @@ class Categorizer
 // This class evaluates the event and determines which category or categories it belongs to
 
     public:
+        virtual ~Categorizer(){};
+
         // the categories the event may fall into
         std::map<TString, Category> categoryMap;
 
+        // the same categories by integer id, evaluate uses these instead of the names.
+        // categories[id] points into the categoryMap and the bits say which categories
+        // the current event is in, so reset only has to touch the ones that were set.
+        // Don't copy a categorizer, the pointers would still point into the old map.
+        std::vector<Category*> categories;
+        std::vector<unsigned long long> inCategoryBits;
+
         // set up the categories and map them to a tstring
         virtual void initCategoryMap() = 0;
 
         // Determine which category the event belongs to
         virtual void evaluate(VarSet& vars) = 0;
 
+        // the branches evaluate looks at, all of them unless the categorizer says otherwise
+        virtual BranchSet::Mask getBranchMask(VarSet& vars) { return BranchSet::kAllBranches; };
+
+        // put the category in the categoryMap under its key and give it the id,
+        // initCategoryMap uses this with the ids from the categorizer's enum
+        Category& addCategory(int id, const Category& category)
+        {
+            Category& c = categoryMap[category.key];
+            c = category;
+            c.id = id;
+            if((int)categories.size() <= id) categories.resize(id+1, 0);
+            categories[id] = &c;
+            inCategoryBits.resize((categories.size()+63)/64, 0);
+            return c;
+        };
+
+        // give the category with this key the next free id if it doesn't have one yet
+        int registerCategory(TString key)
+        {
+            Category& c = categoryMap[key];
+            if(c.id >= 0) return c.id;
+            if(c.key == "") c.key = key;
+            c.id = categories.size();
+            categories.push_back(&c);
+            inCategoryBits.resize((categories.size()+63)/64, 0);
+            return c.id;
+        };
+
+        void setInCategory(int id)
+        {
+            inCategoryBits[id >> 6] |= 1ULL << (id & 63);
+            categories[id]->inCategory = true;
+        };
+
+        bool isInCategory(int id) const
+        {
+            return (inCategoryBits[id >> 6] >> (id & 63)) & 1ULL;
+        };
+
         // reset the boolean values for the categories
         void reset()
         {
-            for(auto &entry : categoryMap)
-                entry.second.inCategory = false;
+            for(unsigned int w=0; w<inCategoryBits.size(); w++)
+            {
+                unsigned long long bits = inCategoryBits[w];
+                while(bits != 0)
+                {
+                    categories[64*w + __builtin_ctzll(bits)]->inCategory = false;
+                    bits &= bits - 1;
+                }
+                inCategoryBits[w] = 0;
+            }
         };
 
         // output the category selection results
@@ -158,10 +217,23 @@ class CategoryNode
         TString name;
         int splitVar;
         TString splitVarName;
+        FeatureHandle splitFeature;   // resolved from splitVarName when the xml is loaded
         double splitVal;
         double significanceSquared;
 };
 
+// A CategoryNode compiled into the flat node array of the XMLCategorizer.
+// The daughters and mother are indices into the array, -1 if there are none.
+struct FlatCategoryNode
+{
+    FeatureHandle feature;
+    double splitVal;
+    int left;
+    int right;
+    int mother;
+    int category;   // id of the category in the categorizer
+};
+
 // XMLCategorizer reads in an XML Decision Tree as the categorization.
 class XMLCategorizer : public Categorizer
 {
@@ -175,10 +247,32 @@ class XMLCategorizer : public Categorizer
         void initCategoryMap();
         void evaluate(VarSet& vars);
         void evaluateRecursive(VarSet& vars, CategoryNode* cnode);
+
+        // loadFromXML compiles the tree into one array, nodes[0] is the root and
+        // the daughters come after their mother, so evaluating an event is a loop over
+        // the array with the features resolved ahead of time and no map lookups
+        std::vector<FlatCategoryNode> nodes;
+        void compile();
+        int compileRecursive(CategoryNode* cnode, int mother);
+
+        // the index of the terminal node the event ends up in
+        int filterToLeaf(VarSet& vars);
+
+        // set inCategory for the terminal node and all of the nodes above it
+        void setInCategoryFromLeaf(int leaf);
+
+        // walk several events through the tree together, one level at a time.
+        // leaves[i] is set to the terminal node for events[i], use setInCategoryFromLeaf(leaves[i])
+        // to fill the categoryMap for that event
+        void evaluate(VarSet** events, int nevents, int* leaves);
         void loadFromXML(TString filename);
         void loadFromXMLRecursive(TXMLEngine* xml, XMLNodePointer_t xnode, CategoryNode* cnode);
         CategoryNode* filterEvent(VarSet& vars);
         CategoryNode* filterEventRecursive(VarSet& vars);
+
+        // the branches needed for the split variables of the tree
+        BranchSet::Mask getBranchMask(VarSet& vars);
+        void getSplitVarNamesRecursive(CategoryNode* cnode, std::vector<TString>& names);
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -194,7 +288,7 @@ class CategorySelectionHybrid : public XMLCategorizer
         CategorySelectionHybrid(TString xmlfile){ initCategoryMap(); loadFromXML(xmlfile); }; 
 
         // Determine which category the event belongs to
-        void evaluate(VarSet& vars){ evaluateRecursive(vars, rootNode); };
+        void evaluate(VarSet& vars){ XMLCategorizer::evaluate(vars); };
         void initCategoryMap(){};
 };
 
@@ -205,11 +299,16 @@ class CategorySelectionHybrid : public XMLCategorizer
 class CategorySelectionBDT : public Categorizer
 {
     public:
+        // category ids, in the order initCategoryMap adds them
+        enum CategoryId { kAll, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9, k10, k11, k12, k13, k14,
+                          kNCategories };
+
         CategorySelectionBDT(); 
 
         // Determine which category the event belongs to
         void evaluate(VarSet& vars);
         void initCategoryMap();
+        BranchSet::Mask getBranchMask(VarSet& vars) { return vars.getBranchMask(std::vector<TString>{"bdt_score", "dimu_max_abs_eta"}); };
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -220,6 +319,13 @@ class CategorySelectionRun1 : public Categorizer
 {
 // The run1 H->MuMu category selection
     public:
+        // category ids, in the order initCategoryMap adds them
+        enum CategoryId { kALL, k2_Jet, k01_Jet, k2_Jet_VBF_Tight, k2_Jet_VBF_Loose, k2_Jet_GGF_Tight,
+                          k01_Jet_Tight, k01_Jet_Loose, kBB, kBO, kBE, kOO, kOE, kEE, k01_Jet_Tight_BB,
+                          k01_Jet_Tight_BO, k01_Jet_Tight_BE, k01_Jet_Tight_OO, k01_Jet_Tight_OE,
+                          k01_Jet_Tight_EE, k01_Jet_Loose_BB, k01_Jet_Loose_BO, k01_Jet_Loose_BE,
+                          k01_Jet_Loose_OO, k01_Jet_Loose_OE, k01_Jet_Loose_EE, kNCategories };
+
         CategorySelectionRun1(); 
         CategorySelectionRun1(float cLeadPtMin, float cSubleadPtMin, float cMETMax, float cDijetMassMinVBFT, 
                               float cDijetDeltaEtaMinVBFT, float cDijetMassMinGGFT,
@@ -245,6 +351,9 @@ class CategorySelectionRun1 : public Categorizer
         // result stored in isVBFTight, isGGFTight, etc 
         void evaluate(VarSet& vars);
         void initCategoryMap();
+
+        // muons, the cleaned jets, and the MET
+        BranchSet::Mask getBranchMask(VarSet& vars) { return BranchSet::kCleaningBranches | BranchSet::bit(BranchSet::kMet); };
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -255,6 +364,10 @@ class CategorySelectionSynch : public Categorizer
 {
 // Category selection for synchronization purposes
     public:
+        // category ids, in the order initCategoryMap adds them
+        enum CategoryId { kALL, k2_Jet, k01_Jet, k2_Jet_VBF_Tight, k2_Jet_VBF_Loose, k2_Jet_GGF_Tight,
+                          k01_Jet_Tight, k01_Jet_Loose, kNCategories };
+
         CategorySelectionSynch(); 
         CategorySelectionSynch(float cLeadPtMin, float cSubleadPtMin, float cMETMax, float cDijetMassMinVBFT, 
                               float cDijetDeltaEtaMinVBFT, float cDijetMassMinGGFT,
@@ -291,6 +404,19 @@ class LotsOfCategoriesRun2 : public Categorizer
 // Adrian's new categories for Run2, oh boy
 
     public:
+        // category ids, in the order initCategoryMap adds them
+        enum CategoryId { kALL, kBB, kBO, kBE, kOO, kOE, kEE, kPreselection_Pass, k1b, k1b_TTH, k1b_TTH_2e,
+                          k1b_TTH_1e_1mu, k1b_TTH_2mu, k1b_TTH_BBH, k1b_TTH_BBH_Tight,
+                          k1b_TTH_BBH_V_Hadronic_H, k1b_Leftovers, k0b, k0b_nonVlH, k0b_nonVlH_2j,
+                          k0b_nonVlH_2j_VBF_Tight, k0b_nonVlH_2j_VBF_Loose, k0b_nonVlH_2j_V_Hadronic_H,
+                          k0b_nonVlH_2j_gF, k0b_nonVlH_01j, k0b_nonVlH_01j_ZvvH, k0b_nonVlH_01j_gF_Tight,
+                          k0b_nonVlH_01j_gF_Tight_BB, k0b_nonVlH_01j_gF_Tight_BO, k0b_nonVlH_01j_gF_Tight_BE,
+                          k0b_nonVlH_01j_gF_Tight_OO, k0b_nonVlH_01j_gF_Tight_OE, k0b_nonVlH_01j_gF_Tight_EE,
+                          k0b_nonVlH_01j_gF_Loose, k0b_nonVlH_01j_gF_Loose_BB, k0b_nonVlH_01j_gF_Loose_BO,
+                          k0b_nonVlH_01j_gF_Loose_BE, k0b_nonVlH_01j_gF_Loose_OO, k0b_nonVlH_01j_gF_Loose_OE,
+                          k0b_nonVlH_01j_gF_Loose_EE, k0b_VlH, k0b_VlH_We, k0b_VlH_Wmu, k0b_VlH_Ztautau,
+                          k0b_VlH_Zmumu, k0b_VlH_Zee, k0b_VlH_Leftovers, kPreselection_Fail, kNCategories };
+
         LotsOfCategoriesRun2(); 
         //LotsOfCategoriesRun2(); 
 
@@ -379,6 +505,11 @@ class CategorySelectionFEWZ : public Categorizer
 // Categories to compare DY, Data, and DY-FEWZ
 
     public:
+        // category ids, in the order initCategoryMap adds them
+        enum CategoryId { kWide, kNarrow, kCentral_Central, kCentral_Not_Central, k1Jet,
+                          kCentral_Central_Wide, kCentral_Not_Central_Wide, k1Jet_Wide,
+                          kCentral_Central_Narrow, kCentral_Not_Central_Narrow, k1Jet_Narrow, kNCategories };
+
         CategorySelectionFEWZ(); 
         CategorySelectionFEWZ(bool useRecoMu, bool useRecoJets); 
         CategorySelectionFEWZ(bool useReco, bool useRecoJets, float massSplit, float etaCentralSplit, float jetPtMin, float jetEtaMax); 
@@ -89,6 +89,32 @@ bool Run2EventSelectionCuts::evaluate(VarSet& vars)
 //-----------------------------------------------------------------------------
 ///////////////////////////////////////////////////////////////////////////////
 
+void Run2EventSelectionCuts::evaluate(DimuonBatch& batch)
+{
+// same cuts as evaluate(vars) for every candidate in the batch,
+// no early exits so the loop vectorizes
+    const unsigned char chargeOff = !cutset.cuts[0].on;
+    const unsigned char trigOff   = !cutset.cuts[1].on;
+    const unsigned char massOff   = !cutset.cuts[2].on;
+
+    const double trigMuPtMin = cTrigMuPtMin;
+    const double dimuMassMin = cDimuMassMin;
+
+    unsigned int n = batch.size();
+    for(unsigned int r=0; r<n; r++)
+    {
+        unsigned char passMass   = massOff   | (batch.mass[r] > dimuMassMin);
+        unsigned char passTrig   = trigOff   | (batch.mu1_trig[r] & (batch.mu1_pt[r] > trigMuPtMin))
+                                             | (batch.mu2_trig[r] & (batch.mu2_pt[r] > trigMuPtMin));
+        unsigned char passCharge = chargeOff | (batch.mu1_charge[r] != batch.mu2_charge[r]);
+        batch.pass[r] &= passMass & passTrig & passCharge;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
 TString Run2EventSelectionCuts::string()
 {
     return TString("Run2_Event_Selection");
@@ -11,6 +11,7 @@
 #define ADD_EVENTSELECTIONCUTS
 
 #include "Cut.h"
+#include "DimuonBatch.h"
 
 class Run2EventSelectionCuts : public Cut
 {
@@ -25,6 +26,7 @@ class Run2EventSelectionCuts : public Cut
 
         void makeCutSet();
         bool evaluate(VarSet& vars);
+        void evaluate(DimuonBatch& batch);   // AND the result for every candidate into batch.pass
         TString string();
 };
 
@@ -88,6 +88,35 @@ bool Run2MuonSelectionCuts::evaluate(VarSet& vars)
 //-----------------------------------------------------------------------------
 ///////////////////////////////////////////////////////////////////////////////
 
+void Run2MuonSelectionCuts::evaluate(DimuonBatch& batch)
+{
+// same cuts as evaluate(vars) for every candidate in the batch,
+// no early exits so the loop vectorizes
+    unsigned char off[6];
+    for(unsigned int c=0; c<6; c++)
+        off[c] = !cutset.cuts[c].on;
+
+    const double minPt = cMinPt;
+    const double maxEta = cMaxEta;
+    const double maxRelIso = cMaxRelIso;
+
+    unsigned int n = batch.size();
+    for(unsigned int r=0; r<n; r++)
+    {
+        unsigned char pass1 = (off[0] | (batch.mu1_pt[r] > minPt))
+                            & (off[1] | (TMath::Abs(batch.mu1_eta[r]) < maxEta))
+                            & (off[2] | (batch.mu1_iso[r] <= maxRelIso));
+        unsigned char pass2 = (off[3] | (batch.mu2_pt[r] > minPt))
+                            & (off[4] | (TMath::Abs(batch.mu2_eta[r]) < maxEta))
+                            & (off[5] | (batch.mu2_iso[r] <= maxRelIso));
+        batch.pass[r] &= pass1 & pass2;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
 TString Run2MuonSelectionCuts::string()
 {
     return TString("Run2_Muon_Selection_Cuts");
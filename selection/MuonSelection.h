@@ -12,6 +12,7 @@
 #define ADD_MUONSELECTIONCUTS
 
 #include "Cut.h"
+#include "DimuonBatch.h"
 
 class Run2MuonSelectionCuts : public Cut
 {
@@ -25,6 +26,7 @@ class Run2MuonSelectionCuts : public Cut
 
         void makeCutSet();
         bool evaluate(VarSet& vars);
+        void evaluate(DimuonBatch& batch);   // AND the result for every candidate into batch.pass
         TString string();
 };
 
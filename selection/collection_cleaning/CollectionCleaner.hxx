@@ -13,6 +13,7 @@
 
 #include "VarSet.h"
 #include "TLorentzVector.h"
+#include "PtEtaPhiM.h"
 #include "ParticleTools.h"
 #include <vector>
 #include <iostream>
@@ -22,53 +23,71 @@ class CollectionCleaner
     public:
         CollectionCleaner(){};
         ~CollectionCleaner(){};
+        static void cleanByDR(std::vector<PtEtaPhiM>& cleanThis, std::vector<PtEtaPhiM>& fromThis, float dRmin, bool print=false)
+        {
+        // remove items from cleanThis if they are too close in dR to any item in fromThis.
+        // eta and phi are stored, so there is no trig per pair, and the items that are kept
+        // are moved down in one pass instead of erasing from the middle of the vector
+            double dR2min = (double)dRmin*dRmin;
+            unsigned int nkeep = 0;
+            for(unsigned int j=0; j<cleanThis.size(); j++)
+            {
+                bool keep = true;
+                for(unsigned int i=0; i<fromThis.size(); i++)
+                {
+                    if(cleanThis[j].DeltaR2(fromThis[i]) < dR2min)
+                    {
+                        if(print) std::cout << Form("    Removing candidate > %s, dR: %7.3f\n", ParticleTools::output4vecInfo(cleanThis[j].get4vec()).Data(),
+                                                    cleanThis[j].DeltaR(fromThis[i]));
+                        keep = false;
+                        break;
+                    }
+                }
+                if(keep) cleanThis[nkeep++] = cleanThis[j];
+            }
+            cleanThis.resize(nkeep);
+        };
         static void cleanByDR(std::vector<TLorentzVector>& cleanThis, std::vector<TLorentzVector>& fromThis, float dRmin, bool print=false)
         {
         // remove items from cleanThis if they are too close in dR to any item in fromThis
-            for(unsigned int i=0; i<fromThis.size(); i++)
-            {   
-                if(print) std::cout << Form("Checking against > %s \n", ParticleTools::output4vecInfo(fromThis[i]).Data());
-                for(unsigned int j=0; j<cleanThis.size(); j++)
+            unsigned int nkeep = 0;
+            for(unsigned int j=0; j<cleanThis.size(); j++)
+            {
+                bool keep = true;
+                for(unsigned int i=0; i<fromThis.size(); i++)
                 {
-                    if(print) std::cout << Form("    Candidate > %s, dR: %7.3f\n", ParticleTools::output4vecInfo(cleanThis[j]).Data(), 
-                                          cleanThis[j].DeltaR(fromThis[i]));
-
-                    if(cleanThis[j].DeltaR(fromThis[i]) < dRmin) 
+                    if(cleanThis[j].DeltaR(fromThis[i]) < dRmin)
                     {
                         if(print) std::cout << Form("    Removing candidate > %s, dR: %7.3f\n", ParticleTools::output4vecInfo(cleanThis[j]).Data(),
                                                     cleanThis[j].DeltaR(fromThis[i]));
-
-                        // remove the item and make decrement j
-                        // since the next item will fall back into
-                        // the same index (j-- then j++ leaves j the same)
-                        cleanThis.erase(cleanThis.begin()+j); 
-                        j--;
+                        keep = false;
+                        break;
                     }
                 }
-            }   
-
+                if(keep) cleanThis[nkeep++] = cleanThis[j];
+            }
+            cleanThis.resize(nkeep);
         };
         template<class T, class U>
         static void cleanByDR(std::vector<T>& cleanThis, std::vector<U>& fromThis, float dRmin)
         {
         // remove items from cleanThis if they are too close in dR to any item in fromThis
-            for(unsigned int i=0; i<fromThis.size(); i++)
-            {   
-                TLorentzVector fromThis4vec = fromThis[i].get4vec();
-                for(unsigned int j=0; j<cleanThis.size(); j++)
+            unsigned int nkeep = 0;
+            for(unsigned int j=0; j<cleanThis.size(); j++)
+            {
+                TLorentzVector cleanThis4vec = cleanThis[j].get4vec();
+                bool keep = true;
+                for(unsigned int i=0; i<fromThis.size(); i++)
                 {
-                    TLorentzVector cleanThis4vec = cleanThis[j].get4vec();
-                    if(cleanThis4vec.DeltaR(fromThis4vec) < dRmin) 
+                    if(cleanThis4vec.DeltaR(fromThis[i].get4vec()) < dRmin)
                     {
-                        // remove the item and make decrement j
-                        // since the next item will fall back into
-                        // the same index (j-- then j++ leaves j the same)
-                        cleanThis.erase(cleanThis.begin()+j); 
-                        j--;
+                        keep = false;
+                        break;
                     }
                 }
-            }   
-
+                if(keep) cleanThis[nkeep++] = cleanThis[j];
+            }
+            cleanThis.erase(cleanThis.begin()+nkeep, cleanThis.end());
         };
 };
 
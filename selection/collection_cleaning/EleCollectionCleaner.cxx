@@ -44,7 +44,7 @@ EleCollectionCleaner::EleCollectionCleaner(float electronSelectionPtMin, float e
 //-----------------------------------------------------------------------------
 ///////////////////////////////////////////////////////////////////////////////
 
-void EleCollectionCleaner::getValidElectrons(VarSet& vars, std::vector<TLorentzVector>& electronvec)
+void EleCollectionCleaner::getValidElectrons(VarSet& vars, std::vector<PtEtaPhiM>& electronvec)
 {
     for(unsigned int j=0; j < vars.electrons->size(); ++j)
     {
@@ -76,6 +76,6 @@ void EleCollectionCleaner::getValidElectrons(VarSet& vars, std::vector<TLorentzV
             continue;
 
         // passes all selections, add to valid extra electrons
-        electronvec.push_back(vars.electrons->at(j).get4vec());
+        electronvec.push_back(PtEtaPhiM(vars.electrons->at(j).pt, vars.electrons->at(j).eta, vars.electrons->at(j).phi, vars.electrons->at(j).getMass()));
     }
 }
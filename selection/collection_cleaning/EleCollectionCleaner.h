@@ -24,7 +24,7 @@ class EleCollectionCleaner : public CollectionCleaner
         float cElectronSelectionIsoMax;
         int   cElectronSelectionID;
 
-        void getValidElectrons(VarSet& vars, std::vector<TLorentzVector>& evec);
+        void getValidElectrons(VarSet& vars, std::vector<PtEtaPhiM>& evec);
 };
 
 #endif
@@ -46,9 +46,10 @@ JetCollectionCleaner::JetCollectionCleaner(float jetSelectionPtMin, float jetSel
 //-----------------------------------------------------------------------------
 ///////////////////////////////////////////////////////////////////////////////
 
-void JetCollectionCleaner::getValidJets(VarSet& vars, std::vector<TLorentzVector>& jetvec, std::vector<TLorentzVector>& bjetvec, bool print)
+void JetCollectionCleaner::getValidJets(VarSet& vars, std::vector<PtEtaPhiM>& jetvec, std::vector<PtEtaPhiM>& bjetvec, bool print)
 {
 // Determine the number of valid jets using the given cuts
+    vars.kinematics.valid = false;   // the jet arrays get refilled from the new collections
     for(unsigned int j=0; j < vars.jets->size(); ++j)
     {
         if(print) std::cout << Form("Checking > %s\n", vars.jets->at(j).outputInfo().Data());
@@ -56,7 +57,8 @@ void JetCollectionCleaner::getValidJets(VarSet& vars, std::vector<TLorentzVector
         if(vars.jets->at(j).pt > cJetSelectionPtMin && TMath::Abs(vars.jets->at(j).eta) < cJetSelectionEtaMax)
         {
            if(print) std::cout << Form("Adding to jets > %s\n", vars.jets->at(j).outputInfo().Data());
-           TLorentzVector jet4vec = vars.jets->at(j).get4vec();
+           const SlimJetInfo& jet = vars.jets->at(j);
+           PtEtaPhiM jet4vec(jet.pt, jet.eta, jet.phi, jet.mass);
            jetvec.push_back(jet4vec);
 
            // further selections for a bjet, eta should be tighter since we need the tracker
@@ -73,22 +75,25 @@ void JetCollectionCleaner::getValidJets(VarSet& vars, std::vector<TLorentzVector
 //-----------------------------------------------------------------------------
 ///////////////////////////////////////////////////////////////////////////////
 
-void JetCollectionCleaner::getValidJets(VarSet& vars, std::vector<TLorentzVector>& jetvec, bool require_b)
+void JetCollectionCleaner::getValidJets(VarSet& vars, std::vector<PtEtaPhiM>& jetvec, bool require_b)
 {
 // Determine the number of valid jets using the given cuts
+    vars.kinematics.valid = false;   // the jet arrays get refilled from the new collections
     for(unsigned int j=0; j < vars.jets->size(); ++j)
     {
         // bjet selection
         if(require_b && vars.jets->at(j).pt > cJetSelectionPtMin && vars.jets->at(j).CSV > cJetSelectionBTagMin 
            && TMath::Abs(vars.jets->at(j).eta) < cJetSelectionBJetEtaMax)
         {
-           TLorentzVector jet4vec = vars.jets->at(j).get4vec();
+           const SlimJetInfo& jet = vars.jets->at(j);
+           PtEtaPhiM jet4vec(jet.pt, jet.eta, jet.phi, jet.mass);
            jetvec.push_back(jet4vec);
         }
         // regular jet selection
         if(!require_b && vars.jets->at(j).pt > cJetSelectionPtMin && TMath::Abs(vars.jets->at(j).eta) < cJetSelectionEtaMax)
         {
-           TLorentzVector jet4vec = vars.jets->at(j).get4vec();
+           const SlimJetInfo& jet = vars.jets->at(j);
+           PtEtaPhiM jet4vec(jet.pt, jet.eta, jet.phi, jet.mass);
            jetvec.push_back(jet4vec);
         }
     }
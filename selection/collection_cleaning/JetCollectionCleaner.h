@@ -25,8 +25,8 @@ class JetCollectionCleaner : public CollectionCleaner
         float cJetSelectionBTagMin;
         float cJetSelectionBJetEtaMax;
 
-        void getValidJets(VarSet& vars, std::vector<TLorentzVector>& jetvec, bool require_b = false);
-        void getValidJets(VarSet& vars, std::vector<TLorentzVector>& jetvec, std::vector<TLorentzVector>& bjetvec, bool print=false);
+        void getValidJets(VarSet& vars, std::vector<PtEtaPhiM>& jetvec, bool require_b = false);
+        void getValidJets(VarSet& vars, std::vector<PtEtaPhiM>& jetvec, std::vector<PtEtaPhiM>& bjetvec, bool print=false);
 
         bool jetID(VarSet& vars, unsigned int jet, int id);
 };
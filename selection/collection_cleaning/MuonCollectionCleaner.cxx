@@ -46,7 +46,7 @@ MuonCollectionCleaner::MuonCollectionCleaner(float muSelectionPtMin, float muSel
 //-----------------------------------------------------------------------------
 ///////////////////////////////////////////////////////////////////////////////
 
-void MuonCollectionCleaner::getValidMuons(VarSet& vars, std::vector<TLorentzVector>& muvec, bool exclude_pair)
+void MuonCollectionCleaner::getValidMuons(VarSet& vars, std::vector<PtEtaPhiM>& muvec, bool exclude_pair)
 {
     for(unsigned int j=0; j < vars.muons->size(); ++j)
     {
@@ -68,7 +68,7 @@ void MuonCollectionCleaner::getValidMuons(VarSet& vars, std::vector<TLorentzVect
             continue;
 
         // passes all selections, add to valid extra muons
-        muvec.push_back(vars.muons->at(j).get4vec());
+        muvec.push_back(PtEtaPhiM(vars.muons->at(j).pt, vars.muons->at(j).eta, vars.muons->at(j).phi, vars.muons->at(j).getMass()));
     }
 }
 
@@ -76,7 +76,7 @@ void MuonCollectionCleaner::getValidMuons(VarSet& vars, std::vector<TLorentzVect
 //-----------------------------------------------------------------------------
 ///////////////////////////////////////////////////////////////////////////////
 
-void MuonCollectionCleaner::getValidMuons(VarSet& vars, std::vector<TLorentzVector>& muvec, std::vector<TLorentzVector>& xmuvec)
+void MuonCollectionCleaner::getValidMuons(VarSet& vars, std::vector<PtEtaPhiM>& muvec, std::vector<PtEtaPhiM>& xmuvec)
 {
     for(unsigned int j=0; j < vars.muons->size(); ++j)
     {
@@ -97,7 +97,7 @@ void MuonCollectionCleaner::getValidMuons(VarSet& vars, std::vector<TLorentzVect
             continue;
 
         // passes all selections, add to valid muons, valid extra muons
-        muvec.push_back(vars.muons->at(j).get4vec());
-        if(j!=vars.dimuCand->iMu1 && j!=vars.dimuCand->iMu2) xmuvec.push_back(vars.muons->at(j).get4vec());
+        muvec.push_back(PtEtaPhiM(vars.muons->at(j).pt, vars.muons->at(j).eta, vars.muons->at(j).phi, vars.muons->at(j).getMass()));
+        if(j!=vars.dimuCand->iMu1 && j!=vars.dimuCand->iMu2) xmuvec.push_back(muvec.back());
     }
 }
@@ -25,8 +25,8 @@ class MuonCollectionCleaner : public CollectionCleaner
         int   cMuonSelectionID;
         bool  cUseMedium2016;
 
-        void getValidMuons(VarSet& vars, std::vector<TLorentzVector>& muvec, bool exclude_pair=false);
-        void getValidMuons(VarSet& vars, std::vector<TLorentzVector>& muvec, std::vector<TLorentzVector>& xmuvec);
+        void getValidMuons(VarSet& vars, std::vector<PtEtaPhiM>& muvec, bool exclude_pair=false);
+        void getValidMuons(VarSet& vars, std::vector<PtEtaPhiM>& muvec, std::vector<PtEtaPhiM>& xmuvec);
 };
 
 #endif
@@ -0,0 +1,268 @@
+#ifndef WORK_STEALING_THREAD_POOL_H
+#define WORK_STEALING_THREAD_POOL_H
+
+// Same interface as ThreadPool.hxx, but each worker has its own deque of tasks.
+// Tasks may carry a cost hint (e.g. the number of entries to process). Each deque
+// is kept sorted so that the most expensive task runs first, new tasks go to the
+// worker with the least queued cost, and a worker with nothing to do steals the
+// most expensive task from the worker with the most queued cost.
+// The pool keeps track of how long each worker was busy or idle so that we can
+// see the load imbalance at the end of a run.
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <stdexcept>
+#include <iostream>
+#include <cstdio>
+
+class WorkStealingThreadPool {
+public:
+    WorkStealingThreadPool(size_t);
+
+    // cost defaults to zero, these run after the tasks with a cost hint
+    template<class F, class... Args>
+    auto enqueue(F&& f, Args&&... args)
+        -> std::future<typename std::result_of<F(Args...)>::type>;
+
+    // larger cost -> runs earlier
+    template<class F, class... Args>
+    auto enqueueWithCost(double cost, F&& f, Args&&... args)
+        -> std::future<typename std::result_of<F(Args...)>::type>;
+
+    // busy/idle seconds, tasks run, and tasks stolen for each worker so far
+    struct WorkerStats { double busy; double idle; unsigned long ntasks; unsigned long nstolen; };
+    std::vector<WorkerStats> getStats();
+    void outputStats();
+
+    ~WorkStealingThreadPool();
+private:
+    struct Task {
+        double cost;
+        std::function<void()> run;
+    };
+
+    struct Worker {
+        std::deque<Task> tasks;           // sorted, most expensive first
+        std::mutex mutex;
+        double queuedCost = 0;
+        double busy = 0;
+        unsigned long ntasks = 0;
+        unsigned long nstolen = 0;
+    };
+
+    bool pop(size_t i, Task& task);       // take the front task from worker i
+    bool steal(size_t thief, Task& task); // take the front task from the worker with the most queued cost
+
+    std::vector< std::thread > workers;
+    std::vector< std::unique_ptr<Worker> > queues;
+
+    // synchronization
+    std::mutex wait_mutex;
+    std::condition_variable condition;
+    std::atomic<long> pending;
+    bool stop;
+
+    std::chrono::steady_clock::time_point start;
+};
+
+// the constructor just launches some amount of workers
+inline WorkStealingThreadPool::WorkStealingThreadPool(size_t threads)
+    :   pending(0), stop(false), start(std::chrono::steady_clock::now())
+{
+    if(threads < 1) threads = 1;
+    for(size_t i = 0;i<threads;++i)
+        queues.emplace_back(new Worker());
+
+    for(size_t i = 0;i<threads;++i)
+        workers.emplace_back(
+            [this, i]
+            {
+                for(;;)
+                {
+                    Task task;
+                    bool stolen = false;
+
+                    if(!this->pop(i, task))
+                    {
+                        stolen = this->steal(i, task);
+                        if(!stolen)
+                        {
+                            std::unique_lock<std::mutex> lock(this->wait_mutex);
+                            this->condition.wait(lock,
+                                [this]{ return this->stop || this->pending > 0; });
+                            if(this->stop && this->pending == 0)
+                                return;
+                            continue;
+                        }
+                    }
+
+                    auto t0 = std::chrono::steady_clock::now();
+                    task.run();
+                    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+
+                    std::unique_lock<std::mutex> lock(this->queues[i]->mutex);
+                    this->queues[i]->busy += dt.count();
+                    this->queues[i]->ntasks++;
+                    if(stolen) this->queues[i]->nstolen++;
+                }
+            }
+        );
+}
+
+inline bool WorkStealingThreadPool::pop(size_t i, Task& task)
+{
+    std::unique_lock<std::mutex> lock(queues[i]->mutex);
+    if(queues[i]->tasks.empty())
+        return false;
+    task = std::move(queues[i]->tasks.front());
+    queues[i]->tasks.pop_front();
+    queues[i]->queuedCost -= task.cost;
+    pending--;
+    return true;
+}
+
+inline bool WorkStealingThreadPool::steal(size_t thief, Task& task)
+{
+    // the queued costs may change while we look, that only makes the choice of victim a bit worse
+    size_t victim = thief;
+    double maxCost = -1;
+    for(size_t v = 0;v<queues.size();++v)
+    {
+        if(v == thief) continue;
+        std::unique_lock<std::mutex> lock(queues[v]->mutex);
+        if(!queues[v]->tasks.empty() && queues[v]->queuedCost > maxCost)
+        {
+            maxCost = queues[v]->queuedCost;
+            victim = v;
+        }
+    }
+    if(victim == thief)
+        return false;
+    return pop(victim, task);
+}
+
+// add new work item to the pool
+template<class F, class... Args>
+auto WorkStealingThreadPool::enqueue(F&& f, Args&&... args)
+    -> std::future<typename std::result_of<F(Args...)>::type>
+{
+    return enqueueWithCost(0, std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+template<class F, class... Args>
+auto WorkStealingThreadPool::enqueueWithCost(double cost, F&& f, Args&&... args)
+    -> std::future<typename std::result_of<F(Args...)>::type>
+{
+    using return_type = typename std::result_of<F(Args...)>::type;
+
+    auto task = std::make_shared< std::packaged_task<return_type()> >(
+            std::bind(std::forward<F>(f), std::forward<Args>(args)...)
+        );
+
+    std::future<return_type> res = task->get_future();
+
+    if(stop)
+        throw std::runtime_error("enqueue on stopped WorkStealingThreadPool");
+
+    // give the task to the worker with the least queued work
+    size_t target = 0;
+    double minCost = -1;
+    for(size_t i = 0;i<queues.size();++i)
+    {
+        std::unique_lock<std::mutex> lock(queues[i]->mutex);
+        if(minCost < 0 || queues[i]->queuedCost < minCost)
+        {
+            minCost = queues[i]->queuedCost;
+            target = i;
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(queues[target]->mutex);
+        std::deque<Task>& tasks = queues[target]->tasks;
+
+        // keep the deque sorted by cost, equal costs keep the order they were enqueued in
+        auto it = tasks.begin();
+        while(it != tasks.end() && it->cost >= cost) ++it;
+        Task t;
+        t.cost = cost;
+        t.run = [task](){ (*task)(); };
+        tasks.insert(it, std::move(t));
+        queues[target]->queuedCost += cost;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(wait_mutex);
+        pending++;
+    }
+    condition.notify_one();
+    return res;
+}
+
+inline std::vector<WorkStealingThreadPool::WorkerStats> WorkStealingThreadPool::getStats()
+{
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+    std::vector<WorkerStats> stats;
+    for(size_t i = 0;i<queues.size();++i)
+    {
+        std::unique_lock<std::mutex> lock(queues[i]->mutex);
+        WorkerStats s;
+        s.busy = queues[i]->busy;
+        s.idle = wall.count() - queues[i]->busy;
+        s.ntasks = queues[i]->ntasks;
+        s.nstolen = queues[i]->nstolen;
+        stats.push_back(s);
+    }
+    return stats;
+}
+
+inline void WorkStealingThreadPool::outputStats()
+{
+    std::vector<WorkerStats> stats = getStats();
+    double busy = 0;
+    double idle = 0;
+    double maxBusy = 0;
+
+    std::cout << std::endl;
+    std::cout << "======== Thread Pool Load Balance ========" << std::endl;
+    for(size_t i = 0;i<stats.size();++i)
+    {
+        char line[256];
+        snprintf(line, sizeof(line), "  worker %2lu: busy %9.2f s, idle %9.2f s, %4lu tasks, %4lu stolen",
+                 (unsigned long)i, stats[i].busy, stats[i].idle, stats[i].ntasks, stats[i].nstolen);
+        std::cout << line << std::endl;
+        busy += stats[i].busy;
+        idle += stats[i].idle;
+        if(stats[i].busy > maxBusy) maxBusy = stats[i].busy;
+    }
+    if(stats.size() > 0 && busy > 0)
+    {
+        char line[256];
+        snprintf(line, sizeof(line), "  utilization %.1f%%, max/mean busy %.2f",
+                 100*busy/(busy+idle), maxBusy/(busy/stats.size()));
+        std::cout << line << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+// the destructor joins all threads
+inline WorkStealingThreadPool::~WorkStealingThreadPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(wait_mutex);
+        stop = true;
+    }
+    condition.notify_all();
+    for(std::thread &worker: workers)
+        worker.join();
+}
+
+#endif
@@ -0,0 +1,235 @@
+///////////////////////////////////////////////////////////////////////////
+//                           DataframeWriter.cxx                         //
+//=======================================================================//
+//                                                                       //
+//  Stream the training dataframe for one chunk of a sample to disk.     //
+//  The columns are every VarSet feature plus a few extra ones like the  //
+//  weight, sorted by name, and resolved once when the writer is made.   //
+//  Each row goes to a csv and to a ColumnFile, both keep a bounded      //
+//  buffer and write it out when it fills up.                            //
+//                                                                       //
+///////////////////////////////////////////////////////////////////////////
+
+#include "DataframeWriter.h"
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+
+///////////////////////////////////////////////////////////////////////////
+// _______________________Constructor/Destructor_________________________//
+///////////////////////////////////////////////////////////////////////////
+
+DataframeWriter::DataframeWriter(TString csvname, TString colname, Sample* is, std::vector<TString> extraColumns,
+                                 bool writeHeader, unsigned int rowsPerGroup, unsigned int icsvBufferSize)
+{
+    s = is;
+    csvBufferSize = icsvBufferSize;
+
+    // same order as the std::map<TString, double> we used to keep the values in
+    for(auto& v: s->vars.varMap)  names.push_back(v.first.c_str());
+    for(auto& v: s->vars.varMapI) names.push_back(v.first.c_str());
+    for(auto& c: extraColumns)    names.push_back(c);
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    row.assign(names.size(), -999);
+
+    for(unsigned int i=0; i<names.size(); i++)
+    {
+        if(std::find(extraColumns.begin(), extraColumns.end(), names[i]) != extraColumns.end()) continue;
+        featureColumns.push_back(i);
+        featureHandles.push_back(s->vars.getFeature(names[i].Data()));
+    }
+
+    if(csvname != "")
+    {
+        csv = fopen(csvname.Data(), "w");
+        if(csv == 0) std::cout << Form("  !!! DataframeWriter could not open %s for writing \n", csvname.Data());
+        csvBuffer.reserve(csvBufferSize + 4096);
+        if(writeHeader) csvBuffer += (getHeader(",")+"\n").Data();
+    }
+
+    if(colname != "")
+    {
+        columns = new ColumnFileWriter(colname, rowsPerGroup);
+        for(auto& name: names)
+        {
+            isDouble.push_back(name == "weight");
+            columnIds.push_back(columns->addColumn(name, isDouble.back()?kColDouble:kColFloat));
+        }
+        columns->setMetadata("name", s->name);
+        columns->setMetadata("sampleType", s->sampleType);
+        columns->setMetadata("xsec", Form("%.10g", s->xsec));
+        columns->setMetadata("nOriginalWeighted", Form("%d", s->nOriginalWeighted));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+DataframeWriter::~DataframeWriter()
+{
+    if(!closed) close();
+    if(columns != 0) delete columns;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// _______________________Other Functions________________________________//
+///////////////////////////////////////////////////////////////////////////
+
+int DataframeWriter::getColumn(TString name)
+{
+    for(unsigned int i=0; i<names.size(); i++)
+        if(names[i] == name) return i;
+    return -1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+TString DataframeWriter::getHeader(TString sep)
+{
+    TString header = "";
+    for(unsigned int i=0; i<names.size(); i++)
+    {
+        if(i > 0) header += sep;
+        header += names[i];
+    }
+    return header;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void DataframeWriter::fill()
+{
+    for(unsigned int i=0; i<featureColumns.size(); i++)
+        row[featureColumns[i]] = featureHandles[i].get(s->vars);
+
+    if(csv != 0)
+    {
+        for(unsigned int i=0; i<row.size(); i++)
+        {
+            if(i > 0) csvBuffer += ',';
+            appendValue(csvBuffer, row[i]);
+        }
+        csvBuffer += '\n';
+        if(csvBuffer.size() >= csvBufferSize) flushCSV();
+    }
+
+    if(columns != 0)
+    {
+        for(unsigned int i=0; i<row.size(); i++)
+        {
+            if(isDouble[i]) columns->setDouble(columnIds[i], row[i]);
+            else columns->setFloat(columnIds[i], row[i]);
+        }
+        columns->fillRow();
+    }
+    nRows++;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void DataframeWriter::flushCSV()
+{
+    if(csv != 0 && !csvBuffer.empty()) fwrite(csvBuffer.data(), 1, csvBuffer.size(), csv);
+    csvBuffer.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+bool DataframeWriter::close()
+{
+    if(closed) return true;
+    closed = true;
+
+    bool ok = true;
+    if(csv != 0)
+    {
+        flushCSV();
+        ok = (fclose(csv) == 0) && ok;
+        csv = 0;
+    }
+    if(columns != 0) ok = columns->close() && ok;
+    return ok;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+void DataframeWriter::appendValue(std::string& out, double value)
+{
+// Integers like -999, the bin, or the number of jets are written digit by digit. Other values
+// in [1e-4, 1e6) are rounded to 6 significant digits with one multiplication. The rest, and the
+// values that land too close to a rounding tie to trust the multiplication, go through snprintf.
+    char digits[32];
+
+    if(value == 0)
+    {
+        out += std::signbit(value)?"-0":"0";
+        return;
+    }
+
+    double a = std::fabs(value);
+    if(a < 1e6 && a == std::floor(a))
+    {
+        long long n = (long long)a;
+        int len = 0;
+        while(n > 0) { digits[len++] = '0' + n%10; n /= 10; }
+        if(value < 0) out += '-';
+        while(len > 0) out += digits[--len];
+        return;
+    }
+
+    static const double powers[] = {1e-4, 1e-3, 1e-2, 1e-1, 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+    if(a >= 1e-4 && a < 1e6)
+    {
+        // a = d.ddddd x 10^e, scaled has the 6 significant digits in front of the decimal point
+        int e = 5;
+        while(e > -4 && a < powers[e+4]) e--;
+        double scaled = a*powers[9-e];
+        bool tie = std::fabs(scaled - std::floor(scaled) - 0.5) < 1e-6;
+        if(scaled < 99999.5 && e > -4)  { e--; scaled = a*powers[9-e]; }
+        if(scaled >= 999999.5 && e < 5) { e++; scaled = a*powers[9-e]; }
+
+        tie = tie || std::fabs(scaled - std::floor(scaled) - 0.5) < 1e-6;
+        if(scaled >= 99999.5 && scaled < 999999.5 && !tie)
+        {
+            long long n = (long long)(scaled + 0.5);
+            for(int d=5; d>=0; d--) { digits[d] = '0' + n%10; n /= 10; }
+
+            // drop the trailing zeros after the decimal point like %g
+            int last = 5;
+            while(last > e && last > 0 && digits[last] == '0') last--;
+
+            if(value < 0) out += '-';
+            if(e < 0)
+            {
+                out += "0.";
+                for(int z=0; z<-e-1; z++) out += '0';
+                for(int d=0; d<=last; d++) out += digits[d];
+            }
+            else
+            {
+                for(int d=0; d<=e; d++) out += digits[d];
+                if(last > e)
+                {
+                    out += '.';
+                    for(int d=e+1; d<=last; d++) out += digits[d];
+                }
+            }
+            return;
+        }
+    }
+
+    snprintf(digits, sizeof(digits), "%g", value);
+    out += digits;
+}
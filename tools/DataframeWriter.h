@@ -0,0 +1,72 @@
+///////////////////////////////////////////////////////////////////////////
+//                           DataframeWriter.h                           //
+//=======================================================================//
+//                                                                       //
+//  Stream the training dataframe for one chunk of a sample to disk.     //
+//  The columns are every VarSet feature plus a few extra ones like the  //
+//  weight, sorted by name, and resolved once when the writer is made.   //
+//  Each row goes to a csv and to a ColumnFile, both keep a bounded      //
+//  buffer and write it out when it fills up.                            //
+//                                                                       //
+///////////////////////////////////////////////////////////////////////////
+
+#ifndef DATAFRAMEWRITER
+#define DATAFRAMEWRITER
+
+#include <vector>
+#include <string>
+#include <cstdio>
+
+#include "TString.h"
+#include "Sample.h"
+#include "ColumnFile.h"
+
+class DataframeWriter
+{
+    public:
+        // csvname or colname = "" skips that output. The header line only goes into the csv if writeHeader is set,
+        // so that the csv chunks of a sample can be glued together
+        DataframeWriter(TString csvname, TString colname, Sample* s, std::vector<TString> extraColumns,
+                        bool writeHeader = true, unsigned int rowsPerGroup = 16384, unsigned int csvBufferSize = 1<<20);
+        ~DataframeWriter();
+
+        // index of a column for set, -1 if there is no such column
+        int getColumn(TString name);
+
+        // the value of an extra column for the current row, the features are read from s->vars by fill
+        void set(int icol, double value) { row[icol] = value; };
+
+        // write the current row
+        void fill();
+        bool close();
+
+        const std::vector<TString>& getColumnNames() { return names; };
+        const std::vector<double>& getRow()          { return row; };
+        unsigned long long nRows = 0;
+
+        // the names separated by sep, e.g. ":" for a TNtuple
+        TString getHeader(TString sep = ",");
+
+        // same text as std::ostream << value with the default precision, i.e. %g with 6 significant digits,
+        // without the stream or printf for the usual values
+        static void appendValue(std::string& out, double value);
+
+    protected:
+        Sample* s;
+        std::vector<TString> names;
+        std::vector<double> row;
+
+        std::vector<int> featureColumns;
+        std::vector<FeatureHandle> featureHandles;
+
+        FILE* csv = 0;
+        std::string csvBuffer;
+        unsigned int csvBufferSize;
+        void flushCSV();
+
+        ColumnFileWriter* columns = 0;
+        std::vector<int> columnIds;
+        std::vector<bool> isDouble;                 // the weight is a double in the ColumnFile, the rest are floats
+        bool closed = false;
+};
+#endif
@@ -54,6 +54,20 @@ void EventTools::loadEventsFromFile(TString filename, std::vector<std::pair<int,
 //---------------------------------------------------------------
 //////////////////////////////////////////////////////////////////
 
+void EventTools::loadEventsFromFile(TString filename, EventSet& events)
+{
+// same csv as above, straight into a set so that we can look the events up quickly
+    std::vector<std::pair<int, long long int>> v;
+    loadEventsFromFile(filename, v);
+    events.reserve(events.size() + v.size());
+    for(auto& e: v)
+        events.insert(e);
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
 void EventTools::outputEventsToFile(std::vector< std::pair<int,long long int> >& v, TString filename)
 {
 // used for the synchronization exercise
@@ -72,6 +86,22 @@ void EventTools::outputEventsToFile(std::vector< std::pair<int,long long int> >&
 //---------------------------------------------------------------
 //////////////////////////////////////////////////////////////////
 
+void EventTools::outputEventsToFile(const EventSet& events, TString filename)
+{
+// same format as above, in the order the events were added to the set
+    std::cout << "Exporting events to " << filename << " ..." << std::endl;
+    std::ofstream file(filename, std::ofstream::out);
+    for(auto const &e : events.getEvents())
+    {   
+        file << e.run << ", " << e.event << std::endl;
+    }   
+    file.close();  
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
 TString EventTools::outputMapKeysCSV(std::map<TString,double>& map)
 {
 // Given a map output the keys to a csv string, used to output the variable names
@@ -120,9 +150,9 @@ bool EventTools::sameRunAndEvent(std::pair<int,long long int> a, std::pair<int,l
 //---------------------------------------------------------------
 //////////////////////////////////////////////////////////////////
 
-bool EventTools::eventInVector(std::pair<int,long long int> e, std::vector<std::pair<int,long long int>> events)
+bool EventTools::eventInVector(std::pair<int,long long int> e, const std::vector<std::pair<int,long long int>>& events)
 {
-// see if the same run, event number is in the vector 
+// see if the same run, event number is in the vector, use an EventSet to check a lot of events
     for(unsigned int i=0; i<events.size(); i++)
     {
         if(sameRunAndEvent(e, events[i])) return true;
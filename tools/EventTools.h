@@ -29,11 +29,13 @@ class EventTools
         ~EventTools(){};
 
         static void loadEventsFromFile(TString filename, std::vector<std::pair<int, long long int>>& v);
+        static void loadEventsFromFile(TString filename, EventSet& events);
         static void outputEventsToFile(std::vector<std::pair<int,long long int>>& v, TString filename);
+        static void outputEventsToFile(const EventSet& events, TString filename);
         static TString outputMapKeysCSV(std::map<TString,double>& map);
         static TString outputMapValuesCSV(std::map<TString,double>& map);
         static bool sameRunAndEvent(std::pair<int,long long int> a, std::pair<int,long long int> b);
-        static bool eventInVector(std::pair<int,long long int> e, std::vector<std::pair<int,long long int>> events);
+        static bool eventInVector(std::pair<int,long long int> e, const std::vector<std::pair<int,long long int>>& events);
         static void outputEvent(VarSet& vars);
         static void outputEvent(VarSet& vars, std::map<TString, Float_t>& tmap);
         static void outputEvent(VarSet& vars, Categorizer& categorizer);
@@ -20,7 +20,7 @@ class ParticleTools
         ParticleTools(){};
         ~ParticleTools(){};
 
-        static TString output4vecInfo(TLorentzVector& v);
+        static TString output4vecInfo(const TLorentzVector& v);
         static TLorentzVector getMotherPtEtaPhiM(float pt0, float eta0, float phi0, float m0, float pt1, float eta1, float phi1, float m1);
         static bool isValid4Vec(TLorentzVector& v);
         static float dR(float eta1, float phi1, float eta2, float phi2);
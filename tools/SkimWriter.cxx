@@ -0,0 +1,98 @@
+///////////////////////////////////////////////////////////////////////////
+//                           SkimWriter.cxx                              //
+//=======================================================================//
+//                                                                       //
+//  Save the events that pass the selection to a columnar ColumnFile.    //
+//  There is a row for each selected dimuon candidate with every VarSet //
+//  feature, the event weight, run/lumi/event, and one byte per category //
+//  saying whether the candidate is in it.                               //
+//  Re-plotting a variable then only needs to read a few columns.        //
+//                                                                       //
+///////////////////////////////////////////////////////////////////////////
+
+#include "SkimWriter.h"
+#include <algorithm>
+
+///////////////////////////////////////////////////////////////////////////
+// _______________________Constructor/Destructor_________________________//
+///////////////////////////////////////////////////////////////////////////
+
+SkimWriter::SkimWriter(TString filename, Sample* is, Categorizer* icategorizer) : writer(filename)
+{
+    s = is;
+    categorizer = icategorizer;
+
+    // sort the feature names so that the column order is the same for every sample
+    for(auto& v: s->vars.varMap)  features.push_back(v.first);
+    for(auto& v: s->vars.varMapI) features.push_back(v.first);
+    std::sort(features.begin(), features.end());
+
+    for(auto& f: features)
+    {
+        featureColumns.push_back(writer.addColumn(f.c_str(), kColFloat));
+        featureHandles.push_back(s->vars.getFeature(f));
+    }
+
+    iweight = writer.addColumn("weight", kColDouble);
+    irun    = writer.addColumn("run", kColLong);
+    ilumi   = writer.addColumn("lumi", kColLong);
+    ievent  = writer.addColumn("event", kColLong);
+
+    for(auto& c: categorizer->categoryMap)
+    {
+        if(c.second.hide) continue;
+        categories.push_back(&c.second);
+        categoryColumns.push_back(writer.addColumn("cat_"+c.first, kColByte));
+    }
+
+    // need these to normalize the histograms without opening the sample again
+    writer.setMetadata("name", s->name);
+    writer.setMetadata("sampleType", s->sampleType);
+    writer.setMetadata("xsec", Form("%.10g", s->xsec));
+    writer.setMetadata("nOriginal", Form("%d", s->nOriginal));
+    writer.setMetadata("nOriginalWeighted", Form("%d", s->nOriginalWeighted));
+    writer.setMetadata("N", Form("%d", s->N));
+}
+
+///////////////////////////////////////////////////////////////////////////
+// _______________________Other Functions________________________________//
+///////////////////////////////////////////////////////////////////////////
+
+void SkimWriter::fill(double weight)
+{
+    for(unsigned int i=0; i<features.size(); i++)
+        writer.setFloat(featureColumns[i], featureHandles[i].get(s->vars));
+
+    writer.setDouble(iweight, weight);
+    writer.setLong(irun, s->vars.eventInfo->run);
+    writer.setLong(ilumi, s->vars.eventInfo->lumi);
+    writer.setLong(ievent, s->vars.eventInfo->event);
+
+    for(unsigned int i=0; i<categories.size(); i++)
+        writer.setByte(categoryColumns[i], categories[i]->inCategory);
+
+    writer.fillRow();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+bool SkimWriter::close()
+{
+    return writer.close();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////
+
+TString SkimWriter::getFilename(TString dir, TString sampleName, TString calibration, TString categories, 
+                                int subleadPt, TString systematic, int chunk)
+{
+    TString filename = Form("%s/%s_%s_categories%s_minpt%d", dir.Data(), sampleName.Data(), calibration.Data(), 
+                            categories.Data(), subleadPt);
+    if(systematic != "") filename += "_"+systematic;
+    if(chunk >= 0) filename += Form("_chunk%d", chunk);
+    return filename+".col";
+}
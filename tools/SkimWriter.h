@@ -0,0 +1,56 @@
+///////////////////////////////////////////////////////////////////////////
+//                           SkimWriter.h                                //
+//=======================================================================//
+//                                                                       //
+//  Save the events that pass the selection to a columnar ColumnFile.    //
+//  There is a row for each selected dimuon candidate with every VarSet //
+//  feature, the event weight, run/lumi/event, and one byte per category //
+//  saying whether the candidate is in it.                               //
+//  Re-plotting a variable then only needs to read a few columns.        //
+//                                                                       //
+///////////////////////////////////////////////////////////////////////////
+
+#ifndef SKIMWRITER
+#define SKIMWRITER
+
+#include <vector>
+#include <string>
+
+#include "TString.h"
+#include "Sample.h"
+#include "CategorySelection.h"
+#include "ColumnFile.h"
+
+class SkimWriter
+{
+    public: 
+        // set up the schema from the sample's VarSet features and the categories in the categorizer
+        SkimWriter(TString filename, Sample* s, Categorizer* categorizer);
+        ~SkimWriter(){};
+
+        ColumnFileWriter writer;
+
+        // write the candidate currently loaded into s->vars along with the categorizer results
+        void fill(double weight);
+        bool close();
+
+        // skims/{sample}_{calibration}_categories{categories}_minpt{subleadPt}[_{systematic}][_chunk{chunk}].col
+        static TString getFilename(TString dir, TString sampleName, TString calibration, TString categories, 
+                                   int subleadPt, TString systematic="", int chunk=-1);
+
+    protected:
+        Sample* s;
+        Categorizer* categorizer;
+
+        std::vector<std::string> features;
+        std::vector<int> featureColumns;
+        std::vector<FeatureHandle> featureHandles;  // resolved once from the feature names
+        std::vector<Category*> categories;
+        std::vector<int> categoryColumns;
+
+        int iweight;
+        int irun;
+        int ilumi;
+        int ievent;
+};
+#endif
@@ -8,6 +8,9 @@
 
 #include "TMVATools.h"
 
+#include <chrono>
+#include <cstring>
+
 //////////////////////////////////////////////////////////////////
 //---------------------------------------------------------------
 //////////////////////////////////////////////////////////////////
@@ -148,6 +151,21 @@ TMVA::Reader* TMVATools::bookVars(TString methodName, TString weightfile, std::m
 //---------------------------------------------------------------
 //////////////////////////////////////////////////////////////////
 
+BranchSet::Mask TMVATools::getBranchMask(TString weightfile, VarSet& varset)
+{
+// The branches needed to compute the training variables for this classification model.
+// The spectators are booked but never filled, so they don't need anything.
+
+    std::vector<TString> tvars;
+    std::vector<TString> svars;
+    getVarNames(weightfile, tvars, svars);
+    return varset.getBranchMask(tvars);
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
 float TMVATools::getClassifierScore(TMVA::Reader* reader, TString methodName, std::map<TString, Float_t>& tmap, VarSet& varset)
 {
 // assuming that the reader has been initialized with the tmva weight file
@@ -184,3 +202,202 @@ std::vector<float> TMVATools::getMulticlassScores(TMVA::Reader* reader, TString
       return reader->EvaluateMulticlass(methodName);
 }
 
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+std::vector<FeatureHandle> TMVATools::getFeatures(std::map<TString, Float_t>& tmap, VarSet& varset)
+{
+// one feature per training variable, in the same order as tmap
+
+      std::vector<FeatureHandle> features;
+      for(auto& v: tmap)
+          features.push_back(varset.getFeature(v.first.Data()));
+      return features;
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+float TMVATools::getClassifierScore(TMVA::Reader* reader, const TString& methodName, std::map<TString, Float_t>& tmap, 
+                                    const std::vector<FeatureHandle>& features, VarSet& varset)
+{
+// same as above, but with the features resolved beforehand by getFeatures(tmap, varset)
+
+      unsigned int i = 0;
+      for(auto& v: tmap)
+          v.second = features[i++].get(varset);
+
+      return reader->EvaluateMVA(methodName);
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+std::vector<float> TMVATools::getMulticlassScores(TMVA::Reader* reader, const TString& methodName, std::map<TString, Float_t>& tmap, 
+                                                  const std::vector<FeatureHandle>& features, VarSet& varset)
+{
+// same as above, but with the features resolved beforehand by getFeatures(tmap, varset)
+
+      unsigned int i = 0;
+      for(auto& v: tmap)
+          v.second = features[i++].get(varset);
+
+      return reader->EvaluateMulticlass(methodName);
+}
+
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+TMVAEvaluator::TMVAEvaluator(TString methodName, TString weightfile, VarSet& varset, unsigned int batchSize)
+{
+// Book the reader with the inputs bound to one array, in the same order as the weightfile
+
+    this->methodName = methodName;
+    this->weightfile = weightfile;
+    this->batchSize = (batchSize > 0) ? batchSize : 1;
+    timing.methodName = methodName;
+
+    std::vector<TString> svars;
+    TMVATools::getVarNames(weightfile, tvars, svars);
+
+    // size the arrays before handing out addresses, they must not move afterwards
+    inputs.assign(tvars.size(), -999);
+    spectators.assign(svars.size(), -999);
+
+    reader = new TMVA::Reader("!Color:!Silent");
+    for(unsigned int j=0; j<tvars.size(); j++)
+    {
+        reader->AddVariable(tvars[j], &inputs[j]);
+        features.push_back(varset.getFeature(tvars[j].Data()));
+    }
+    for(unsigned int j=0; j<svars.size(); j++)
+        reader->AddSpectator(svars[j], &spectators[j]);
+
+    method = dynamic_cast<TMVA::MethodBase*>(reader->BookMVA(methodName, weightfile));
+    if(method == 0)
+    {
+        std::cout << Form("  !!! TMVAEvaluator could not book %s from %s \n", methodName.Data(), weightfile.Data());
+        return;
+    }
+
+    isMulticlass = (method->GetAnalysisType() == TMVA::Types::kMulticlass);
+    if(isMulticlass)
+    {
+        std::vector<TString> classes;
+        TMVATools::getClassNames(weightfile, classes);
+        nscores = classes.size();
+    }
+
+    batchInputs.resize(this->batchSize*inputs.size());
+    batchScores.resize(this->batchSize*nscores);
+    multiclassScores.resize(nscores);
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+TMVAEvaluator::~TMVAEvaluator()
+{
+    delete reader;
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+void TMVAEvaluator::fillInputs(VarSet& varset, Float_t* x)
+{
+    for(unsigned int j=0; j<features.size(); j++)
+        x[j] = features[j].get(varset);
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+void TMVAEvaluator::evaluateInputs(float* scores)
+{
+// the reader reads the bound inputs array, multiclass methods give one score per class
+
+    if(!isMulticlass)
+    {
+        scores[0] = reader->EvaluateMVA(method);
+        return;
+    }
+
+    const std::vector<Float_t>& results = reader->EvaluateMulticlass(method);
+    for(unsigned int c=0; c<nscores && c<results.size(); c++)
+        scores[c] = results[c];
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+float TMVAEvaluator::getClassifierScore(VarSet& varset)
+{
+    auto t0 = std::chrono::steady_clock::now();
+
+    fillInputs(varset, &inputs[0]);
+    evaluateInputs(&multiclassScores[0]);
+
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+    timing.seconds += dt.count();
+    timing.nevents++;
+    return multiclassScores[0];
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+const std::vector<float>& TMVAEvaluator::getMulticlassScores(VarSet& varset)
+{
+    getClassifierScore(varset);
+    return multiclassScores;
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+unsigned int TMVAEvaluator::addToBatch(VarSet& varset)
+{
+    if(batchFull())
+    {
+        std::cout << Form("  !!! TMVAEvaluator batch for %s is full, evaluate it first \n", methodName.Data());
+        return nbatch-1;
+    }
+
+    fillInputs(varset, &batchInputs[nbatch*inputs.size()]);
+    return nbatch++;
+}
+
+//////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------
+//////////////////////////////////////////////////////////////////
+
+void TMVAEvaluator::evaluateBatch()
+{
+// The reader only knows about the bound inputs, so each row is copied there in turn.
+// The features were already read while the events were collected, so this is a tight loop.
+
+    auto t0 = std::chrono::steady_clock::now();
+
+    unsigned int nvars = inputs.size();
+    for(unsigned int row=0; row<nbatch; row++)
+    {
+        if(nvars > 0) std::memcpy(&inputs[0], &batchInputs[row*nvars], nvars*sizeof(Float_t));
+        evaluateInputs(&batchScores[row*nscores]);
+    }
+
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+    timing.seconds += dt.count();
+    timing.nevents += nbatch;
+}
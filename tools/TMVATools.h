@@ -15,6 +15,7 @@
 
 #include "TXMLEngine.h"
 #include "TMVA/Reader.h"
+#include "TMVA/MethodBase.h"
 #include "TString.h"
 #include "VarSet.h"
 
@@ -29,8 +30,98 @@ class TMVATools
         static void getVarNames(TString filename, std::vector<TString>& tvars, std::vector<TString>& svars);
         static void getClassNames(TString filename, std::vector<TString>& classes);
         
+        static BranchSet::Mask getBranchMask(TString weightfile, VarSet& varset);
+
         static TMVA::Reader* bookVars(TString methodName, TString weightfile, std::map<TString, Float_t>& tmap, std::map<TString, Float_t>& smap);
         static float getClassifierScore(TMVA::Reader* reader, TString methodName, std::map<TString, Float_t>& tmap, VarSet& varset);
         static std::vector<float> getMulticlassScores(TMVA::Reader* reader, TString methodName, std::map<TString, Float_t>& tmap, VarSet& varset);
+
+        // resolve the training variables in tmap once, then use the features for every event
+        static std::vector<FeatureHandle> getFeatures(std::map<TString, Float_t>& tmap, VarSet& varset);
+        static float getClassifierScore(TMVA::Reader* reader, const TString& methodName, std::map<TString, Float_t>& tmap, 
+                                        const std::vector<FeatureHandle>& features, VarSet& varset);
+        static std::vector<float> getMulticlassScores(TMVA::Reader* reader, const TString& methodName, std::map<TString, Float_t>& tmap, 
+                                                      const std::vector<FeatureHandle>& features, VarSet& varset);
+};
+
+//////////////////////////////////////////////////////////////////////////
+//// ______________________TMVATiming___________________________________//
+//////////////////////////////////////////////////////////////////////////
+
+// events scored and time spent in the classifier for one method,
+// add them up over the evaluators of several threads
+struct TMVATiming
+{
+    TString methodName;
+    long long nevents = 0;
+    double seconds = 0;
+
+    void add(const TMVATiming& other)
+    {
+        if(methodName == "") methodName = other.methodName;
+        nevents += other.nevents;
+        seconds += other.seconds;
+    };
+
+    void output() const
+    {
+        std::cout << Form("  /// %s: %lld events in %.2f s, %.0f events/s \n", methodName.Data(), nevents, seconds, 
+                          (seconds > 0) ? nevents/seconds : 0.0);
+    };
+};
+
+//////////////////////////////////////////////////////////////////////////
+//// ______________________TMVAEvaluator________________________________//
+//////////////////////////////////////////////////////////////////////////
+
+// Books one classifier with its training variables bound to a contiguous float array
+// in the order of the weightfile. The features are resolved once, so filling the inputs
+// doesn't touch any maps, and the booked method is looked up once instead of by name every event.
+// Events can be scored one at a time or collected with addToBatch() and scored together
+// with evaluateBatch().
+class TMVAEvaluator
+{
+    public:
+        TMVAEvaluator(TString methodName, TString weightfile, VarSet& varset, unsigned int batchSize = 256);
+        ~TMVAEvaluator();
+
+        TString methodName;
+        TString weightfile;
+        TMVA::Reader* reader = 0;
+        TMVA::MethodBase* method = 0;
+        bool isMulticlass = false;
+
+        std::vector<TString> tvars;            // training variables in weightfile order
+        std::vector<FeatureHandle> features;   // one per training variable
+        std::vector<Float_t> inputs;           // bound to the reader, one per training variable
+        std::vector<Float_t> spectators;       // booked but never filled
+
+        TMVATiming timing;
+
+        // fill the inputs from the varset and score the event
+        float getClassifierScore(VarSet& varset);
+        const std::vector<float>& getMulticlassScores(VarSet& varset);
+
+        // batches, nvars floats per event in batchInputs and nscores floats per event in batchScores
+        unsigned int batchSize;
+        unsigned int nbatch = 0;
+        unsigned int nscores = 1;
+        std::vector<Float_t> batchInputs;
+        std::vector<float> batchScores;
+
+        // copy the event's inputs into the batch, returns its row, check batchFull() before adding more
+        unsigned int addToBatch(VarSet& varset);
+        bool batchFull() const { return nbatch >= batchSize; };
+        void evaluateBatch();
+        void clearBatch() { nbatch = 0; };
+
+        // the score or the multiclass scores for a row of the last evaluated batch
+        float getBatchScore(unsigned int row) const { return batchScores[row*nscores]; };
+        const float* getBatchScores(unsigned int row) const { return &batchScores[row*nscores]; };
+
+    private:
+        std::vector<float> multiclassScores;
+        void fillInputs(VarSet& varset, Float_t* x);
+        void evaluateInputs(float* scores);
 };
 #endif